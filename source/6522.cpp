@@ -108,7 +108,7 @@ USHORT SY6522::SetTimerSyncEvent(BYTE reg, USHORT timerLatch)
 	const UINT opcodeCycleAdjust = GetOpcodeCyclesForWrite(reg);
 
 	if (syncEvent->m_active)
-		g_SynchronousEventMgr.Remove(syncEvent->m_id);
+		GetSynchronousEventMgr().Remove(syncEvent->m_id);
 
 	if (m_isMegaAudio)
 	{
@@ -120,7 +120,7 @@ USHORT SY6522::SetTimerSyncEvent(BYTE reg, USHORT timerLatch)
 	{
 		syncEvent->SetCycles(timerLatch + kExtraTimerCycles + opcodeCycleAdjust);
 	}
-	g_SynchronousEventMgr.Insert(syncEvent);
+	GetSynchronousEventMgr().Insert(syncEvent);
 
 	// It doesn't matter if this overflows (ie. >0xFFFF), since on completion of current opcode it'll be corrected
 	return (USHORT)(timerLatch + opcodeCycleAdjust);
@@ -418,8 +418,8 @@ UINT SY6522::GetOpcodeCyclesForRead(BYTE reg)
 	bool indx = false;
 	bool indy = false;
 
-	const BYTE opcodeMinus3 = mem[(::regs.pc - 3) & 0xffff];
-	const BYTE opcodeMinus2 = mem[(::regs.pc - 2) & 0xffff];
+	const BYTE opcodeMinus3 = *MemGetReadPtr((::regs.pc - 3) & 0xffff);
+	const BYTE opcodeMinus2 = *MemGetReadPtr((::regs.pc - 2) & 0xffff);
 
 	// Check 2-byte opcodes
 	if (((opcodeMinus2 & 0x0f) == 0x01) && ((opcodeMinus2 & 0x10) == 0x00))	// ora (zp,x), and (zp,x), ..., sbc (zp,x)
@@ -504,8 +504,8 @@ UINT SY6522::GetOpcodeCyclesForWrite(BYTE reg)
 	bool indx = false;
 	bool indy = false;
 
-	const BYTE opcodeMinus3 = mem[(::regs.pc - 3) & 0xffff];
-	const BYTE opcodeMinus2 = mem[(::regs.pc - 2) & 0xffff];
+	const BYTE opcodeMinus3 = *MemGetReadPtr((::regs.pc - 3) & 0xffff);
+	const BYTE opcodeMinus2 = *MemGetReadPtr((::regs.pc - 2) & 0xffff);
 
 	// Check 2-byte opcodes
 	if (opcodeMinus2 == 0x81)			// sta (zp,x)
@@ -577,15 +577,15 @@ UINT SY6522::GetOpcodeCycles(BYTE reg, UINT zpOpcodeCycles, UINT opcodeCycles,
 
 	if (zpOpcode)
 	{
-		BYTE zp = mem[(::regs.pc - 1) & 0xffff];
+		BYTE zp = *MemGetReadPtr((::regs.pc - 1) & 0xffff);
 		if (indx) zp += ::regs.x;
-		zpAddr16 = (mem[zp] | (mem[(zp + 1) & 0xff] << 8));
+		zpAddr16 = (*MemGetReadPtr(zp) | (*MemGetReadPtr((zp + 1) & 0xff) << 8));
 		if (indy) zpAddr16 += ::regs.y;
 	}
 
 	if (opcode)
 	{
-		addr16 = mem[(::regs.pc - 2) & 0xffff] | (mem[(::regs.pc - 1) & 0xffff] << 8);
+		addr16 = *MemGetReadPtr((::regs.pc - 2) & 0xffff) | (*MemGetReadPtr((::regs.pc - 1) & 0xffff) << 8);
 		if (abs16y) addr16 += ::regs.y;
 		if (abs16x) addr16 += ::regs.x;
 	}
@@ -719,13 +719,13 @@ void SY6522::SetTimersActiveFromSnapshot(bool timer1Active, bool timer2Active, U
 		SyncEvent* syncEvent = m_syncEvent[0];
 		syncEvent->SetCycles(GetRegT1C() + kExtraTimerCycles);	// NB. use COUNTER, not LATCH
 		syncEvent->m_canAssertIRQ = (m_regs.IER & IxR_TIMER1) ? true : false;
-		g_SynchronousEventMgr.Insert(syncEvent);
+		GetSynchronousEventMgr().Insert(syncEvent);
 	}
 	if (IsTimer2Active())
 	{
 		SyncEvent* syncEvent = m_syncEvent[1];
 		syncEvent->SetCycles(GetRegT2C() + kExtraTimerCycles);	// NB. use COUNTER, not LATCH
 		syncEvent->m_canAssertIRQ = (m_regs.IER & IxR_TIMER2) ? true : false;
-		g_SynchronousEventMgr.Insert(syncEvent);
+		GetSynchronousEventMgr().Insert(syncEvent);
 	}
 }
@@ -471,114 +471,76 @@ sound_write_buf_pstereo( libspectrum_signed_word * out, int c )
 #define HZ_COMMON_DENOMINATOR 50
 #include "Log.h"
 
-void AY8913::sound_ay_overlay( void )
+/* [TC] max. number of samples generated in one go by sound_ay_block() */
+#define AY_BLOCK_MAX	256
+
+// [AppleWin-TC] Apply a register change (fix things as needed)
+void AY8913::sound_ay_change_reg( int reg )
 {
-  int tone_level[3];
-  int mixer, envshape;
+  int r;
+
+  switch ( reg ) {
+  case 0:
+  case 1:
+  case 2:
+  case 3:
+  case 4:
+  case 5:
+    r = reg >> 1;
+    /* a zero-len period is the same as 1 */
+    ay_tone_period[r] = ( sound_ay_registers[ reg & ~1 ] |
+			  ( sound_ay_registers[ reg | 1 ] & 15 ) << 8 );
+    if( !ay_tone_period[r] )
+      ay_tone_period[r]++;
+
+    /* important to get this right, otherwise e.g. Ghouls 'n' Ghosts
+     * has really scratchy, horrible-sounding vibrato.
+     */
+    if( ay_tone_tick[r] >= ay_tone_period[r] * 2 )
+      ay_tone_tick[r] %= ay_tone_period[r] * 2;
+    break;
+  case 6:
+    ay_noise_tick = 0;
+    ay_noise_period = ( sound_ay_registers[ reg ] & 31 );
+    break;
+  case 11:
+  case 12:
+    /* this one *isn't* fixed-point */
+    ay_env_period =
+      sound_ay_registers[11] | ( sound_ay_registers[12] << 8 );
+    break;
+  case 13:
+    ay_env_internal_tick = ay_env_tick = ay_env_subcycles = 0;
+    env_first = 1;
+    env_rev = 0;
+    env_counter = ( sound_ay_registers[13] & AY_ENV_ATTACK ) ? 0 : 15;
+    break;
+  }
+}
+
+// [AppleWin-TC] Generate samples [ofs, ofs+num) - the registers don't change during this block.
+// Rather than doing everything per sample, this is done in passes:
+// . the counters shared by the 3 channels (envelope, noise & tone sub-cycles) are advanced for the whole block
+// . then each channel is generated with its (fixed) mixer & level settings hoisted out of the loop
+// NB. The output is identical to doing it all per sample.
+void AY8913::sound_ay_block( int ofs, int num )
+{
+  unsigned int tone_counts[ AY_BLOCK_MAX ];
+  unsigned char noise_toggles[ AY_BLOCK_MAX ];
+  int env_levels[ AY_BLOCK_MAX ];
   int f, g, level, count;
-//  libspectrum_signed_word *ptr;
-  struct ay_change_tag *change_ptr = ay_change;
-  int changes_left = ay_change_count;
-  int reg, r;
   int is_low;
-  int chan1, chan2, chan3;
   unsigned int tone_count, noise_count;
-  libspectrum_dword sfreq, cpufreq;
-
-///* If no AY chip, don't produce any AY sound (!) */
-//  if( !machine_current->capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_AY )
-//    return;
-
-/* convert change times to sample offsets, use common denominator of 50 to
-   avoid overflowing a dword */
-  sfreq = sound_generator_freq / HZ_COMMON_DENOMINATOR;
-//  cpufreq = machine_current->timings.processor_speed / HZ_COMMON_DENOMINATOR;
-  cpufreq = (libspectrum_dword) (m_fCurrentCLK_AY8910 / HZ_COMMON_DENOMINATOR);	// [TC]
-  int dbgCount=0;
-  for( f = 0; f < ay_change_count; f++ )
-  {
-    ay_change[f].ofs = (USHORT) (( ay_change[f].tstates * sfreq ) / cpufreq);	// [TC] Added cast
-
-	if (ay_change[f].ofs >= sound_generator_framesiz)	// [TC] Ensure that all ay_change's get processed
-	{
-		ay_change[f].ofs = sound_generator_framesiz-1;	// [TC] - as parent, sound_frame(), just dumps outstanding changes (ay_change_count=0)
-		dbgCount++;
-	}
-  }
-#if defined(_DEBUG) && 0
-  if (dbgCount)
-  {
-	  LogOutput("ay_change: saved %d\n", dbgCount);	// [TC] previously would've been dumped!
-  }
-#endif
-
-  libspectrum_signed_word* pBuf1 = ppSoundBuffers[0];
-  libspectrum_signed_word* pBuf2 = ppSoundBuffers[1];
-  libspectrum_signed_word* pBuf3 = ppSoundBuffers[2];
-
-//  for( f = 0, ptr = sound_buf; f < sound_generator_framesiz; f++ ) {
-  for( f = 0; f < sound_generator_framesiz; f++ ) {
-    /* update ay registers. All this sub-frame change stuff
-     * is pretty hairy, but how else would you handle the
-     * samples in Robocop? :-) It also clears up some other
-     * glitches.
-     */
-    while( changes_left && f >= change_ptr->ofs ) {
-      sound_ay_registers[ reg = change_ptr->reg ] = change_ptr->val;
-      change_ptr++;
-      changes_left--;
-
-      /* fix things as needed for some register changes */
-      switch ( reg ) {
-      case 0:
-      case 1:
-      case 2:
-      case 3:
-      case 4:
-      case 5:
-	r = reg >> 1;
-	/* a zero-len period is the same as 1 */
-	ay_tone_period[r] = ( sound_ay_registers[ reg & ~1 ] |
-			      ( sound_ay_registers[ reg | 1 ] & 15 ) << 8 );
-	if( !ay_tone_period[r] )
-	  ay_tone_period[r]++;
-
-	/* important to get this right, otherwise e.g. Ghouls 'n' Ghosts
-	 * has really scratchy, horrible-sounding vibrato.
-	 */
-	if( ay_tone_tick[r] >= ay_tone_period[r] * 2 )
-	  ay_tone_tick[r] %= ay_tone_period[r] * 2;
-	break;
-      case 6:
-	ay_noise_tick = 0;
-	ay_noise_period = ( sound_ay_registers[ reg ] & 31 );
-	break;
-      case 11:
-      case 12:
-	/* this one *isn't* fixed-point */
-	ay_env_period =
-	  sound_ay_registers[11] | ( sound_ay_registers[12] << 8 );
-	break;
-      case 13:
-	ay_env_internal_tick = ay_env_tick = ay_env_subcycles = 0;
-	env_first = 1;
-	env_rev = 0;
-	env_counter = ( sound_ay_registers[13] & AY_ENV_ATTACK ) ? 0 : 15;
-	break;
-      }
-    }
-
-    /* the tone level if no enveloping is being used */
-    for( g = 0; g < 3; g++ )
-      tone_level[g] = ay_tone_levels[ sound_ay_registers[ 8 + g ] & 15 ];
 
-    /* envelope */
-    envshape = sound_ay_registers[13];
-    level = ay_tone_levels[ env_counter ];
+  const int envshape = sound_ay_registers[13];
+  const int mixer = sound_ay_registers[7];
+  const bool env_used = ( ( sound_ay_registers[8] | sound_ay_registers[9] | sound_ay_registers[10] ) & 16 ) != 0;
 
-    for( g = 0; g < 3; g++ )
-      if( sound_ay_registers[ 8 + g ] & 16 )
-	tone_level[g] = level;
+  /* pass 1: envelope, tone sub-cycles & noise */
+  for( f = 0; f < num; f++ ) {
+    /* the envelope's level for this sample */
+    if( env_used )
+      env_levels[f] = ay_tone_levels[ env_counter ];
 
     /* envelope output counter gets incr'd every 16 AY cycles.
      * Has to be a while, as this is sub-output-sample res.
@@ -634,76 +596,12 @@ void AY8913::sound_ay_overlay( void )
       }
     }
 
-    /* generate tone+noise... or neither.
-     * (if no tone/noise is selected, the chip just shoves the
-     * level out unmodified. This is used by some sample-playing
-     * stuff.)
-     */
-    chan1 = tone_level[0];
-    chan2 = tone_level[1];
-    chan3 = tone_level[2];
-    mixer = sound_ay_registers[7];
-
     ay_tone_subcycles += ay_tick_incr;
-    tone_count = ay_tone_subcycles >> ( 3 + 16 );
+    tone_counts[f] = ay_tone_subcycles >> ( 3 + 16 );
     ay_tone_subcycles &= ( 8 << 16 ) - 1;
 
-    if( ( mixer & 1 ) == 0 ) {
-      level = chan1;
-      AY_DO_TONE( chan1, 0 );
-    }
-    if( ( mixer & 0x08 ) == 0 && noise_toggle )
-      chan1 = 0;
-
-    if( ( mixer & 2 ) == 0 ) {
-      level = chan2;
-      AY_DO_TONE( chan2, 1 );
-    }
-    if( ( mixer & 0x10 ) == 0 && noise_toggle )
-      chan2 = 0;
-
-    if( ( mixer & 4 ) == 0 ) {
-      level = chan3;
-      AY_DO_TONE( chan3, 2 );
-    }
-    if( ( mixer & 0x20 ) == 0 && noise_toggle )
-      chan3 = 0;
-
-    /* write the sample(s) */
-	*pBuf1++ = chan1;	// [TC]
-	*pBuf2++ = chan2;	// [TC]
-	*pBuf3++ = chan3;	// [TC]
-#if 0
-    if( !sound_stereo ) {
-      /* mono */
-      ( *ptr++ ) += chan1 + chan2 + chan3;
-    } else {
-      if( !sound_stereo_ay ) {
-	/* stereo output, but mono AY sound; still,
-	 * incr separately in case of beeper pseudostereo.
-	 */
-	( *ptr++ ) += chan1 + chan2 + chan3;
-	( *ptr++ ) += chan1 + chan2 + chan3;
-      } else {
-	/* stereo with ACB/ABC AY positioning.
-	 * Here we use real stereo positions for the channels.
-	 * Just because, y'know, it's cool and stuff. No, really. :-)
-	 * This is a little tricky, as it works by delaying sounds
-	 * on the left or right channels to model the delay you get
-	 * in the real world when sounds originate at different places.
-	 */
-	GEN_STEREO( rchan1pos, chan1 );
-	GEN_STEREO( rchan2pos, chan2 );
-	GEN_STEREO( rchan3pos, chan3 );
-	( *ptr++ ) += rstereobuf_l[ rstereopos ];
-	( *ptr++ ) += rstereobuf_r[ rstereopos ];
-	rstereobuf_l[ rstereopos ] = rstereobuf_r[ rstereopos ] = 0;
-	rstereopos++;
-	if( rstereopos >= STEREO_BUF_SIZE )
-	  rstereopos = 0;
-      }
-    }
-#endif
+    /* the noise gate for this sample (before the update below) */
+    noise_toggles[f] = noise_toggle ? 1 : 0;
 
     /* update noise RNG/filter */
     ay_noise_tick += noise_count;
@@ -724,6 +622,116 @@ void AY8913::sound_ay_overlay( void )
 	break;
     }
   }
+
+  /* pass 2: generate tone+noise... or neither, for each channel.
+   * (if no tone/noise is selected, the chip just shoves the
+   * level out unmodified. This is used by some sample-playing
+   * stuff.)
+   */
+  for( g = 0; g < 3; g++ ) {
+    libspectrum_signed_word* pBuf = ppSoundBuffers[g] + ofs;
+    const bool use_env = ( sound_ay_registers[ 8 + g ] & 16 ) != 0;
+    const int fixed_level = ay_tone_levels[ sound_ay_registers[ 8 + g ] & 15 ];
+    const bool tone_on = ( mixer & ( 1 << g ) ) == 0;
+    const bool noise_on = ( mixer & ( 8 << g ) ) == 0;
+
+    if( tone_on && !use_env && !fixed_level ) {
+      /* silent, so just advance the tone counter (the while loop in AY_DO_TONE, done in one go) */
+      unsigned int ticks = 0;
+      for( f = 0; f < num; f++ )
+	ticks += tone_counts[f];
+
+      ay_tone_tick[g] += ticks;
+      count = ay_tone_tick[g] / ay_tone_period[g];
+      ay_tone_tick[g] -= count * ay_tone_period[g];
+      if( count & 1 )
+	ay_tone_high[g] = !ay_tone_high[g];
+
+      memset( pBuf, 0, num * sizeof( libspectrum_signed_word ) );
+      continue;
+    }
+
+    if( tone_on ) {
+      for( f = 0; f < num; f++ ) {
+	int chan;
+	level = use_env ? env_levels[f] : fixed_level;
+	tone_count = tone_counts[f];
+	AY_DO_TONE( chan, g );
+	pBuf[f] = chan;
+      }
+    } else if( use_env ) {
+      for( f = 0; f < num; f++ )
+	pBuf[f] = env_levels[f];
+    } else {
+      for( f = 0; f < num; f++ )
+	pBuf[f] = fixed_level;
+    }
+
+    if( noise_on ) {
+      for( f = 0; f < num; f++ )
+	pBuf[f] = noise_toggles[f] ? 0 : pBuf[f];
+    }
+  }
+}
+
+void AY8913::sound_ay_overlay( void )
+{
+  int f;
+  struct ay_change_tag *change_ptr = ay_change;
+  int changes_left = ay_change_count;
+  int reg;
+  libspectrum_dword sfreq, cpufreq;
+
+///* If no AY chip, don't produce any AY sound (!) */
+//  if( !machine_current->capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_AY )
+//    return;
+
+/* convert change times to sample offsets, use common denominator of 50 to
+   avoid overflowing a dword */
+  sfreq = sound_generator_freq / HZ_COMMON_DENOMINATOR;
+//  cpufreq = machine_current->timings.processor_speed / HZ_COMMON_DENOMINATOR;
+  cpufreq = (libspectrum_dword) (m_fCurrentCLK_AY8910 / HZ_COMMON_DENOMINATOR);	// [TC]
+  int dbgCount=0;
+  for( f = 0; f < ay_change_count; f++ )
+  {
+    ay_change[f].ofs = (USHORT) (( ay_change[f].tstates * sfreq ) / cpufreq);	// [TC] Added cast
+
+	if (ay_change[f].ofs >= sound_generator_framesiz)	// [TC] Ensure that all ay_change's get processed
+	{
+		ay_change[f].ofs = sound_generator_framesiz-1;	// [TC] - as parent, sound_frame(), just dumps outstanding changes (ay_change_count=0)
+		dbgCount++;
+	}
+  }
+#if defined(_DEBUG) && 0
+  if (dbgCount)
+  {
+	  LogOutput("ay_change: saved %d\n", dbgCount);	// [TC] previously would've been dumped!
+  }
+#endif
+
+  f = 0;
+  while( f < sound_generator_framesiz ) {
+    /* update ay registers. All this sub-frame change stuff
+     * is pretty hairy, but how else would you handle the
+     * samples in Robocop? :-) It also clears up some other
+     * glitches.
+     */
+    while( changes_left && f >= change_ptr->ofs ) {
+      sound_ay_registers[ reg = change_ptr->reg ] = change_ptr->val;
+      change_ptr++;
+      changes_left--;
+
+      sound_ay_change_reg( reg );
+    }
+
+    /* [TC] the registers are now stable until the next change (or the end of the frame) */
+    int end = changes_left ? change_ptr->ofs : sound_generator_framesiz;
+    if( end - f > AY_BLOCK_MAX )
+      end = f + AY_BLOCK_MAX;
+
+    sound_ay_block( f, end - f );
+    f = end;
+  }
 }
 
 BYTE AY8913::sound_ay_read( int reg )
@@ -785,6 +793,40 @@ void AY8913::sound_ay_write( int reg, int val, libspectrum_dword now )
 }
 
 
+/* [AppleWin-TC] true if the next sound_frame() would only output 0's:
+ * no writes are pending, and each channel's level is 0 (a fixed volume of 0,
+ * or an envelope that is held at 0).
+ * NB. Mixer bits are ignored: with tone & noise disabled the level is output
+ * unmodified (eg. for sample playback), so it's only silent if that level is 0.
+ */
+bool AY8913::IsSilent( void )
+{
+  int g;
+
+  if( ay_change_count )
+    return false;
+
+  /* once the first cycle is done, a non-continuing or holding envelope
+   * won't change again until R13 is written
+   */
+  const int envshape = sound_ay_registers[13];
+  const bool env_held = !env_first &&
+    ( !( envshape & AY_ENV_CONT ) || ( envshape & AY_ENV_HOLD ) );
+
+  for( g = 0; g < 3; g++ ) {
+    const int vol = sound_ay_registers[ 8 + g ];
+    if( vol & 16 ) {
+      if( !env_held || ay_tone_levels[ env_counter ] )
+	return false;
+    } else if( ay_tone_levels[ vol & 15 ] ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
 /* no need to call this initially, but should be called
  * on reset otherwise.
  */
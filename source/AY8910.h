@@ -25,6 +25,7 @@ public:
 	void sound_ay_write( int reg, int val, libspectrum_dword now );
 	void sound_ay_reset( void );
 	void sound_frame( void );
+	bool IsSilent( void );
 	BYTE* GetAYRegsPtr( void ) { return &sound_ay_registers[0]; }
 	void SetFramesize(int frameSize) { sound_generator_framesiz = frameSize; }
 	void SetSoundBuffers(INT16** buffers) { ppSoundBuffers = buffers; }
@@ -36,6 +37,8 @@ private:
 	void init( void );
 	void sound_end( void );
 	void sound_ay_overlay( void );
+	void sound_ay_change_reg( int reg );
+	void sound_ay_block( int ofs, int num );
 
 private:
 	/* foo_subcycles are fixed-point with low 16 bits as fractional part.
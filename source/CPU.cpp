@@ -145,6 +145,11 @@ static bool g_irqOnLastOpcodeCycle = false;
 static eCpuType g_MainCPU = CPU_65C02;
 static eCpuType g_ActiveCPU = CPU_65C02;
 
+static bool g_isDiskAccelerated = false;	// Service DOS 3.3 RWTS & ProDOS Disk II driver reads at the sector level
+static bool g_diskAccelReturnPending = false;	// A serviced call still needs its synthesised RTS
+
+static SynchronousEventManager* g_pSyncEventMgr = NULL;	// Cached by CpuExecute(), as it's needed after every opcode
+
 eCpuType GetMainCpu(void)
 {
 	return g_MainCPU;
@@ -185,6 +190,17 @@ void SetActiveCpu(eCpuType cpu)
 	g_ActiveCPU = cpu;
 }
 
+void CpuSetDiskAccelerated(const bool enable)
+{
+	g_isDiskAccelerated = enable;
+	g_diskAccelReturnPending = false;
+}
+
+bool CpuIsDiskAccelerated(void)
+{
+	return g_isDiskAccelerated;
+}
+
 bool IsIrqAsserted(void)
 {
 	return g_bmIRQ ? true : false;
@@ -359,7 +375,31 @@ static void DebugHddEntrypoint(const USHORT PC)
 }
 #endif
 
-static __forceinline void Fetch(BYTE& iOpcode, ULONG uExecutedCycles)
+// Accelerated disk: PC is at the DOS 3.3 RWTS or ProDOS Disk II driver entrypoint
+// . if Disk2CardManager services the call, then return from it via a synthesised CLC then RTS (without advancing PC),
+//   so that the cores update their own copy of the flags as normal
+// . A (the RWTS's IOB ptr hi) is only zeroed for the RTS, so a save-state taken between the two still re-runs the call correctly
+static bool DiskAcceleratedTrap(BYTE& iOpcode, ULONG& uExecutedCycles)
+{
+	if (!g_diskAccelReturnPending)
+	{
+		const UINT cycles = GetCardMgr().GetDisk2CardMgr().AcceleratedEntrypoint(regs.pc);
+		if (cycles == 0)
+			return false;	// not serviced, so emulate the call as normal
+
+		uExecutedCycles += cycles;
+		g_diskAccelReturnPending = true;
+		iOpcode = 0x18;	// CLC
+		return true;
+	}
+
+	g_diskAccelReturnPending = false;
+	regs.a = 0;		// no error
+	iOpcode = 0x60;	// RTS
+	return true;
+}
+
+static __forceinline void Fetch(BYTE& iOpcode, ULONG& uExecutedCycles)
 {
 	const USHORT PC = regs.pc;
 
@@ -367,9 +407,15 @@ static __forceinline void Fetch(BYTE& iOpcode, ULONG uExecutedCycles)
 	DebugHddEntrypoint(PC);
 #endif
 
+	if (g_isDiskAccelerated && (PC == Disk2CardManager::kAccelRWTSEntry || PC == Disk2CardManager::kAccelProDOSEntry))
+	{
+		if (DiskAcceleratedTrap(iOpcode, uExecutedCycles))
+			return;
+	}
+
 	iOpcode = ((PC & 0xF000) == 0xC000)
 	    ? IORead[(PC>>4) & 0xFF](PC,PC,0,0,uExecutedCycles)	// Fetch opcode from I/O memory, but params are still from mem[]
-		: *(mem+PC);
+		: _MEMREAD8(PC);
 
 #ifdef USE_SPEECH_API
 	if ((PC == COUT1 || PC == BASICOUT) && g_Speech.IsEnabled() && !g_bFullSpeed)
@@ -398,7 +444,7 @@ static __forceinline bool NMI(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 	regs.ps |= AF_INTERRUPT;
 	if (GetMainCpu() == CPU_65C02)	// GH#1099
 		regs.ps &= ~AF_DECIMAL;
-	regs.pc = * (WORD*) (mem+0xFFFA);
+	regs.pc = _MEMREAD16(0xFFFA);
 	UINT uExtraCycles = 0;	// Needed for CYC(a) macro
 	CYC(7);
 	g_interruptInLastExecutionBatch = true;
@@ -410,7 +456,18 @@ static __forceinline bool NMI(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 
 static __forceinline void CheckSynchronousInterruptSources(UINT cycles, ULONG uExecutedCycles)
 {
-	g_SynchronousEventMgr.Update(cycles, uExecutedCycles);
+	g_pSyncEventMgr->Update(cycles, uExecutedCycles);
+}
+
+// Used by the cores to skip the Z80/NMI/IRQ checks (before each opcode) until one of them has something to do
+// . NB. IRQ() also needs calling when only g_irqOnLastOpcodeCycle is set, so that it gets cleared
+static __forceinline bool IsInterruptOrZ80Pending(void)
+{
+#ifdef ENABLE_NMI_SUPPORT
+	if (g_bNmiFlank)
+		return true;
+#endif
+	return g_bmIRQ || g_irqOnLastOpcodeCycle || g_ActiveCPU == CPU_Z80;
 }
 
 static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn, BOOL& flagv, BOOL& flagz)
@@ -440,7 +497,7 @@ static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 		regs.ps |= AF_INTERRUPT;
 		if (GetMainCpu() == CPU_65C02)	// GH#1099
 			regs.ps &= ~AF_DECIMAL;
-		regs.pc = * (WORD*) (mem+0xFFFE);
+		regs.pc = _MEMREAD16(0xFFFE);
 		UINT uExtraCycles = 0;	// Needed for CYC(a) macro
 		CYC(7);
 #if defined(_DEBUG) && LOG_IRQ_TAKEN_AND_RTI
@@ -515,6 +572,8 @@ static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 
 static DWORD InternalCpuExecute(const DWORD uTotalCycles, const bool bVideoUpdate)
 {
+	MemUpdatePagingByPointer();
+
 	if (g_nAppMode == MODE_RUNNING || g_nAppMode == MODE_BENCHMARK)
 	{
 		if (GetMainCpu() == CPU_6502)
@@ -616,6 +675,7 @@ DWORD CpuExecute(const DWORD uCycles, const bool bVideoUpdate)
 
 	g_nCyclesExecuted =	0;
 	g_interruptInLastExecutionBatch = false;
+	g_pSyncEventMgr = &GetSynchronousEventMgr();
 
 #ifdef _DEBUG
 	GetCardMgr().GetMockingboardCardMgr().CheckCumulativeCycles();
@@ -692,12 +752,13 @@ void CpuReset()
 	regs.ps |= AF_INTERRUPT;
 	if (GetMainCpu() == CPU_65C02)	// GH#1099
 		regs.ps &= ~AF_DECIMAL;
-	regs.pc = *(WORD*)(mem + 0xFFFC);
+	regs.pc = _MEMREAD16(0xFFFC);
 	regs.sp = 0x0100 | ((regs.sp - 3) & 0xFF);
 
 	regs.bJammed = 0;
 
 	g_irqDefer1Opcode = false;
+	g_diskAccelReturnPending = false;
 
 	SetActiveCpu(GetMainCpu());
 	z80_reset();
@@ -56,6 +56,8 @@ eCpuType ProbeMainCpuDefault(eApple2Type apple2Type);
 void     SetMainCpuDefault(eApple2Type apple2Type);
 eCpuType GetActiveCpu(void);
 void     SetActiveCpu(eCpuType cpu);
+void     CpuSetDiskAccelerated(const bool enable);
+bool     CpuIsDiskAccelerated(void);
 
 bool IsIrqAsserted(void);
 bool Is6502InterruptEnabled(void);
@@ -46,11 +46,13 @@ static DWORD Cpu6502(DWORD uTotalCycles, const bool bVideoUpdate)
 		ULONG uPreviousCycles = uExecutedCycles;
 // NTSC_END
 
-		if (GetActiveCpu() == CPU_Z80)
+		const bool bPending = IsInterruptOrZ80Pending();	// Usually false, so skip the Z80/NMI/IRQ checks
+
+		if (bPending && GetActiveCpu() == CPU_Z80)
 		{
 			const UINT uZ80Cycles = z80_mainloop(uTotalCycles, uExecutedCycles); CYC(uZ80Cycles)
 		}
-		else if (NMI(uExecutedCycles, flagc, flagn, flagv, flagz) || IRQ(uExecutedCycles, flagc, flagn, flagv, flagz))
+		else if (bPending && (NMI(uExecutedCycles, flagc, flagn, flagv, flagz) || IRQ(uExecutedCycles, flagc, flagn, flagv, flagz)))
 		{
 			// Allow AppleWin debugger's single-stepping to just step the pending IRQ
 		}
@@ -50,21 +50,26 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 			      | AF_RESERVED | AF_BREAK;
 // CYC(a): This can be optimised, as only certain opcodes will affect uExtraCycles
 #define CYC(a)	 uExecutedCycles += (a)+uExtraCycles;
-#define POP	 (*(mem+((regs.sp >= 0x1FF) ? (regs.sp = 0x100) : ++regs.sp)))
-#define PUSH(a)	 *(mem+regs.sp--) = (a);				    \
+// Reads from the CPU's current view of memory (excludes I/O) via the memread[] page table
+// . NB. 16-bit reads are split, as consecutive pages needn't be adjacent in host memory (and to wrap at $FFFF)
+#define _MEMREAD8(a)	(*(memread[(WORD)(a) >> 8]+((a) & 0xFF)))
+#define _MEMREAD16(a)	(_MEMREAD8(a) | ((WORD)_MEMREAD8((WORD)((a)+1)) << 8))
+// Page1 (stack) is always RAM, so the read page is also the write page
+#define POP	 (*(memread[1]+(((regs.sp >= 0x1FF) ? (regs.sp = 0x100) : ++regs.sp) & 0xFF)))
+#define PUSH(a)	 *(memread[1]+(regs.sp-- & 0xFF)) = (a);		    \
 		 if (regs.sp < 0x100)					    \
 		   regs.sp = 0x1FF;
 #define _READ	(																\
 			((addr & 0xF000) == 0xC000)											\
 				? IORead[(addr>>4) & 0xFF](regs.pc,addr,0,0,uExecutedCycles)	\
-				: *(mem+addr)													\
+				: _MEMREAD8(addr)												\
 		)
 #define _READ_WITH_IO_F8xx (										/* GH#827 */\
 			((addr & 0xF000) == 0xC000)											\
 				? IORead[(addr>>4) & 0xFF](regs.pc,addr,0,0,uExecutedCycles)	\
 				: (addr >= 0xF800)												\
 					? IO_F8xx(regs.pc,addr,0,0,uExecutedCycles)					\
-					: *(mem+addr)												\
+					: _MEMREAD8(addr)											\
 		)
 #define SETNZ(a) {							    \
 		   flagn = ((a) & 0x80);				    \
@@ -73,10 +78,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define SETZ(a)	 flagz = !((a) & 0xFF);
 #define _WRITE(a) {																		\
 			{																			\
-				memdirty[addr >> 8] = 0xFF;												\
 				LPBYTE page = memwrite[addr >> 8];										\
+				if (!page && (addr & 0xF000) != 0xC000)									\
+					page = MemWriteTrap(addr);	/* 1st write to a clean page */			\
 				if (page)																\
-					*(page+(addr & 0xFF)) = (BYTE)(a);									\
+					*(page+(addr & 0xFF)) = (BYTE)(a);	/* ROM: to memWriteSink */		\
 				else if ((addr & 0xF000) == 0xC000)										\
 					IOWrite[(addr>>4) & 0xFF](regs.pc,addr,1,(BYTE)(a),uExecutedCycles);\
 			}																			\
@@ -85,11 +91,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 			if (addr >= 0xF800)															\
 				IO_F8xx(regs.pc,addr,1,(BYTE)(a),uExecutedCycles);						\
 			else {																		\
-				memdirty[addr >> 8] = 0xFF;												\
 				LPBYTE page = memwrite[addr >> 8];										\
+				if (!page && (addr & 0xF000) != 0xC000)									\
+					page = MemWriteTrap(addr);	/* 1st write to a clean page */			\
 				if (page) {																\
-					*(page+(addr & 0xFF)) = (BYTE)(a);									\
-					if (memVidHD)											/* GH#997 */\
+					*(page+(addr & 0xFF)) = (BYTE)(a);	/* ROM: to memWriteSink */		\
+					if (memVidHD && page != memWriteSink)					/* GH#997 */\
 						*(memVidHD + addr) = (BYTE)(a);									\
 				}																		\
 				else if ((addr & 0xF000) == 0xC000)										\
@@ -125,69 +132,69 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 *
 ***/
 
-#define ABS	 addr = *(LPWORD)(mem+regs.pc);	 regs.pc += 2;
-#define IABSX    addr = *(LPWORD)(mem+(*(LPWORD)(mem+regs.pc))+(WORD)regs.x); regs.pc += 2;
+#define ABS	 addr = _MEMREAD16(regs.pc);	 regs.pc += 2;
+#define IABSX    base = _MEMREAD16(regs.pc); addr = _MEMREAD16((WORD)(base+regs.x)); regs.pc += 2;
 
 // Optimised for page-cross
-#define ABSX_OPT base = *(LPWORD)(mem+regs.pc); addr = base+(WORD)regs.x; regs.pc += 2; CHECK_PAGE_CHANGE;
+#define ABSX_OPT base = _MEMREAD16(regs.pc); addr = base+(WORD)regs.x; regs.pc += 2; CHECK_PAGE_CHANGE;
 // Not optimised for page-cross
-#define ABSX_CONST base = *(LPWORD)(mem+regs.pc); addr = base+(WORD)regs.x; regs.pc += 2;
+#define ABSX_CONST base = _MEMREAD16(regs.pc); addr = base+(WORD)regs.x; regs.pc += 2;
 
 // Optimised for page-cross
-#define ABSY_OPT base = *(LPWORD)(mem+regs.pc); addr = base+(WORD)regs.y; regs.pc += 2; CHECK_PAGE_CHANGE;
+#define ABSY_OPT base = _MEMREAD16(regs.pc); addr = base+(WORD)regs.y; regs.pc += 2; CHECK_PAGE_CHANGE;
 // Not optimised for page-cross
-#define ABSY_CONST base = *(LPWORD)(mem+regs.pc); addr = base+(WORD)regs.y; regs.pc += 2;
+#define ABSY_CONST base = _MEMREAD16(regs.pc); addr = base+(WORD)regs.y; regs.pc += 2;
 
 // TODO Optimization Note (just for IABSCMOS): uExtraCycles = ((base & 0xFF) + 1) >> 8;
-#define IABS_CMOS base = *(LPWORD)(mem+regs.pc);	                          \
-		 addr = *(LPWORD)(mem+base);		                  \
+#define IABS_CMOS base = _MEMREAD16(regs.pc);	                          \
+		 addr = _MEMREAD16(base);		                  \
 		 if ((base & 0xFF) == 0xFF) uExtraCycles=1;		  \
 		 regs.pc += 2;
-#define IABS_NMOS base = *(LPWORD)(mem+regs.pc);	                          \
+#define IABS_NMOS base = _MEMREAD16(regs.pc);	                          \
 		 if ((base & 0xFF) == 0xFF)				  \
-		       addr = *(mem+base)+((WORD)*(mem+(base&0xFF00))<<8);\
+		       addr = _MEMREAD8(base)+((WORD)_MEMREAD8(base&0xFF00)<<8);\
 		 else                                                   \
-		       addr = *(LPWORD)(mem+base);                        \
+		       addr = _MEMREAD16(base);                           \
 		 regs.pc += 2;
 
 #define IMM	 addr = regs.pc++;
 
-#define INDX	 base = ((*(mem+regs.pc++))+regs.x) & 0xFF;          \
+#define INDX	 base = (_MEMREAD8(regs.pc)+regs.x) & 0xFF; regs.pc++; \
 		 if (base == 0xFF)                                   \
-		     addr = *(mem+0xFF)+(((WORD)*mem)<<8);           \
+		     addr = _MEMREAD8(0xFF)+(((WORD)_MEMREAD8(0))<<8); \
 		 else                                                \
-		     addr = *(LPWORD)(mem+base);
+		     addr = _MEMREAD16(base);
 
 // Optimised for page-cross
-#define INDY_OPT	 if (*(mem+regs.pc) == 0xFF)             /*incurs an extra cycle for page-crossing*/ \
-		     base = *(mem+0xFF)+(((WORD)*mem)<<8);           \
+#define INDY_OPT	 if (_MEMREAD8(regs.pc) == 0xFF)         /*incurs an extra cycle for page-crossing*/ \
+		     base = _MEMREAD8(0xFF)+(((WORD)_MEMREAD8(0))<<8); \
 		 else                                                \
-		     base = *(LPWORD)(mem+*(mem+regs.pc));           \
+		     base = _MEMREAD16(_MEMREAD8(regs.pc));          \
 		 regs.pc++;                                          \
 		 addr = base+(WORD)regs.y;                           \
 		 CHECK_PAGE_CHANGE;
 // Not optimised for page-cross
-#define INDY_CONST	 if (*(mem+regs.pc) == 0xFF)             /*no extra cycle for page-crossing*/ \
-		     base = *(mem+0xFF)+(((WORD)*mem)<<8);           \
+#define INDY_CONST	 if (_MEMREAD8(regs.pc) == 0xFF)         /*no extra cycle for page-crossing*/ \
+		     base = _MEMREAD8(0xFF)+(((WORD)_MEMREAD8(0))<<8); \
 		 else                                                \
-		     base = *(LPWORD)(mem+*(mem+regs.pc));           \
+		     base = _MEMREAD16(_MEMREAD8(regs.pc));          \
 		 regs.pc++;                                          \
 		 addr = base+(WORD)regs.y;
 
-#define IZPG	 base = *(mem+regs.pc++);                            \
+#define IZPG	 base = _MEMREAD8(regs.pc); regs.pc++;               \
 		 if (base == 0xFF)                                   \
-		     addr = *(mem+0xFF)+(((WORD)*mem)<<8);           \
+		     addr = _MEMREAD8(0xFF)+(((WORD)_MEMREAD8(0))<<8); \
 		 else                                                \
-		     addr = *(LPWORD)(mem+base);
+		     addr = _MEMREAD16(base);
 
-#define REL	 addr = (signed char)*(mem+regs.pc++);
+#define REL	 addr = (signed char)_MEMREAD8(regs.pc); regs.pc++;
 
 // TODO Optimization Note:
 // . Opcodes that generate zero-page addresses can't be accessing $C000..$CFFF
 //   so they could be paired with special READZP/WRITEZP macros (instead of READ/WRITE)
-#define ZPG 	 addr =   *(mem+regs.pc++);
-#define ZPGX	 addr = ((*(mem+regs.pc++))+regs.x) & 0xFF;
-#define ZPGY	 addr = ((*(mem+regs.pc++))+regs.y) & 0xFF;
+#define ZPG 	 addr =   _MEMREAD8(regs.pc); regs.pc++;
+#define ZPGX	 addr = (_MEMREAD8(regs.pc)+regs.x) & 0xFF; regs.pc++;
+#define ZPGY	 addr = (_MEMREAD8(regs.pc)+regs.y) & 0xFF; regs.pc++;
 
 // Tidy 3 char addressing modes to keep the opcode table visually aligned, clean, and readable.
 #undef asl
@@ -661,6 +661,22 @@ bool ProcessCmdLine(LPSTR lpCmdLine)
 			lpNextArg = GetNextArg(lpNextArg);
 			g_cmdLine.wavFileMockingboard = lpCmdLine;
 		}
+		else if (strcmp(lpCmdLine, "-wav-output") == 0)
+		{
+			lpCmdLine = GetCurrArg(lpNextArg);
+			lpNextArg = GetNextArg(lpNextArg);
+			g_cmdLine.wavFileOutput = lpCmdLine;
+		}
+		else if (strcmp(lpCmdLine, "-wav-capture") == 0)
+		{
+			lpCmdLine = GetCurrArg(lpNextArg);
+			lpNextArg = GetNextArg(lpNextArg);
+			g_cmdLine.wavCaptureDir = lpCmdLine;
+		}
+		else if (strcmp(lpCmdLine, "-wav-lossless") == 0)
+		{
+			g_cmdLine.wavCaptureLossless = true;
+		}
 		else if (strcmp(lpCmdLine, "-mb-audit") == 0)	// enable selection of additional sound cards, eg. for mb-audit
 		{
 			g_cmdLine.supportExtraMBCardTypes = true;
@@ -677,6 +693,54 @@ bool ProcessCmdLine(LPSTR lpCmdLine)
 		{
 			g_cmdLine.useHdcFirmwareV2 = true;
 		}
+		else if (strcmp(lpCmdLine, "-mem-paging-by-pointer") == 0)
+		{
+			g_cmdLine.memPagingByPointer = true;
+		}
+		else if (strcmp(lpCmdLine, "-video-scanline-cache") == 0)
+		{
+			g_cmdLine.videoScanlineCache = true;
+		}
+		else if (strcmp(lpCmdLine, "-rewind") == 0)
+		{
+			lpCmdLine = GetCurrArg(lpNextArg);
+			lpNextArg = GetNextArg(lpNextArg);
+			g_cmdLine.uRewindSnapshots = strtoul(lpCmdLine, NULL, 10);
+		}
+		else if (strcmp(lpCmdLine, "-rewind-interval") == 0)
+		{
+			lpCmdLine = GetCurrArg(lpNextArg);
+			lpNextArg = GetNextArg(lpNextArg);
+			g_cmdLine.uRewindFramesPerSnapshot = strtoul(lpCmdLine, NULL, 10);
+		}
+		else if (strcmp(lpCmdLine, "-disk-writeback-idle") == 0)
+		{
+			lpCmdLine = GetCurrArg(lpNextArg);
+			lpNextArg = GetNextArg(lpNextArg);
+			g_cmdLine.uDiskWriteBackIdleMs = strtoul(lpCmdLine, NULL, 10);
+		}
+		else if (strcmp(lpCmdLine, "-disk-overlay") == 0)
+		{
+			lpCmdLine = GetCurrArg(lpNextArg);
+			lpNextArg = GetNextArg(lpNextArg);
+			g_cmdLine.strDiskOverlayDir = lpCmdLine;
+		}
+		else if (strcmp(lpCmdLine, "-disk-overlay-commit") == 0)
+		{
+			g_cmdLine.diskOverlayOpenAction = eOVERLAY_OPEN_COMMIT;
+		}
+		else if (strcmp(lpCmdLine, "-disk-overlay-discard") == 0)
+		{
+			g_cmdLine.diskOverlayOpenAction = eOVERLAY_OPEN_DISCARD;
+		}
+		else if (strcmp(lpCmdLine, "-disk-prefetch") == 0)
+		{
+			g_cmdLine.diskTrackPrefetch = true;
+		}
+		else if (strcmp(lpCmdLine, "-disk-accelerated") == 0)
+		{
+			g_cmdLine.diskAccelerated = true;
+		}
 		else	// unsupported
 		{
 			LogFileOutput("Unsupported arg: %s\n", lpCmdLine);
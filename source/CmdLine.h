@@ -40,11 +40,19 @@ struct CmdLine
 		enableDumpToRealPrinter = false;
 		supportExtraMBCardTypes = false;
 		noDisk2StepperDefer = false;
+		diskTrackPrefetch = false;
+		diskAccelerated = false;
 		useHdcFirmwareV1 = false;
 		useHdcFirmwareV2 = false;
+		memPagingByPointer = false;
+		videoScanlineCache = false;
 		szSnapshotName = NULL;
 		snapshotIgnoreHdcFirmware = false;
 		szScreenshotFilename = NULL;
+		uRewindSnapshots = 0;
+		uRewindFramesPerSnapshot = 0;
+		uDiskWriteBackIdleMs = 0;
+		diskOverlayOpenAction = eOVERLAY_OPEN_KEEP;
 		uHarddiskNumBlocks = 0;
 		uRamWorksExPages = 0;
 		uSaturnBanks = 0;
@@ -60,6 +68,7 @@ struct CmdLine
 		bestFullScreenResolution = false;
 		userSpecifiedWidth = 0;
 		userSpecifiedHeight = 0;
+		wavCaptureLossless = false;
 
 		for (UINT i = 0; i < NUM_SLOTS; i++)
 		{
@@ -87,8 +96,12 @@ struct CmdLine
 	bool enableDumpToRealPrinter;
 	bool supportExtraMBCardTypes;
 	bool noDisk2StepperDefer;	// debug
+	bool diskTrackPrefetch;
+	bool diskAccelerated;
 	bool useHdcFirmwareV1;	// debug
 	bool useHdcFirmwareV2;
+	bool memPagingByPointer;
+	bool videoScanlineCache;
 	SS_CARDTYPE slotInsert[NUM_SLOTS];
 	SlotInfo slotInfo[NUM_SLOTS];
 	LPCSTR szImageName_drive[NUM_SLOTS][NUM_DRIVES];
@@ -98,6 +111,9 @@ struct CmdLine
 	LPSTR szSnapshotName;
 	bool snapshotIgnoreHdcFirmware;
 	LPSTR szScreenshotFilename;
+	UINT uRewindSnapshots;			// 0 => rewind disabled
+	UINT uRewindFramesPerSnapshot;	// 0 => use default
+	UINT uDiskWriteBackIdleMs;	// 0 => use default
 	UINT uRamWorksExPages;
 	UINT uSaturnBanks;
 	int newVideoType;
@@ -115,6 +131,11 @@ struct CmdLine
 	UINT userSpecifiedHeight;
 	std::string wavFileSpeaker;
 	std::string wavFileMockingboard;
+	std::string wavFileOutput;
+	std::string wavCaptureDir;	// empty => no per-source/per-voice capture
+	bool wavCaptureLossless;
+	std::string strDiskOverlayDir;	// empty => overlay disabled
+	ImageOverlayOpen_e diskOverlayOpenAction;
 };
 
 bool ProcessCmdLine(LPSTR lpCmdLine);
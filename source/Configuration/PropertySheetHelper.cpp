@@ -33,6 +33,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "../Log.h"
 #include "../Registry.h"
 #include "../SaveState.h"
+#include "../YamlHelper.h"
 #include "../Interface.h"
 #include "../Uthernet2.h"
 #include "../Tfe/PCapBackend.h"
@@ -199,6 +200,7 @@ int CPropertySheetHelper::SaveStateSelectImage(HWND hWindow, const TCHAR* pszTit
 	ofn.hwndOwner       = hWindow;
 	ofn.hInstance       = GetFrame().g_hInstance;
 	ofn.lpstrFilter     = TEXT("Save State files (*.aws.yaml)\0*.aws.yaml\0")
+						  TEXT("Binary Save State files (*.aws.bin)\0*.aws.bin\0")
 						  TEXT("All Files\0*.*\0");
 	ofn.lpstrFile       = szFilename;	// Dialog strips the last .EXT from this string (eg. file.aws.yaml is displayed as: file.aws
 	ofn.nMaxFile        = sizeof(szFilename);
@@ -209,7 +211,7 @@ int CPropertySheetHelper::SaveStateSelectImage(HWND hWindow, const TCHAR* pszTit
 	int nRes = bSave ? GetSaveFileName(&ofn) : GetOpenFileName(&ofn);
 	if (nRes)
 	{
-		if (bSave)	// Only for saving (allow loading of any file for backwards compatibility)
+		if (bSave && !IsBinarySaveStatePathname(&szFilename[ofn.nFileOffset]))	// Only for saving (allow loading of any file for backwards compatibility)
 		{
 			// Append .aws.yaml if it's not there
 			const char szAWS_EXT1[] = ".aws";
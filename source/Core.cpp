@@ -33,10 +33,14 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "CPU.h"
 #include "Interface.h"
 #include "Log.h"
+#include "Machine.h"
 #include "Memory.h"
+#include "NTSC.h"
 #include "Pravets.h"
 #include "Speaker.h"
 #include "Registry.h"
+#include "SaveState.h"
+#include "SoundMixer.h"
 #include "SynchronousEventManager.h"
 
 #ifdef USE_SPEECH_API
@@ -83,8 +87,6 @@ DWORD       g_dwCyclesThisFrame = 0;
 
 int			g_nMemoryClearType = MIP_FF_FF_00_00; // Note: -1 = random MIP in Memory.cpp MemReset()
 
-SynchronousEventManager g_SynchronousEventMgr;
-
 HANDLE		g_hCustomRomF8 = INVALID_HANDLE_VALUE;	// Cmd-line specified custom F8 ROM at $F800..$FFFF
 bool	    g_bCustomRomF8Failed = false;			// Set if custom F8 ROM file failed
 HANDLE		g_hCustomRom = INVALID_HANDLE_VALUE;	// Cmd-line specified custom ROM at $C000..$FFFF(16KiB) or $D000..$FFFF(12KiB)
@@ -159,9 +161,9 @@ void LogFileTimeUntilFirstKeyRead(void)
 	if (!g_fh || bLogKeyReadDone)
 		return;
 
-	if ( (mem[regs.pc-3] != 0x2C)	// AZTEC: bit $c000
-		&& !((regs.pc-2) == 0xE797 && mem[regs.pc-2] == 0xB1 && mem[regs.pc-1] == 0x50)	// Phasor1: lda ($50),y
-		&& !((regs.pc-3) == 0x0895 && mem[regs.pc-3] == 0xAD)	// Rescue Raiders v1.3,v1.5: lda $c000
+	if ( (*MemGetReadPtr(regs.pc-3) != 0x2C)	// AZTEC: bit $c000
+		&& !((regs.pc-2) == 0xE797 && *MemGetReadPtr(regs.pc-2) == 0xB1 && *MemGetReadPtr(regs.pc-1) == 0x50)	// Phasor1: lda ($50),y
+		&& !((regs.pc-3) == 0x0895 && *MemGetReadPtr(regs.pc-3) == 0xAD)	// Rescue Raiders v1.3,v1.5: lda $c000
 		)
 		return;
 
@@ -190,10 +192,125 @@ const UINT16* GetOldAppleWinVersion(void)
 	return g_OldAppleWinVersion;
 }
 
+Machine& GetMachine(void)
+{
+	static Machine g_Machine;	// singleton (for now)
+	return g_Machine;
+}
+
 CardManager& GetCardMgr(void)
 {
-	static CardManager g_CardMgr;	// singleton
-	return g_CardMgr;
+	return GetMachine().GetCardMgr();
+}
+
+SynchronousEventManager& GetSynchronousEventMgr(void)
+{
+	return GetMachine().GetSynchronousEventMgr();
+}
+
+//===========================================================================
+
+// Work done at the end of every execution period, by ContinueExecution() and RunCycles()
+void ExecutionPeriodUpdate(const DWORD uExecutedCycles)
+{
+	SpkrUpdate(uExecutedCycles);
+	GetSoundMixer().Update();
+}
+
+// Work done at every video frame boundary (after the frame has been presented), by ContinueExecution() and RunCycles()
+// . returns true if a frame-advance has just paused the emulation
+bool ExecutionFrameUpdate(void)
+{
+#ifdef USE_RETROACHIEVEMENTS
+	if (g_nAppMode == MODE_RUNNING || g_nAppMode == MODE_STEPPING)
+		RA_DoAchievementsFrame();
+#endif
+
+	if (g_nAppMode == MODE_RUNNING)
+		Snapshot_RewindUpdate();
+
+	if (g_bFrameAdvance)
+	{
+		g_nAppMode = MODE_PAUSED;
+		g_bFrameAdvance = false;
+		return true;
+	}
+
+	return false;
+}
+
+static bool g_bVideoCatchUp = false;	// RunCycles() ran without the video scanner, so the frame buffer is stale
+
+// Redraw the frame buffer if RunCycles() left it stale: call before the frame buffer is next presented or read
+void VideoCatchUp(void)
+{
+	if (!g_bVideoCatchUp)
+		return;
+
+	g_bVideoCatchUp = false;
+	GetFrame().VideoRedrawScreen();
+}
+
+// Run the emulation (CPU & cards) for at least uCycles, as fast as the CPU core allows:
+// . It's ContinueExecution() at full-speed, but without realtime throttling or frame presentation
+// . So every 1000 cycles the cards, speaker & sound mixer are updated (but the speaker & Mockingboard don't generate samples)
+// . And at every video frame boundary ExecutionFrameUpdate() is done (achievements, rewind, frame-advance), then frameCallback (if set)
+// . Unless RUNCYCLES_VIDEO_UPDATE, the video scanner is skipped and just resync'd at the end, so the frame buffer is
+//   stale until VideoCatchUp() (which ContinueExecution() does), eg. call it from frameCallback to present each frame
+// Returns the # of cycles executed, which may overrun uCycles by the last opcode's cycles,
+// or be less than uCycles if a frame-advance paused the emulation.
+UINT64 RunCycles(const UINT64 uCycles, const UINT flags /*= 0*/, RunCyclesFrameCallback frameCallback /*= NULL*/)
+{
+	const DWORD kCyclesPerSlice = 1000;	// Granularity of card, speaker & mixer updates (ContinueExecution()'s 1ms)
+	const bool bVideoUpdate = (flags & RUNCYCLES_VIDEO_UPDATE) ? true : false;
+
+	const bool bWasFullSpeed = g_bFullSpeed;
+	g_bFullSpeed = true;
+	GetCardMgr().GetMockingboardCardMgr().MuteControl(true);	// As ContinueExecution() at full-speed
+
+	UINT64 uExecutedCycles = 0;
+	while (uExecutedCycles < uCycles)
+	{
+		const UINT64 uRemainingCycles = uCycles - uExecutedCycles;
+		const DWORD uCyclesToExecute = (uRemainingCycles < kCyclesPerSlice) ? (DWORD)uRemainingCycles : kCyclesPerSlice;
+
+		const DWORD uActualCyclesExecuted = CpuExecute(uCyclesToExecute, bVideoUpdate);
+		g_dwCyclesThisFrame += uActualCyclesExecuted;
+		uExecutedCycles += uActualCyclesExecuted;
+
+		GetCardMgr().Update(uActualCyclesExecuted);
+		ExecutionPeriodUpdate(uActualCyclesExecuted);
+
+		const UINT dwClksPerFrame = NTSC_GetCyclesPerFrame();
+		if (g_dwCyclesThisFrame >= dwClksPerFrame && !GetVideo().VideoGetVblBarEx(g_dwCyclesThisFrame))
+		{
+			g_dwCyclesThisFrame -= dwClksPerFrame;
+
+			if (!bVideoUpdate)
+			{
+				NTSC_VideoClockResync(g_dwCyclesThisFrame);
+				g_bVideoCatchUp = true;
+			}
+
+			const bool bPaused = ExecutionFrameUpdate();
+
+			if (frameCallback)
+				frameCallback();
+
+			if (bPaused)
+				break;
+		}
+	}
+
+	if (!bVideoUpdate)
+	{
+		NTSC_VideoClockResync(g_dwCyclesThisFrame);
+		g_bVideoCatchUp = true;
+	}
+
+	g_bFullSpeed = bWasFullSpeed;
+
+	return uExecutedCycles;
 }
 
 //===========================================================================
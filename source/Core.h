@@ -32,6 +32,20 @@ void UseClockMultiplier(double clockMultiplier);
 
 extern bool       g_bFullSpeed;
 
+void ExecutionPeriodUpdate(const DWORD uExecutedCycles);
+bool ExecutionFrameUpdate(void);
+void VideoCatchUp(void);
+
+// RunCycles() flags
+enum
+{
+	RUNCYCLES_VIDEO_UPDATE = 1 << 0,	// Keep the video scanner updating the frame buffer (slower)
+};
+
+typedef void (*RunCyclesFrameCallback)(void);	// Called by RunCycles() at each video frame boundary
+
+UINT64 RunCycles(const UINT64 uCycles, const UINT flags = 0, RunCyclesFrameCallback frameCallback = NULL);
+
 //===========================================
 
 extern AppMode_e g_nAppMode;
@@ -54,8 +68,9 @@ extern DWORD      g_dwCyclesThisFrame;
 
 extern int        g_nMemoryClearType;					// Cmd line switch: use specific MIP (Memory Initialization Pattern)
 
+extern class Machine& GetMachine(void);
 extern class CardManager& GetCardMgr(void);
-extern class SynchronousEventManager g_SynchronousEventMgr;
+extern class SynchronousEventManager& GetSynchronousEventMgr(void);
 
 extern HANDLE	g_hCustomRomF8;			// INVALID_HANDLE_VALUE if no custom F8 rom
 extern bool	    g_bCustomRomF8Failed;	// Set if custom F8 ROM file failed
@@ -41,6 +41,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "../CardManager.h"
 #include "../CPU.h"
 #include "../Disk.h"
+#include "../Harddisk.h"
 #include "../Keyboard.h"
 #include "../Memory.h"
 #include "../NTSC.h"
@@ -2523,7 +2524,7 @@ Update_t CmdJSR (int nArgs)
 	WORD nAddress = g_aArgs[1].nValue & _6502_MEM_END;
 
 	// Mark Stack Page as dirty
-	*(memdirty+(regs.sp >> 8)) = 1;
+	MemSetDirty(regs.sp);
 
 	// Push PC onto stack
 	*(mem + regs.sp) = ((regs.pc >> 8) & 0xFF);
@@ -3781,6 +3782,49 @@ Update_t CmdDisk (int nArgs)
 	return UPDATE_CONSOLE_DISPLAY;
 }
 
+//===========================================================================
+// Usage:
+//     HDD                                           // Block cache stats for each hard disk drive with an image
+Update_t CmdHdd (int nArgs)
+{
+	if (nArgs)
+		return HelpLastCommand();
+
+	bool found = false;
+
+	for (UINT slot = SLOT1; slot <= SLOT7; slot++)
+	{
+		if (GetCardMgr().QuerySlot(slot) != CT_GenericHDD)
+			continue;
+
+		HarddiskInterfaceCard& hddCard = dynamic_cast<HarddiskInterfaceCard&>(GetCardMgr().GetRef(slot));
+
+		for (int drive = 0; drive < NUM_HARDDISKS; drive++)
+		{
+			if (!hddCard.IsDriveLoaded(drive))
+				continue;
+
+			const HardDiskBlockCache::Stats& stats = hddCard.GetBlockCacheStats(drive);
+			const UINT64 reads = stats.hits + stats.misses;
+
+			ConsolePrintFormat(
+				"S"               CHC_NUM_DEC "%d"  CHC_DEFAULT " D" CHC_NUM_DEC "%d" CHC_ARG_SEP ":"
+				CHC_DEFAULT " Hits "       CHC_NUM_DEC "%u" CHC_DEFAULT "/" CHC_NUM_DEC "%u" CHC_DEFAULT " (%u%%)" CHC_ARG_SEP ","
+				CHC_DEFAULT " Read-ahead " CHC_NUM_DEC "%u" CHC_DEFAULT ", used " CHC_NUM_DEC "%u" CHC_DEFAULT " (%u%%)",
+				slot, drive + 1,
+				(UINT)stats.hits, (UINT)reads, reads ? (UINT)(stats.hits * 100 / reads) : 0,
+				(UINT)stats.readAheadBlocks, (UINT)stats.readAheadHits, stats.readAheadBlocks ? (UINT)(stats.readAheadHits * 100 / stats.readAheadBlocks) : 0
+			);
+			found = true;
+		}
+	}
+
+	if (!found)
+		ConsolePrintFormat("No hard disk images");
+
+	return ConsoleUpdate();
+}
+
 
 // Memory _________________________________________________________________________________________
 
@@ -4012,7 +4056,7 @@ Update_t CmdMemoryEnterByte (int nArgs)
 		{
 			*(mem + nAddress+nArgs-2)  = (BYTE)nData;
 		}
-		*(memdirty+(nAddress >> 8)) = 1;
+		MemSetDirty(nAddress);
 		nArgs--;
 	}
 
@@ -4038,7 +4082,7 @@ Update_t CmdMemoryEnterWord (int nArgs)
 		*(mem + nAddress + nArgs - 2)  = (BYTE)(nData >> 0);
 		*(mem + nAddress + nArgs - 1)  = (BYTE)(nData >> 8);
 
-		*(memdirty+(nAddress >> 8)) |= 1;
+		MemSetDirty(nAddress);
 		nArgs--;
 	}
 
@@ -4050,7 +4094,7 @@ void MemMarkDirty ( WORD nAddressStart, WORD nAddressEnd )
 {
 	for ( int iPage = (nAddressStart >> 8); iPage <= (nAddressEnd >> 8); iPage++ )
 	{
-		*(memdirty+iPage) = 1;
+		MemSetDirty(iPage << 8);
 	}
 }
 
@@ -4537,7 +4581,7 @@ Update_t CmdMemoryLoad (int nArgs)
 		{
 			for (WORD i=(nAddressStart>>8); i!=((nAddressStart+(WORD)nAddressLen)>>8); i++)
 			{
-				memdirty[i] = 0xff;
+				MemSetDirty(i << 8);
 			}
 		}
 	}
@@ -8486,6 +8530,7 @@ void DebugBegin ()
 	GetDebuggerMemDC();
 
 	g_nAppMode = MODE_DEBUG;
+	MemUpdatePagingByPointer();	// Debugger uses 'mem' directly
 	GetFrame().FrameRefreshStatus(DRAW_TITLE | DRAW_DISK_STATUS);
 
 	if (GetMainCpu() == CPU_6502)
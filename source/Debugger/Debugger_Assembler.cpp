@@ -1037,7 +1037,7 @@ int AssemblerPokeAddress( const int Opcode, const int nOpmode, const WORD nBaseA
 	// if (nOpbytes != nBytes)
 	//	ConsoleDisplayError( " ERROR: Input Opcode bytes differs from actual!" );
 
-	*(memdirty + (nBaseAddress >> 8)) |= 1;
+	MemSetDirty(nBaseAddress);
 //	*(mem + nBaseAddress) = (BYTE) nOpcode;
 
 	if (nOpbytes > 1)
@@ -1478,7 +1478,7 @@ void AssemblerProcessDelayedSymols()
 				if (bModified)
 				{
 					AssemblerPokeAddress( nOpcode, nOpmode, pTarget->m_nBaseAddress, nTargetValue );
-					*(memdirty + (pTarget->m_nBaseAddress >> 8)) |= 1;
+					MemSetDirty(pTarget->m_nBaseAddress);
 
 					m_vDelayedTargets.erase( iSymbol );
 
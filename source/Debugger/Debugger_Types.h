@@ -412,6 +412,7 @@
 		, CMD_DEFINE_ADDR_WORD    // .DA address symbol
 // Disk
 		, CMD_DISK
+		, CMD_HDD
 // Flags - CPU
 		, CMD_FLAG_CLEAR // Flag order must match g_aFlagNames CZIDBRVN
 		, CMD_FLAG_CLR_C // 8
@@ -697,6 +698,7 @@
 
 // Disk
 	Update_t CmdDisk               (int nArgs);
+	Update_t CmdHdd                (int nArgs);
 // Help
 	Update_t CmdHelpList           (int nArgs);
 	Update_t CmdHelpSpecific       (int Argss);
@@ -60,6 +60,25 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 // NB. Non-standard 4&4, with Vol=0x00 and Chk=0x00 (only a few match, eg. Wasteland, Legacy of the Ancients, Planetfall, Border Zone & Wizardry). [*1]
 const BYTE Disk2InterfaceCard::m_T00S00Pattern[] = {0xD5,0xAA,0x96,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xDE};
 
+// LSS read latch table for DataLatchReadBitCellsWOZ(), indexed by: [latchDelay code (2 bits) : shiftReg (8 bits) : 4 output bits]
+// . Entry: b7:0=shiftReg, b9:8=latchDelay code, b10=latch updated, b18:11=latch, b19=m_dbgLatchDelayedCnt reset, b22:20=m_dbgLatchDelayedCnt inc,
+//          b23=nibble read (ie. latch with b7 set), b31:24=nibble (at most one per 4 bit-cells)
+static const int g_latchDelayFromCode[4] = {0, 3, 4, 7};	// the only values that DataLatchReadWOZ() produces
+static UINT32 g_latchTableWOZ[4*256*16];
+static bool g_latchTableWOZInitialized = false;
+
+static int GetLatchDelayCode(const int latchDelay)
+{
+	switch (latchDelay)
+	{
+	case 0: return 0;
+	case 3: return 1;
+	case 4: return 2;
+	case 7: return 3;
+	}
+	return -1;	// eg. from an old save-state
+}
+
 Disk2InterfaceCard::Disk2InterfaceCard(UINT slot) :
 	Card(CT_Disk2, slot),
 	m_syncEvent(slot, 0, SyncEventCallback)	// use slot# as "unique" id for Disk2InterfaceCards
@@ -80,7 +99,14 @@ Disk2InterfaceCard::Disk2InterfaceCard(UINT slot) :
 	m_deferredStepperAddress = 0;
 	m_deferredStepperCumulativeCycles = 0;
 
+	memset(m_prefetchTrack, 0, sizeof(m_prefetchTrack));
+	m_hPrefetchThread = NULL;
+	m_hPrefetchEvent = NULL;
+	m_prefetchQuit = false;
+	InitializeCriticalSection(&m_prefetchCriticalSection);
+
 	ResetLogicStateSequencer();
+	InitLatchTableWOZ();
 
 	// Debug:
 #if LOG_DISK_NIBBLES_USE_RUNTIME_VAR
@@ -94,18 +120,26 @@ Disk2InterfaceCard::Disk2InterfaceCard(UINT slot) :
 
 Disk2InterfaceCard::~Disk2InterfaceCard(void)
 {
+	StopPrefetchThread();
+
 	EjectDiskInternal(DRIVE_1);
 	EjectDiskInternal(DRIVE_2);
 
+	for (UINT drive = DRIVE_1; drive < NUM_DRIVES; drive++)
+		for (UINT i = 0; i < NUM_PREFETCH_TRACKS; i++)
+			delete [] m_prefetchTrack[drive][i].trackimage;
+
+	DeleteCriticalSection(&m_prefetchCriticalSection);
+
 	if (m_syncEvent.m_active)
-		g_SynchronousEventMgr.Remove(m_syncEvent.m_id);
+		GetSynchronousEventMgr().Remove(m_syncEvent.m_id);
 }
 
 bool Disk2InterfaceCard::GetEnhanceDisk(void) { return m_enhanceDisk; }
 void Disk2InterfaceCard::SetEnhanceDisk(bool bEnhanceDisk) { m_enhanceDisk = bEnhanceDisk; }
 
 UINT   Disk2InterfaceCard::GetCurrentBitOffset  (void) { return m_floppyDrive[m_currDrive].m_disk.m_bitOffset; }
-double Disk2InterfaceCard::GetCurrentExtraCycles(void) { return m_floppyDrive[m_currDrive].m_disk.m_extraCycles; }
+double Disk2InterfaceCard::GetCurrentExtraCycles(void) { return m_floppyDrive[m_currDrive].m_disk.m_extraCycles8 / 8.0; }
 float  Disk2InterfaceCard::GetCurrentPhase      (void) { return m_floppyDrive[m_currDrive].m_phasePrecise; }
 int    Disk2InterfaceCard::GetCurrentDrive      (void) { return m_currDrive; }
 BYTE   Disk2InterfaceCard::GetCurrentShiftReg   (void) { return m_shiftReg; }
@@ -342,13 +376,19 @@ void Disk2InterfaceCard::ReadTrack(const int drive, ULONG uExecutedCycles)
 		const UINT32 currentBitPosition = pFloppy->m_bitOffset;
 		const UINT32 currentBitTrackLength = pFloppy->m_bitCount;
 
-		ImageReadTrack(
-			pFloppy->m_imagehandle,
-			pDrive->m_phasePrecise,
-			pFloppy->m_trackimage,
-			&pFloppy->m_nibbles,
-			&pFloppy->m_bitCount,
-			m_enhanceDisk);
+		const bool prefetched = GetPrefetchedTrack(drive);
+		if (!prefetched)
+		{
+			GetCardMgr().GetDisk2CardMgr().LockTrackIO();
+			ImageReadTrack(
+				pFloppy->m_imagehandle,
+				pDrive->m_phasePrecise,
+				pFloppy->m_trackimage,
+				&pFloppy->m_nibbles,
+				&pFloppy->m_bitCount,
+				m_enhanceDisk);
+			GetCardMgr().GetDisk2CardMgr().UnlockTrackIO();
+		}
 
 		if (!ImageIsWOZ(pFloppy->m_imagehandle))
 		{
@@ -381,10 +421,11 @@ void Disk2InterfaceCard::ReadTrack(const int drive, ULONG uExecutedCycles)
 			pFloppy->m_byte = pFloppy->m_bitOffset / 8;
 			pFloppy->m_bitMask = 1 << (7 - (pFloppy->m_bitOffset % 8));
 
-			pFloppy->m_extraCycles = 0.0;
+			pFloppy->m_extraCycles8 = 0;
 			pDrive->m_headWindow = 0;
 
-			FindTrackSeamWOZ(*pFloppy, pDrive->m_phasePrecise/2);
+			if (!prefetched)	// else track seam already found by the prefetch thread
+				FindTrackSeamWOZ(*pFloppy, pDrive->m_phasePrecise/2);
 		}
 
 		pFloppy->m_trackimagedata = (pFloppy->m_nibbles != 0);
@@ -419,8 +460,11 @@ bool Disk2InterfaceCard::EjectDiskInternal(const int drive)
 #endif
 		FlushCurrentTrack(drive);
 
+		GetCardMgr().GetDisk2CardMgr().LockTrackIO();
+		InvalidatePrefetch(drive);
 		ImageClose(pFloppy->m_imagehandle);
 		pFloppy->m_imagehandle = NULL;
+		GetCardMgr().GetDisk2CardMgr().UnlockTrackIO();
 	}
 
 	if (pFloppy->m_trackimage)
@@ -492,11 +536,14 @@ void Disk2InterfaceCard::WriteTrack(const int drive)
 #if LOG_DISK_TRACKS
 		LOG_DISK("track $%s write\r\n", GetCurrentTrackString().c_str());
 #endif
+		GetCardMgr().GetDisk2CardMgr().LockTrackIO();
+		InvalidatePrefetch(drive);	// a prefetched track may be stale now
 		ImageWriteTrack(
 			pFloppy->m_imagehandle,
 			pDrive->m_phasePrecise,
 			pFloppy->m_trackimage,
 			pFloppy->m_nibbles);
+		GetCardMgr().GetDisk2CardMgr().UnlockTrackIO();
 	}
 
 	pFloppy->m_trackimagedirty = false;
@@ -512,6 +559,35 @@ void Disk2InterfaceCard::FlushCurrentTrack(const int drive)
 
 //===========================================================================
 
+// Accelerated disk: read decoded sectors straight from a DO/PO image (see Disk2CardManager::AcceleratedEntrypoint())
+// . NB. the head isn't moved and the motor isn't turned on
+bool Disk2InterfaceCard::AcceleratedReadSectors(const int drive, const UINT track, const BYTE* pPhysicalSectors, const UINT numSectors, LPBYTE pBuffer, BYTE& volume)
+{
+	if (!IsDriveValid(drive) || !m_floppyDrive[drive].m_isConnected)
+		return false;
+
+	FloppyDisk* pFloppy = &m_floppyDrive[drive].m_disk;
+	if (!pFloppy->m_imagehandle)
+		return false;
+
+	FlushCurrentTrack(drive);	// image needs any nibble-level writes to the current track
+
+	GetCardMgr().GetDisk2CardMgr().LockTrackIO();
+
+	bool res = true;
+	for (UINT i = 0; i < numSectors && res; i++)
+		res = ImageReadSector(pFloppy->m_imagehandle, track, pPhysicalSectors[i], pBuffer + i * 256);
+
+	if (res)
+		volume = ImageGetVolumeNumber(pFloppy->m_imagehandle);
+
+	GetCardMgr().GetDisk2CardMgr().UnlockTrackIO();
+
+	return res;
+}
+
+//===========================================================================
+
 void Disk2InterfaceCard::Boot(void)
 {
 	// THIS FUNCTION RELOADS A PROGRAM IMAGE IF ONE IS LOADED IN DRIVE ONE.
@@ -596,7 +672,7 @@ void __stdcall Disk2InterfaceCard::ControlStepper(WORD, WORD address, BYTE, BYTE
 	if (m_syncEvent.m_active)
 	{
 		// Check for adjacent magnets being turned off/on in a very short interval (10 cycles is purely based on A2osX). (GH#1110)
-		g_SynchronousEventMgr.Remove(m_syncEvent.m_id);
+		GetSynchronousEventMgr().Remove(m_syncEvent.m_id);
 		m_deferredStepperEvent = false;
 
 		int addrDelta = (m_deferredStepperAddress & 7) - (address & 7);
@@ -635,7 +711,7 @@ void __stdcall Disk2InterfaceCard::ControlStepper(WORD, WORD address, BYTE, BYTE
 void Disk2InterfaceCard::InsertSyncEvent(void)
 {
 	m_syncEvent.m_cyclesRemaining = 10;	// NB. same cycle delay for magnet off and on - but perhaps they take different times?
-	g_SynchronousEventMgr.Insert(&m_syncEvent);
+	GetSynchronousEventMgr().Insert(&m_syncEvent);
 }
 
 int Disk2InterfaceCard::SyncEventCallback(int id, int cycles, ULONG uExecutedCycles)
@@ -687,11 +763,15 @@ void Disk2InterfaceCard::ControlStepperDeferred(void)
 	// apply magnet step, if any
 	if (newPhasePrecise != pDrive->m_phasePrecise)
 	{
+		const int stepDirection = (newPhasePrecise > pDrive->m_phasePrecise) ? 1 : -1;
 		FlushCurrentTrack(m_currDrive);
 		pDrive->m_phasePrecise = newPhasePrecise;
 		pFloppy->m_trackimagedata = false;
 		m_formatTrack.DriveNotWritingTrack();
 		GetFrame().FrameDrawDiskStatus();	// Show track status (GH#201)
+
+		if (GetCardMgr().GetDisk2CardMgr().IsTrackPrefetch())
+			RequestPrefetch(m_currDrive, stepDirection);
 	}
 
 	ControlStepperLogging(address, m_deferredStepperCumulativeCycles);
@@ -723,6 +803,289 @@ void Disk2InterfaceCard::ControlStepperLogging(WORD address, unsigned __int64 cu
 
 //===========================================================================
 
+// Track prefetch:
+// . Called after a head step: queue the next NUM_PREFETCH_TRACKS tracks in the step direction
+// . WOZ steps in half phases (ie. quarter tracks), other image types in whole phases
+void Disk2InterfaceCard::RequestPrefetch(const int drive, const int direction)
+{
+	FloppyDrive* pDrive = &m_floppyDrive[drive];
+	ImageInfo* imagehandle = pDrive->m_disk.m_imagehandle;
+	if (!imagehandle)
+		return;
+
+	const float phaseStep = ImageIsWOZ(imagehandle) ? 0.5f : 1.0f;
+	const UINT numTracks = ImageGetNumTracks(imagehandle);
+
+	float wantedPhase[NUM_PREFETCH_TRACKS];
+	UINT numWanted = 0;
+	for (UINT i = 0; i < NUM_PREFETCH_TRACKS; i++)
+	{
+		const float phase = pDrive->m_phasePrecise + (float)direction * phaseStep * (float)(i + 1);
+		if (phase < 0 || ImagePhaseToTrack(imagehandle, phase, false) >= numTracks)
+			break;
+		wantedPhase[numWanted++] = phase;
+	}
+
+	if (numWanted == 0)
+		return;
+
+	EnterCriticalSection(&m_prefetchCriticalSection);
+
+	// Keep any slot that's already for a wanted track, and re-use the rest
+	bool keep[NUM_PREFETCH_TRACKS] = {false};
+	bool covered[NUM_PREFETCH_TRACKS] = {false};
+	for (UINT i = 0; i < NUM_PREFETCH_TRACKS; i++)
+	{
+		PrefetchTrack& slot = m_prefetchTrack[drive][i];
+		if (slot.state == PrefetchTrack::eEmpty || slot.imagehandle != imagehandle || slot.enhanceDisk != m_enhanceDisk)
+			continue;
+
+		for (UINT w = 0; w < numWanted; w++)
+		{
+			if (!covered[w] && slot.phasePrecise == wantedPhase[w])
+			{
+				keep[i] = covered[w] = true;
+				break;
+			}
+		}
+	}
+
+	const UINT trackimageSize = MAX(NIBBLES_PER_TRACK, ImageGetMaxNibblesPerTrack(imagehandle));
+	bool newRequest = false;
+
+	for (UINT w = 0, i = 0; w < numWanted; w++)
+	{
+		if (covered[w])
+			continue;
+
+		while (keep[i])
+			i++;
+
+		PrefetchTrack& slot = m_prefetchTrack[drive][i];
+		if (slot.trackimageSize < trackimageSize)
+		{
+			delete [] slot.trackimage;
+			slot.trackimage = new BYTE[trackimageSize];
+			slot.trackimageSize = trackimageSize;
+		}
+
+		slot.state = PrefetchTrack::ePending;
+		slot.imagehandle = imagehandle;
+		slot.phasePrecise = wantedPhase[w];
+		slot.enhanceDisk = m_enhanceDisk;
+		keep[i] = true;
+		newRequest = true;
+	}
+
+	LeaveCriticalSection(&m_prefetchCriticalSection);
+
+	if (!newRequest)
+		return;
+
+	if (!m_hPrefetchThread)
+	{
+		m_prefetchQuit = false;
+		m_hPrefetchEvent = CreateEvent(NULL, FALSE, FALSE, NULL);	// auto-reset
+		if (m_hPrefetchEvent)
+			m_hPrefetchThread = CreateThread(NULL, 0, PrefetchThread, this, 0, NULL);
+
+		if (!m_hPrefetchThread)
+		{
+			// Can't prefetch, so just fall back to synchronous reads
+			if (m_hPrefetchEvent)
+				CloseHandle(m_hPrefetchEvent);
+			m_hPrefetchEvent = NULL;
+			GetCardMgr().GetDisk2CardMgr().SetTrackPrefetch(false);
+			return;
+		}
+	}
+
+	SetEvent(m_hPrefetchEvent);
+}
+
+// If the drive's current track has been prefetched, then copy it to the drive's track buffer
+bool Disk2InterfaceCard::GetPrefetchedTrack(const int drive)
+{
+	FloppyDrive* pDrive = &m_floppyDrive[drive];
+	FloppyDisk* pFloppy = &pDrive->m_disk;
+
+	EnterCriticalSection(&m_prefetchCriticalSection);
+
+	bool res = false;
+	for (UINT i = 0; i < NUM_PREFETCH_TRACKS; i++)
+	{
+		PrefetchTrack& slot = m_prefetchTrack[drive][i];
+		if (slot.state != PrefetchTrack::eReady
+			|| slot.imagehandle != pFloppy->m_imagehandle
+			|| slot.phasePrecise != pDrive->m_phasePrecise
+			|| slot.enhanceDisk != m_enhanceDisk)
+			continue;
+
+		slot.state = PrefetchTrack::eEmpty;
+
+		if (slot.nibbles == 0 || slot.bitCount == 0)
+			break;	// let ReadTrack() deal with this
+
+		// NB. copy (not swap) the track, as the drive's track buffer may be larger (eg. after LoadSnapshot())
+		memcpy(pFloppy->m_trackimage, slot.trackimage, slot.nibbles);
+		pFloppy->m_nibbles = slot.nibbles;
+		pFloppy->m_bitCount = slot.bitCount;
+
+		// Same as FindTrackSeamWOZ()
+		pFloppy->m_longestSyncFFBitOffsetStart = slot.longestSyncFFBitOffsetStart;
+		if (slot.longestSyncFFBitOffsetStart >= 0)
+			pFloppy->m_longestSyncFFRunLength = slot.longestSyncFFRunLength;
+
+		res = true;
+		break;
+	}
+
+	LeaveCriticalSection(&m_prefetchCriticalSection);
+
+	return res;
+}
+
+// Pre: LockTrackIO() - so that a track being read by the prefetch thread is never published after this
+void Disk2InterfaceCard::InvalidatePrefetch(const int drive)
+{
+	EnterCriticalSection(&m_prefetchCriticalSection);
+
+	for (UINT i = 0; i < NUM_PREFETCH_TRACKS; i++)
+		m_prefetchTrack[drive][i].state = PrefetchTrack::eEmpty;
+
+	LeaveCriticalSection(&m_prefetchCriticalSection);
+}
+
+// Prefetch thread: read one pending track
+// . the track is read (and its WOZ track seam found) into m_prefetchBuffer, and the slot lock is only taken to claim & publish
+// . returns false when there's nothing (more) to do
+bool Disk2InterfaceCard::PrefetchNextTrack(void)
+{
+	EnterCriticalSection(&m_prefetchCriticalSection);
+
+	PrefetchTrack* pSlot = NULL;
+	for (UINT drive = DRIVE_1; drive < NUM_DRIVES && !pSlot; drive++)
+	{
+		for (UINT i = 0; i < NUM_PREFETCH_TRACKS; i++)
+		{
+			if (m_prefetchTrack[drive][i].state == PrefetchTrack::ePending)
+			{
+				pSlot = &m_prefetchTrack[drive][i];
+				break;
+			}
+		}
+	}
+
+	if (!pSlot || m_prefetchQuit)
+	{
+		LeaveCriticalSection(&m_prefetchCriticalSection);
+		return false;
+	}
+
+	pSlot->state = PrefetchTrack::eReading;
+	ImageInfo* const imagehandle = pSlot->imagehandle;
+	const float phasePrecise = pSlot->phasePrecise;
+	const bool enhanceDisk = pSlot->enhanceDisk;
+	if (m_prefetchBuffer.size() < pSlot->trackimageSize)
+		m_prefetchBuffer.resize(pSlot->trackimageSize);
+
+	LeaveCriticalSection(&m_prefetchCriticalSection);
+
+	//
+
+	int nibbles = 0;
+	UINT bitCount = 0;
+	bool isWOZ = false;
+
+	GetCardMgr().GetDisk2CardMgr().LockTrackIO();
+
+	// Check that the slot wasn't invalidated (eg. by an eject) before the lock was taken, since the image may now be closed
+	EnterCriticalSection(&m_prefetchCriticalSection);
+	const bool valid = pSlot->state == PrefetchTrack::eReading;
+	LeaveCriticalSection(&m_prefetchCriticalSection);
+
+	if (valid)
+	{
+		ImageReadTrack(imagehandle, phasePrecise, &m_prefetchBuffer[0], &nibbles, &bitCount, enhanceDisk);
+		isWOZ = ImageIsWOZ(imagehandle);
+	}
+
+	GetCardMgr().GetDisk2CardMgr().UnlockTrackIO();
+
+	if (!valid)
+		return !m_prefetchQuit;
+
+	int longestSyncFFBitOffsetStart = -1;
+	UINT longestSyncFFRunLength = 0;
+
+	if (isWOZ && nibbles && bitCount)
+	{
+		// FindTrackSeamWOZ() only uses the floppy's bitstream, so find the seam using a temporary floppy
+		FloppyDisk floppy;
+		floppy.m_trackimage = &m_prefetchBuffer[0];
+		floppy.m_nibbles = nibbles;
+		floppy.m_bitCount = bitCount;
+		FindTrackSeamWOZ(floppy, phasePrecise/2);
+		floppy.m_trackimage = NULL;
+
+		longestSyncFFBitOffsetStart = floppy.m_longestSyncFFBitOffsetStart;
+		longestSyncFFRunLength = floppy.m_longestSyncFFRunLength;
+	}
+
+	//
+
+	EnterCriticalSection(&m_prefetchCriticalSection);
+
+	// Only publish if the slot is still for this request (ie. it wasn't invalidated or re-used while reading)
+	if (pSlot->state == PrefetchTrack::eReading && (UINT)nibbles <= pSlot->trackimageSize)
+	{
+		memcpy(pSlot->trackimage, &m_prefetchBuffer[0], nibbles);
+		pSlot->nibbles = nibbles;
+		pSlot->bitCount = bitCount;
+		pSlot->longestSyncFFBitOffsetStart = longestSyncFFBitOffsetStart;
+		pSlot->longestSyncFFRunLength = longestSyncFFRunLength;
+		pSlot->state = PrefetchTrack::eReady;
+	}
+
+	LeaveCriticalSection(&m_prefetchCriticalSection);
+
+	return !m_prefetchQuit;
+}
+
+DWORD WINAPI Disk2InterfaceCard::PrefetchThread(LPVOID lpParameter)
+{
+	Disk2InterfaceCard* pCard = (Disk2InterfaceCard*) lpParameter;
+
+	while (true)
+	{
+		WaitForSingleObject(pCard->m_hPrefetchEvent, INFINITE);
+		if (pCard->m_prefetchQuit)
+			break;
+
+		while (pCard->PrefetchNextTrack())
+			;
+	}
+
+	return 0;
+}
+
+void Disk2InterfaceCard::StopPrefetchThread(void)
+{
+	if (!m_hPrefetchThread)
+		return;
+
+	m_prefetchQuit = true;
+	SetEvent(m_hPrefetchEvent);
+	WaitForSingleObject(m_hPrefetchThread, INFINITE);
+
+	CloseHandle(m_hPrefetchThread);
+	CloseHandle(m_hPrefetchEvent);
+	m_hPrefetchThread = NULL;
+	m_hPrefetchEvent = NULL;
+}
+
+//===========================================================================
+
 void Disk2InterfaceCard::Destroy(void)
 {
 	m_saveDiskImage = false;
@@ -878,7 +1241,7 @@ ImageError_e Disk2InterfaceCard::InsertDisk(const int drive, const std::string&
 	if (dwAttributes == INVALID_FILE_ATTRIBUTES)
 		pFloppy->m_bWriteProtected = false;	// Assume this is a new file to create (so it must be write-enabled to allow it to be formatted)
 	else
-		pFloppy->m_bWriteProtected = bForceWriteProtected ? true : (dwAttributes & FILE_ATTRIBUTE_READONLY);
+		pFloppy->m_bWriteProtected = bForceWriteProtected ? true : ((dwAttributes & FILE_ATTRIBUTE_READONLY) && !ImageIsOverlayEnabled());	// overlay: a read-only base image is fine
 
 	// Check if image is being used by the other drive, and if so remove it in order so it can be swapped
 	{
@@ -1240,30 +1603,22 @@ UINT Disk2InterfaceCard::GetBitCellDelta(const ULONG uExecutedCycles)
 {
 	FloppyDisk& floppy = m_floppyDrive[m_currDrive].m_disk;
 
-	const BYTE optimalBitTiming = ImageGetOptimalBitTiming(floppy.m_imagehandle);
+	// optimalBitTiming is the bit-cell time in 125ns (ie. 1/8 cycle) units, so use integer arithmetic in these units
+	// . this is exact for all optimalBitTiming values (and so is deterministic across compilers & platforms)
+	BYTE optimalBitTiming = ImageGetOptimalBitTiming(floppy.m_imagehandle);
+	_ASSERT(optimalBitTiming);
+	if (!optimalBitTiming)
+		optimalBitTiming = 32;	// 4us
 
-	// NB. m_extraCycles is needed to retain accuracy:
+	// NB. m_extraCycles8 is needed to retain accuracy (eg. for 4us bit-cells):
 	// . Read latch #1: 0-> 9: cycleDelta= 9, bitCellDelta=2, extraCycles=1
 	// . Read latch #2: 9->20: cycleDelta=11, bitCellDelta=2, extraCycles=3
 	// . Overall:       0->20: cycleDelta=20, bitCellDelta=5, extraCycles=0
-	UINT bitCellDelta;
-#if 0
-	if (optimalBitTiming == 32)
-	{
-		const ULONG cycleDelta = (ULONG)(g_nCumulativeCycles - m_diskLastCycle) + (BYTE) floppy.m_extraCycles;
-		bitCellDelta = cycleDelta / 4;	// DIV 4 for 4us per bit-cell
-		floppy.m_extraCycles = cycleDelta & 3;	// MOD 4 : remainder carried forward for next time
-	}
-	else
-#endif
-	{
-		const double cycleDelta = (double)(g_nCumulativeCycles - m_diskLastCycle) + floppy.m_extraCycles;
-		const double bitTime = 0.125 * (double)optimalBitTiming;	// 125ns units
-		bitCellDelta = (UINT) floor( cycleDelta / bitTime );
-		floppy.m_extraCycles = (double)cycleDelta - ((double)bitCellDelta * bitTime);
-	}
+	const UINT64 cycleDelta8 = ((UINT64)(g_nCumulativeCycles - m_diskLastCycle) << 3) + floppy.m_extraCycles8;
+	const UINT bitCellDelta = (UINT)(cycleDelta8 / optimalBitTiming);
+	floppy.m_extraCycles8 = (UINT)(cycleDelta8 % optimalBitTiming);	// remainder carried forward for next time
 
-	// NB. actual m_diskLastCycle for the last bitCell is minus floppy.m_extraCycles
+	// NB. actual m_diskLastCycle for the last bitCell is minus floppy.m_extraCycles8
 	// - but don't need this value; and it's correctly accounted for in this function.
 	m_diskLastCycle = g_nCumulativeCycles;
 
@@ -1310,6 +1665,18 @@ __forceinline void Disk2InterfaceCard::IncBitStream(FloppyDisk& floppy)
 		floppy.m_revs++;
 }
 
+// ~30% chance of a 1 bit (Ref: WOZ-2.0)
+// . xorshift32 rather than rand(), as weak bit runs can be long and this is called per bit-cell
+__forceinline BYTE Disk2InterfaceCard::GetWeakBit(FloppyDrive& drive)
+{
+	UINT32 x = drive.m_weakBitRand;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	drive.m_weakBitRand = x;
+	return (x < (0xFFFFFFFF / 10) * 3) ? 1 : 0;
+}
+
 void Disk2InterfaceCard::PreJitterCheck(int phase, BYTE latch)
 {
 	if (phase != 0 || (latch & 0x80) == 0)
@@ -1470,14 +1837,30 @@ void Disk2InterfaceCard::DataLatchReadWOZ(WORD pc, WORD addr, UINT bitCellRemain
 	}
 #endif
 
-	for (UINT i = 0; i < bitCellRemainder; i++)
+	UINT i = 0;
+	while (i < bitCellRemainder)
 	{
+#if !(LOG_DISK_ENABLED && LOG_DISK_NIBBLES_READ)	// the nibble log needs the per bit-cell loop
+		// Fast path: consume runs of bit-cells 4 at a time, up to the next bit-cell that needs IncBitStream() or AddTrackSeamJitter() housekeeping
+		if (GetLatchDelayCode(m_latchDelay) >= 0)
+		{
+			const UINT bitCells = MIN(bitCellRemainder - i, GetBitCellsToNextEventWOZ(drive, floppy)) & ~3;
+			if (bitCells)
+			{
+				DataLatchReadBitCellsWOZ(drive, floppy, bitCells);
+				i += bitCells;
+				continue;
+			}
+		}
+#endif
+		i++;
+
 		BYTE n = floppy.m_trackimage[floppy.m_byte];
 
 		drive.m_headWindow <<= 1;
 		drive.m_headWindow |= (n & floppy.m_bitMask) ? 1 : 0;
 		BYTE outputBit = (drive.m_headWindow & 0xf)	? (drive.m_headWindow >> 1) & 1
-													: (rand() < RAND_THRESHOLD(3, 10)) ? 1 : 0;	// ~30% chance of a 1 bit (Ref: WOZ-2.0)
+													: GetWeakBit(drive);
 
 		IncBitStream(floppy);
 
@@ -1547,6 +1930,163 @@ void Disk2InterfaceCard::DataLatchReadWOZ(WORD pc, WORD addr, UINT bitCellRemain
 #endif
 }
 
+// Build the LSS read latch table by running the per bit-cell logic of DataLatchReadWOZ() for each {latchDelay, shiftReg, 4 output bits}
+void Disk2InterfaceCard::InitLatchTableWOZ(void)
+{
+	if (g_latchTableWOZInitialized)
+		return;
+
+	for (UINT delayCode = 0; delayCode < 4; delayCode++)
+	{
+		for (UINT shift = 0; shift < 256; shift++)
+		{
+			for (UINT outputBits = 0; outputBits < 16; outputBits++)
+			{
+				BYTE shiftReg = (BYTE)shift;
+				int latchDelay = g_latchDelayFromCode[delayCode];
+				bool latchUpdated = false;
+				BYTE latch = 0;
+				bool dbgReset = false;
+				UINT dbgInc = 0;
+				bool nibbleRead = false;
+				BYTE nibble = 0;
+
+				for (int b = 3; b >= 0; b--)
+				{
+					shiftReg <<= 1;
+					shiftReg |= (outputBits >> b) & 1;
+
+					if (latchDelay)
+					{
+						latchDelay -= 4;
+						if (latchDelay < 0)
+							latchDelay = 0;
+
+						if (shiftReg)
+						{
+							dbgReset = true;
+							dbgInc = 0;
+						}
+						else
+						{
+							latchDelay += 4;
+							dbgInc++;
+						}
+					}
+
+					if (!latchDelay)
+					{
+						latchUpdated = true;
+						latch = shiftReg;
+
+						if (shiftReg & 0x80)
+						{
+							_ASSERT(!nibbleRead);
+							nibbleRead = true;
+							nibble = shiftReg;
+							latchDelay = 7;
+							shiftReg = 0;
+						}
+					}
+				}
+
+				const int newDelayCode = GetLatchDelayCode(latchDelay);
+				_ASSERT(newDelayCode >= 0);
+
+				g_latchTableWOZ[(delayCode << 12) | (shift << 4) | outputBits] =
+					shiftReg | (newDelayCode << 8) | (latchUpdated ? (1 << 10) : 0) | (latch << 11) | (dbgReset ? (1 << 19) : 0) | (dbgInc << 20) |
+					(nibbleRead ? (1 << 23) : 0) | ((UINT32)nibble << 24);
+			}
+		}
+	}
+
+	g_latchTableWOZInitialized = true;
+}
+
+// Number of bit-cells that can be consumed before a bit-cell that (after IncBitStream()) wraps the track, bumps m_revs or hits the track seam jitter point
+UINT Disk2InterfaceCard::GetBitCellsToNextEventWOZ(FloppyDrive& drive, FloppyDisk& floppy)
+{
+	if (floppy.m_bitOffset >= floppy.m_bitCount)
+		return 0;
+
+	UINT bitCells = floppy.m_bitCount - 1 - floppy.m_bitOffset;
+
+	if (floppy.m_initialBitOffset > floppy.m_bitOffset)
+		bitCells = MIN(bitCells, floppy.m_initialBitOffset - 1 - floppy.m_bitOffset);
+
+	// Same condition as AddTrackSeamJitter()
+	if (drive.m_phasePrecise >= (33.0 * 2) && floppy.m_longestSyncFFRunLength > 110)
+	{
+		const int seamBitOffset = floppy.m_longestSyncFFBitOffsetStart;
+		if (seamBitOffset > (int)floppy.m_bitOffset)
+			bitCells = MIN(bitCells, (UINT)seamBitOffset - 1 - floppy.m_bitOffset);
+	}
+
+	return bitCells;
+}
+
+// Equivalent to running 'bitCells' iterations of DataLatchReadWOZ()'s loop, but a nibble (4 bit-cells) at a time:
+// . the head window, weak bits and output bits are all computed for 4 bit-cells at once
+// . the LSS read latch is advanced by a single g_latchTableWOZ[] lookup
+// Pre: bitCells is a multiple of 4 and <= GetBitCellsToNextEventWOZ()
+void Disk2InterfaceCard::DataLatchReadBitCellsWOZ(FloppyDrive& drive, FloppyDisk& floppy, const UINT bitCells)
+{
+	_ASSERT((bitCells & 3) == 0 && bitCells <= GetBitCellsToNextEventWOZ(drive, floppy));
+
+	const BYTE* pTrack = floppy.m_trackimage;
+	UINT byteIdx = floppy.m_bitOffset / 8;
+	UINT32 bitAcc = pTrack[byteIdx++];
+	UINT bitsInAcc = 8 - (floppy.m_bitOffset & 7);
+	UINT headWindow = drive.m_headWindow;
+	UINT state = (GetLatchDelayCode(m_latchDelay) << 8) | m_shiftReg;
+
+	for (UINT i = 0; i < bitCells; i += 4)
+	{
+		if (bitsInAcc < 4)
+		{
+			bitAcc = (bitAcc << 8) | pTrack[byteIdx++];	// NB. only reads a byte that holds some of these 4 bit-cells
+			bitsInAcc += 8;
+		}
+		bitsInAcc -= 4;
+
+		headWindow = ((headWindow << 4) | ((bitAcc >> bitsInAcc) & 0xf)) & 0xff;
+
+		// Each output bit is the previous bit-cell, unless the 4 bit-cell head window is all zeros (ie. a weak bit)
+		UINT outputBits = (headWindow >> 1) & 0xf;
+		const UINT weakBits = ~(headWindow | (headWindow >> 1) | (headWindow >> 2) | (headWindow >> 3)) & 0xf;
+		if (weakBits)
+		{
+			for (int b = 3; b >= 0; b--)
+			{
+				if (weakBits & (1 << b))
+					outputBits = (outputBits & ~(1 << b)) | (GetWeakBit(drive) << b);
+			}
+		}
+
+		const UINT32 entry = g_latchTableWOZ[(state << 4) | outputBits];
+		state = entry & 0x3ff;
+
+		if (entry & (1 << 10))
+			m_floppyLatch = (BYTE)(entry >> 11);
+
+#if LOG_DISK_NIBBLES_READ
+		if (entry & (1 << 23))
+			m_formatTrack.DecodeLatchNibbleRead((BYTE)(entry >> 24));
+#endif
+
+		if (entry & (1 << 19))
+			m_dbgLatchDelayedCnt = 0;
+		m_dbgLatchDelayedCnt += (entry >> 20) & 7;
+	}
+
+	m_shiftReg = (BYTE)state;
+	m_latchDelay = g_latchDelayFromCode[state >> 8];
+	drive.m_headWindow = (BYTE)headWindow;
+
+	floppy.m_bitOffset += bitCells;
+	UpdateBitStreamOffsets(floppy);
+}
+
 void Disk2InterfaceCard::DataLoadWriteWOZ(WORD pc, WORD addr, UINT bitCellRemainder)
 {
 	_ASSERT(m_seqFunc.function == dataLoadWrite);
@@ -2025,6 +2565,10 @@ void Disk2InterfaceCard::Update(const ULONG cycles)
 				GetFrame().FrameDrawDiskStatus();
 			}
 		}
+
+		// Once the drive has stopped, write back any gzip/zip image that's been idle for a while
+		if (!pDrive->m_spinning && pDrive->m_disk.m_imagehandle)
+			ImageFlush(pDrive->m_disk.m_imagehandle, true);
 	}
 }
 
@@ -2331,7 +2875,7 @@ void Disk2InterfaceCard::SaveSnapshotFloppy(YamlSaveHelper& yamlSaveHelper, UINT
 	yamlSaveHelper.SaveHexUint16(SS_YAML_KEY_NIBBLES, m_floppyDrive[unit].m_disk.m_nibbles);
 	yamlSaveHelper.SaveHexUint32(SS_YAML_KEY_BIT_OFFSET, m_floppyDrive[unit].m_disk.m_bitOffset);	// v4
 	yamlSaveHelper.SaveHexUint32(SS_YAML_KEY_BIT_COUNT, m_floppyDrive[unit].m_disk.m_bitCount);		// v4
-	yamlSaveHelper.SaveDouble(SS_YAML_KEY_EXTRA_CYCLES, m_floppyDrive[unit].m_disk.m_extraCycles);	// v4
+	yamlSaveHelper.SaveDouble(SS_YAML_KEY_EXTRA_CYCLES, m_floppyDrive[unit].m_disk.m_extraCycles8 / 8.0);	// v4
 	yamlSaveHelper.SaveBool(SS_YAML_KEY_WRITE_PROTECTED, m_floppyDrive[unit].m_disk.m_bWriteProtected);
 	yamlSaveHelper.SaveUint(SS_YAML_KEY_TRACK_IMAGE_DATA, m_floppyDrive[unit].m_disk.m_trackimagedata);
 	yamlSaveHelper.SaveUint(SS_YAML_KEY_TRACK_IMAGE_DIRTY, m_floppyDrive[unit].m_disk.m_trackimagedirty);
@@ -2390,7 +2934,29 @@ bool Disk2InterfaceCard::LoadSnapshotFloppy(YamlLoadHelper& yamlLoadHelper, UINT
 	std::string filename = simpleFilename;
 	bool bImageError = filename.empty();
 
-	if (!bImageError)
+	FloppyDisk& floppy = m_floppyDrive[unit].m_disk;
+	const bool keepImage = yamlLoadHelper.IsLoadingFromMemory() && !bImageError && floppy.m_imagehandle
+							&& absolutePath == ImageGetPathname(floppy.m_imagehandle);
+
+	if (keepImage)
+	{
+		// In-place (eg. rewind) and it's the same image: keep it open, but reset the rest of the disk's state (as InsertDisk() would)
+		const FloppyDisk keptDisk = floppy;
+		floppy.clear();
+		floppy.m_imagename = keptDisk.m_imagename;
+		floppy.m_fullname = keptDisk.m_fullname;
+		floppy.m_fullpath = keptDisk.m_fullpath;
+		floppy.m_strFilenameInZip = keptDisk.m_strFilenameInZip;
+		floppy.m_imagehandle = keptDisk.m_imagehandle;
+		floppy.m_bWriteProtected = keptDisk.m_bWriteProtected;
+		floppy.m_trackimage = keptDisk.m_trackimage;
+	}
+	else if (floppy.m_imagehandle)
+	{
+		EjectDisk(unit);	// In-place, but a different image (or none)
+	}
+
+	if (!bImageError && !keepImage)
 	{
 		DWORD dwAttributes = GetFileAttributes(filename.c_str());
 		if (dwAttributes == INVALID_FILE_ATTRIBUTES && !absolutePath.empty())
@@ -2433,7 +2999,9 @@ bool Disk2InterfaceCard::LoadSnapshotFloppy(YamlLoadHelper& yamlLoadHelper, UINT
 	{
 		m_floppyDrive[unit].m_disk.m_bitOffset = yamlLoadHelper.LoadUint(SS_YAML_KEY_BIT_OFFSET);
 		m_floppyDrive[unit].m_disk.m_bitCount = yamlLoadHelper.LoadUint(SS_YAML_KEY_BIT_COUNT);
-		m_floppyDrive[unit].m_disk.m_extraCycles = yamlLoadHelper.LoadDouble(SS_YAML_KEY_EXTRA_CYCLES);
+		// Persisted as a double number of cycles (always a multiple of 1/8 cycle), so round to the nearest 1/8 cycle
+		const double extraCycles = yamlLoadHelper.LoadDouble(SS_YAML_KEY_EXTRA_CYCLES);
+		m_floppyDrive[unit].m_disk.m_extraCycles8 = (extraCycles > 0.0) ? (UINT)floor(extraCycles * 8.0 + 0.5) : 0;
 
 		if (m_floppyDrive[unit].m_disk.m_bitCount && (m_floppyDrive[unit].m_disk.m_bitOffset >= m_floppyDrive[unit].m_disk.m_bitCount))
 			throw std::runtime_error("Disk image: bitOffset >= bitCount");
@@ -2592,9 +3160,23 @@ bool Disk2InterfaceCard::LoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT versi
 		m_deferredStepperCumulativeCycles = yamlLoadHelper.LoadUint64(SS_YAML_KEY_DEFERRED_STEPPER_CYCLE);
 	}
 
+	if (m_syncEvent.m_active)	// In-place: this card was already running
+		GetSynchronousEventMgr().Remove(m_syncEvent.m_id);
+
 	// Eject all disks first in case Drive-2 contains disk to be inserted into Drive-1
+	// . except in-place (eg. rewind): LoadSnapshotFloppy() keeps a disk that's still in the same drive
 	for (UINT i=0; i<NUM_DRIVES; i++)
 	{
+		if (yamlLoadHelper.IsLoadingFromMemory())
+		{
+			FlushCurrentTrack(i);	// As EjectDisk() would
+
+			const FloppyDisk disk = m_floppyDrive[i].m_disk;
+			m_floppyDrive[i].clear();
+			m_floppyDrive[i].m_disk = disk;
+			continue;
+		}
+
 		// Remove any disk & update Registry to reflect empty drive
 		if (!EjectDisk(i))
 			return false;
@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 */
 
 #include <vector>
+#include <atomic>
 #include "Card.h"
 #include "Log.h"
 #include "DiskLog.h"
@@ -67,7 +68,7 @@ public:
 		m_bitOffset = 0;
 		m_bitCount = 0;
 		m_bitMask = 1 << 7;
-		m_extraCycles = 0.0;
+		m_extraCycles8 = 0;
 		m_trackimage = NULL;
 		m_trackimagedata = false;
 		m_trackimagedirty = false;
@@ -89,7 +90,7 @@ public:
 	UINT m_bitOffset;			// bit offset
 	UINT m_bitCount;			// # bits in track
 	BYTE m_bitMask;
-	double m_extraCycles;
+	UINT m_extraCycles8;		// in 1/8 cycle (125ns) units
 	LPBYTE m_trackimage;
 	bool m_trackimagedata;
 	bool m_trackimagedirty;
@@ -117,6 +118,7 @@ public:
 		m_lastStepperCycle = 0;
 		m_motorOnCycle = 0;
 		m_headWindow = 0;
+		m_weakBitRand = 0x2545F491;	// any non-zero seed
 		m_spinning = 0;
 		m_writelight = 0;
 		m_disk.clear();
@@ -129,6 +131,7 @@ public:
 	unsigned __int64 m_lastStepperCycle;
 	unsigned __int64 m_motorOnCycle;
 	BYTE m_headWindow;
+	UINT32 m_weakBitRand;	// xorshift32 state for weak bits
 	DWORD m_spinning;
 	DWORD m_writelight;
 	FloppyDisk m_disk;
@@ -198,6 +201,8 @@ public:
 	bool GetEnhanceDisk(void);
 	void SetEnhanceDisk(bool bEnhanceDisk);
 
+	bool AcceleratedReadSectors(const int drive, const UINT track, const BYTE* pPhysicalSectors, const UINT numSectors, LPBYTE pBuffer, BYTE& volume);
+
 	static BYTE __stdcall IORead(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
 	static BYTE __stdcall IOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles);
 
@@ -215,7 +220,11 @@ private:
 	void UpdateBitStreamPosition(FloppyDisk& floppy, const ULONG bitCellDelta);
 	void UpdateBitStreamOffsets(FloppyDisk& floppy);
 	__forceinline void IncBitStream(FloppyDisk& floppy);
+	__forceinline BYTE GetWeakBit(FloppyDrive& drive);
 	void DataLatchReadWOZ(WORD pc, WORD addr, UINT bitCellRemainder);
+	UINT GetBitCellsToNextEventWOZ(FloppyDrive& drive, FloppyDisk& floppy);
+	void DataLatchReadBitCellsWOZ(FloppyDrive& drive, FloppyDisk& floppy, const UINT bitCells);
+	static void InitLatchTableWOZ(void);
 	void DataLoadWriteWOZ(WORD pc, WORD addr, UINT bitCellRemainder);
 	void DataShiftWriteWOZ(WORD pc, WORD addr, ULONG uExecutedCycles);
 	void SetSequencerFunction(WORD addr, ULONG executedCycles);
@@ -228,6 +237,12 @@ private:
 	static int SyncEventCallback(int id, int cycles, ULONG uExecutedCycles);
 	void ControlStepperDeferred(void);
 	void ControlStepperLogging(WORD address, unsigned __int64 cumulativeCycles);
+	void RequestPrefetch(const int drive, const int direction);
+	bool GetPrefetchedTrack(const int drive);
+	void InvalidatePrefetch(const int drive);
+	bool PrefetchNextTrack(void);
+	void StopPrefetchThread(void);
+	static DWORD WINAPI PrefetchThread(LPVOID lpParameter);
 
 	void PreJitterCheck(int phase, BYTE latch);
 	void AddJitter(int phase, FloppyDisk& floppy);
@@ -304,6 +319,33 @@ private:
 	unsigned __int64 m_deferredStepperCumulativeCycles;
 	SyncEvent m_syncEvent;
 
+	// Track prefetch (opt-in via cmd-line):
+	// . after a head step, a worker thread reads the next tracks in the step direction (and for WOZ, finds their track seam)
+	// . all slot state is guarded by m_prefetchCriticalSection, which is only held briefly (never during image I/O)
+	// . the worker reads into its own buffer (under Disk2CardManager::LockTrackIO()), then publishes to the slot
+	struct PrefetchTrack
+	{
+		enum State_e {eEmpty=0, ePending, eReading, eReady};
+		State_e state;
+		ImageInfo* imagehandle;
+		float phasePrecise;
+		bool enhanceDisk;
+		LPBYTE trackimage;
+		UINT trackimageSize;
+		int nibbles;
+		UINT bitCount;
+		int longestSyncFFBitOffsetStart;	// WOZ only
+		UINT longestSyncFFRunLength;		// WOZ only
+	};
+
+	static const UINT NUM_PREFETCH_TRACKS = 2;
+	PrefetchTrack m_prefetchTrack[NUM_DRIVES][NUM_PREFETCH_TRACKS];
+	HANDLE m_hPrefetchThread;
+	HANDLE m_hPrefetchEvent;
+	std::atomic<bool> m_prefetchQuit;
+	CRITICAL_SECTION m_prefetchCriticalSection;
+	std::vector<BYTE> m_prefetchBuffer;	// Prefetch thread only
+
 	// Jitter (GH#930)
 	static const BYTE m_T00S00Pattern[];
 	UINT m_T00S00PatternIdx;
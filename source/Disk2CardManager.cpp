@@ -32,7 +32,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Disk2CardManager.h"
 #include "Core.h"
 #include "CardManager.h"
+#include "CPU.h"
 #include "Disk.h"
+#include "Memory.h"
 
 bool Disk2CardManager::IsConditionForFullSpeed(void)
 {
@@ -137,3 +139,172 @@ void Disk2CardManager::SetStepperDefer(bool defer)
 {
 	m_stepperDeferred = defer;
 }
+
+//===========================================================================
+
+// Accelerated disk:
+// . Reads by the DOS 3.3 RWTS and the ProDOS 8 Disk II driver are serviced by copying the decoded sectors straight from
+//   a DO/PO image into memory, instead of emulating the sequencer bit by bit.
+// . Anything else (seeks, writes, formats, WOZ/NIB images, non-standard code at the entrypoint) is left to be emulated as normal.
+// . The head isn't moved, so the RWTS's/driver's idea of the current track still matches the drive for the next emulated access.
+// . Returns the # of cycles to consume, or 0 if not serviced.
+
+static BYTE ReadMemory(const WORD addr)
+{
+	return *MemGetReadPtr(addr);
+}
+
+static bool IsIOSpace(const WORD addr, const UINT size)
+{
+	for (UINT i = 0; i < size; i += 256)
+	{
+		if (((addr + i) & 0xF000) == 0xC000)
+			return true;
+	}
+	return ((addr + size - 1) & 0xF000) == 0xC000;
+}
+
+Disk2InterfaceCard* Disk2CardManager::GetDisk2Card(const UINT slot)
+{
+	if (slot >= NUM_SLOTS || GetCardMgr().QuerySlot(slot) != CT_Disk2)
+		return NULL;
+
+	return &dynamic_cast<Disk2InterfaceCard&>(GetCardMgr().GetRef(slot));
+}
+
+UINT Disk2CardManager::AcceleratedEntrypoint(const WORD pc)
+{
+	if (pc == kAccelRWTSEntry)
+		return AcceleratedRWTS();
+	if (pc == kAccelProDOSEntry)
+		return AcceleratedProDOS();
+	return 0;
+}
+
+// DOS 3.3 RWTS: A/Y = IOB ptr (hi/lo)
+UINT Disk2CardManager::AcceleratedRWTS(void)
+{
+	// RWTS starts: STY $48 ; STA $49
+	if (ReadMemory(0xBD00) != 0x84 || ReadMemory(0xBD01) != 0x48 || ReadMemory(0xBD02) != 0x85 || ReadMemory(0xBD03) != 0x49)
+		return 0;
+
+	const WORD iob = (regs.a << 8) | regs.y;
+	const BYTE tableType = ReadMemory(iob + 0x00);
+	const BYTE slot16 = ReadMemory(iob + 0x01);
+	const BYTE drive = ReadMemory(iob + 0x02);
+	const BYTE volumeExpected = ReadMemory(iob + 0x03);
+	const BYTE track = ReadMemory(iob + 0x04);
+	const BYTE sector = ReadMemory(iob + 0x05);
+	const WORD buffer = ReadMemory(iob + 0x08) | (ReadMemory(iob + 0x09) << 8);
+	const BYTE command = ReadMemory(iob + 0x0C);
+
+	const BYTE kCmdRead = 0x01;
+	if (tableType != 0x01 || command != kCmdRead || (slot16 & 0x0F) || (drive != 1 && drive != 2) || sector >= NUM_SECTORS)
+		return 0;
+
+	// Logical to physical sector, using the RWTS's own interleave table (as some DOSes change it)
+	const WORD kInterleaveTable = 0xBFB8;
+	UINT16 sectorsInTable = 0;
+	for (UINT i = 0; i < NUM_SECTORS; i++)
+		sectorsInTable |= 1 << (ReadMemory(kInterleaveTable + i) & 0x0F);
+	if (sectorsInTable != 0xFFFF)
+		return 0;
+	const BYTE physicalSector = ReadMemory(kInterleaveTable + sector);
+
+	Disk2InterfaceCard* pCard = GetDisk2Card(slot16 >> 4);
+	if (!pCard || IsIOSpace(buffer, 256))
+		return 0;
+
+	BYTE data[256];
+	BYTE volume = 0;
+	if (!pCard->AcceleratedReadSectors(drive - 1, track, &physicalSector, 1, data, volume))
+		return 0;
+
+	if (volumeExpected != 0 && volumeExpected != volume)
+		return 0;	// let the RWTS report the volume mismatch
+
+	MemWriteDMA(buffer, data, sizeof(data));
+
+	const BYTE kNoError = 0x00;
+	MemWriteDMA(iob + 0x0D, kNoError);	// return code
+	MemWriteDMA(iob + 0x0E, volume);	// volume found
+
+	return kAccelCyclesPerSector;
+}
+
+// A Disk II (6&2) driver has the 64-byte write translate table, so look for it in the LC's $D000..$D7FF
+// . like the RWTS's interleave table check: so a different driver (or data) at $D000 is never accelerated
+static bool IsProDOSDisk2Driver(void)
+{
+	static const BYTE kWriteTranslateTable[0x40] =
+	{
+		0x96,0x97,0x9A,0x9B,0x9D,0x9E,0x9F,0xA6,
+		0xA7,0xAB,0xAC,0xAD,0xAE,0xAF,0xB2,0xB3,
+		0xB4,0xB5,0xB6,0xB7,0xB9,0xBA,0xBB,0xBC,
+		0xBD,0xBE,0xBF,0xCB,0xCD,0xCE,0xCF,0xD3,
+		0xD6,0xD7,0xD9,0xDA,0xDB,0xDC,0xDD,0xDE,
+		0xDF,0xE5,0xE6,0xE7,0xE9,0xEA,0xEB,0xEC,
+		0xED,0xEE,0xEF,0xF2,0xF3,0xF4,0xF5,0xF6,
+		0xF7,0xF9,0xFA,0xFB,0xFC,0xFD,0xFE,0xFF
+	};
+
+	const WORD kDriverStart = Disk2CardManager::kAccelProDOSEntry;
+	const UINT kDriverSize = 0x800;
+
+	BYTE driver[kDriverSize];
+	for (UINT i = 0; i < kDriverSize; i += 256)
+		memcpy(&driver[i], MemGetReadPtr(kDriverStart + i), 256);	// NB. kDriverStart is page aligned
+
+	return std::search(driver, driver + kDriverSize, kWriteTranslateTable, kWriteTranslateTable + sizeof(kWriteTranslateTable)) != driver + kDriverSize;
+}
+
+// ProDOS 8 Disk II driver: $42 = command, $43 = unit (DSSS0000), $44/45 = buffer, $46/47 = block
+UINT Disk2CardManager::AcceleratedProDOS(void)
+{
+	// ProDOS's global page starts with JMP MLI
+	if (ReadMemory(0xBF00) != 0x4C)
+		return 0;
+
+	// The driver is in the language card (so not eg. Applesoft at $D000 in ROM)
+	if (!(GetMemMode() & MF_HIGHRAM))
+		return 0;
+
+	const BYTE command = ReadMemory(0x42);
+	const BYTE unit = ReadMemory(0x43);
+	const WORD buffer = ReadMemory(0x44) | (ReadMemory(0x45) << 8);
+	const WORD block = ReadMemory(0x46) | (ReadMemory(0x47) << 8);
+
+	// Only if the unit's device driver (from the DEVADR table) is the one being called
+	const WORD kDevAdr = 0xBF10;
+	const WORD devAdr = kDevAdr + ((unit >> 3) & 0x1E);
+	if ((ReadMemory(devAdr) | (ReadMemory(devAdr + 1) << 8)) != kAccelProDOSEntry)
+		return 0;
+
+	const BYTE kCmdRead = 0x01;
+	const UINT kBlockSize = 512;
+	const UINT kBlocksPerTrack = 8;
+	if (command != kCmdRead || block >= TRACKS_STANDARD * kBlocksPerTrack)
+		return 0;
+
+	if (!IsProDOSDisk2Driver())
+		return 0;
+
+	Disk2InterfaceCard* pCard = GetDisk2Card((unit >> 4) & 7);
+	if (!pCard || IsIOSpace(buffer, kBlockSize))
+		return 0;
+
+	// A block is 2 consecutive ProDOS (logical) sectors
+	const BYTE kProDOSToPhysical[NUM_SECTORS] = {0x0,0x2,0x4,0x6,0x8,0xA,0xC,0xE, 0x1,0x3,0x5,0x7,0x9,0xB,0xD,0xF};
+	const UINT track = block / kBlocksPerTrack;
+	const UINT prodosSector = (block % kBlocksPerTrack) * 2;
+	const BYTE physicalSectors[2] = { kProDOSToPhysical[prodosSector], kProDOSToPhysical[prodosSector + 1] };
+
+	BYTE data[kBlockSize];
+	BYTE volume = 0;
+	if (!pCard->AcceleratedReadSectors(unit >> 7, track, physicalSectors, 2, data, volume))
+		return 0;
+
+	MemWriteDMA(buffer, data, sizeof(data));
+
+	return 2 * kAccelCyclesPerSector;
+}
@@ -1,10 +1,18 @@
 #pragma once
 
+class Disk2InterfaceCard;
+
 class Disk2CardManager
 {
 public:
-	Disk2CardManager(void) : m_stepperDeferred(true) {}
-	~Disk2CardManager(void) {}
+	Disk2CardManager(void) : m_stepperDeferred(true), m_trackPrefetch(false)
+	{
+		InitializeCriticalSection(&m_trackIOCriticalSection);
+	}
+	~Disk2CardManager(void)
+	{
+		DeleteCriticalSection(&m_trackIOCriticalSection);
+	}
 
 	bool IsConditionForFullSpeed(void);
 	void Update(const ULONG nExecutedCycles);
@@ -16,7 +24,27 @@ public:
 	void GetFilenameAndPathForSaveState(std::string& filename, std::string& path);
 	void SetStepperDefer(bool defer);
 	bool IsStepperDeferred(void) { return m_stepperDeferred; }
+	void SetTrackPrefetch(bool prefetch) { m_trackPrefetch = prefetch; }
+	bool IsTrackPrefetch(void) { return m_trackPrefetch; }
+
+	// Serialises Image[Read|Write]Track()/ImageClose() between the emulation thread and the track prefetch threads
+	// . global (not per-card), since the image-type objects are shared by all cards
+	void LockTrackIO(void) { EnterCriticalSection(&m_trackIOCriticalSection); }
+	void UnlockTrackIO(void) { LeaveCriticalSection(&m_trackIOCriticalSection); }
+
+	// Accelerated disk (opt-in, see CpuSetDiskAccelerated()): the CPU calls AcceleratedEntrypoint() when PC is at one of these
+	static const WORD kAccelRWTSEntry = 0xBD00;		// DOS 3.3 RWTS
+	static const WORD kAccelProDOSEntry = 0xD000;	// ProDOS 8 Disk II driver (in the language card)
+	UINT AcceleratedEntrypoint(const WORD pc);
 
 private:
+	UINT AcceleratedRWTS(void);
+	UINT AcceleratedProDOS(void);
+	Disk2InterfaceCard* GetDisk2Card(const UINT slot);
+
+	static const UINT kAccelCyclesPerSector = 12768;	// ~1/16th of a revolution: 6384 nibbles * 32 cycles / 16 sectors
+
 	bool m_stepperDeferred;	// debug: can disable via cmd-line
+	bool m_trackPrefetch;	// enable via cmd-line
+	CRITICAL_SECTION m_trackIOCriticalSection;
 };
@@ -3,5 +3,6 @@
 #define NIBBLES_PER_TRACK_NIB 0x1A00
 #define NIBBLES_PER_TRACK_WOZ2 0x1A18	// 6680
 #define NIBBLES_PER_TRACK NIBBLES_PER_TRACK_WOZ2	// MAX(NIBBLES_PER_TRACK_NIB, NIBBLES_PER_TRACK_WOZ2)
+#define NIBBLES_PER_TRACK_DSK 0x18F0	// 6384 = 48 + 16*396 (see CImageBase::NibblizeTrack())
 
 const UINT NUM_SECTORS = 16;
@@ -190,6 +190,21 @@ bool ImageReadBlock(	ImageInfo* const pImageInfo,
 
 //===========================================================================
 
+// Read consecutive blocks with one I/O
+bool ImageReadBlocks(	ImageInfo* const pImageInfo,
+						UINT nBlock,
+						UINT nBlocks,
+						LPBYTE pBlockBuffer)
+{
+	bool bRes = false;
+	if (pImageInfo->pImageType->AllowRW())
+		bRes = pImageInfo->pImageType->ReadBlocks(pImageInfo, nBlock, nBlocks, pBlockBuffer);
+
+	return bRes;
+}
+
+//===========================================================================
+
 bool ImageWriteBlock(	ImageInfo* const pImageInfo,
 						UINT nBlock,
 						LPBYTE pBlockBuffer)
@@ -203,6 +218,83 @@ bool ImageWriteBlock(	ImageInfo* const pImageInfo,
 
 //===========================================================================
 
+// Read a decoded 256-byte sector, for sector-based floppy images (ie. DO and PO) only
+// . physicalSector: the sector # in the sector's address field
+bool ImageReadSector(	ImageInfo* const pImageInfo,
+						const UINT track,
+						const UINT physicalSector,
+						LPBYTE pSectorBuffer)
+{
+	if (!pImageInfo->pImageType->AllowRW() || track >= pImageInfo->uNumTracks)
+		return false;
+
+	return pImageInfo->pImageType->ReadSector(pImageInfo, track, physicalSector, pSectorBuffer);
+}
+
+// Volume # in the address fields of a nibblized DO/PO image
+BYTE ImageGetVolumeNumber(ImageInfo* const pImageInfo)
+{
+	return pImageInfo->pImageType->GetVolumeNumber();
+}
+
+//===========================================================================
+
+// HDD only: map the image file into memory, so block reads & writes are just copies
+// . if this fails (or it's a gzip/zip) then blocks are just accessed via file I/O
+bool ImageMapFile(ImageInfo* const pImageInfo)
+{
+	return CImageBase::MapImageFile(pImageInfo);
+}
+
+// Write back any blocks buffered by a memory-mapped HDD image, or queue a dirty gzip/zip image for background write-back
+// . bIdleOnly: for gzip/zip, only queue once the image has been idle (not written) for the write-back idle timeout
+bool ImageFlush(ImageInfo* const pImageInfo, const bool bIdleOnly/*=false*/)
+{
+	return CImageBase::FlushImageFile(pImageInfo, bIdleOnly);
+}
+
+void ImageSetWriteBackIdleTimeout(const UINT timeoutMs)
+{
+	GetImageWriteBack().SetIdleTimeout(timeoutMs);
+}
+
+// Called on exit: block until all gzip/zip images have been written back
+void ImageWriteBackShutdown(void)
+{
+	GetImageWriteBack().Shutdown();
+}
+
+//===========================================================================
+
+// Open existing (normal) images as a read-only base image + a delta file in this directory (see CImageOverlay)
+void ImageSetOverlay(const std::string& directory, const ImageOverlayOpen_e openAction)
+{
+	// NB. resolve now, as the current directory changes (eg. when images are inserted)
+	char szFullPath[MAX_PATH];
+	const DWORD uNameLen = GetFullPathName(directory.c_str(), MAX_PATH, szFullPath, NULL);
+	CImageOverlay::SetDirectory((uNameLen && uNameLen < MAX_PATH) ? std::string(szFullPath) : directory);
+	CImageOverlay::SetOpenAction(openAction);
+}
+
+bool ImageIsOverlayEnabled(void)
+{
+	return CImageOverlay::IsEnabled();
+}
+
+// Pre: image isn't open
+bool ImageOverlayCommit(const std::string& pathname)
+{
+	return CImageOverlay::Commit(pathname);
+}
+
+// Pre: image isn't open
+bool ImageOverlayDiscard(const std::string& pathname)
+{
+	return CImageOverlay::Discard(pathname);
+}
+
+//===========================================================================
+
 UINT ImageGetNumTracks(ImageInfo* const pImageInfo)
 {
 	return pImageInfo ? pImageInfo->uNumTracks : 0;
@@ -74,6 +74,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 		eIMAGE_ERROR_FAILED_TO_INIT_ZEROLENGTH,
 	};
 
+	enum ImageOverlayOpen_e
+	{
+		eOVERLAY_OPEN_KEEP,		// use any existing delta file
+		eOVERLAY_OPEN_COMMIT,	// merge any existing delta file into the base image, then start a new delta
+		eOVERLAY_OPEN_DISCARD,	// delete any existing delta file, ie. start from the base image
+	};
+
 	const int MAX_DISK_IMAGE_NAME = 15;
 	const int MAX_DISK_FULL_NAME  = 127;
 
@@ -86,7 +93,18 @@ BOOL ImageBoot(ImageInfo* const pImageInfo);
 void ImageReadTrack(ImageInfo* const pImageInfo, float phase, LPBYTE pTrackImageBuffer, int* pNibbles, UINT* pBitCount, bool enhanceDisk);
 void ImageWriteTrack(ImageInfo* const pImageInfo, float phase, LPBYTE pTrackImageBuffer, int nNibbles);
 bool ImageReadBlock(ImageInfo* const pImageInfo, UINT nBlock, LPBYTE pBlockBuffer);
+bool ImageReadBlocks(ImageInfo* const pImageInfo, UINT nBlock, UINT nBlocks, LPBYTE pBlockBuffer);
 bool ImageWriteBlock(ImageInfo* const pImageInfo, UINT nBlock, LPBYTE pBlockBuffer);
+bool ImageReadSector(ImageInfo* const pImageInfo, const UINT track, const UINT physicalSector, LPBYTE pSectorBuffer);
+BYTE ImageGetVolumeNumber(ImageInfo* const pImageInfo);
+bool ImageMapFile(ImageInfo* const pImageInfo);
+bool ImageFlush(ImageInfo* const pImageInfo, const bool bIdleOnly=false);
+void ImageSetWriteBackIdleTimeout(const UINT timeoutMs);
+void ImageWriteBackShutdown(void);
+void ImageSetOverlay(const std::string& directory, const ImageOverlayOpen_e openAction);
+bool ImageIsOverlayEnabled(void);
+bool ImageOverlayCommit(const std::string& pathname);
+bool ImageOverlayDiscard(const std::string& pathname);
 
 UINT ImageGetNumTracks(ImageInfo* const pImageInfo);
 bool ImageIsMultiFileZip(ImageInfo* const pImageInfo);
@@ -64,6 +64,17 @@ ImageInfo::ImageInfo()
 	optimalBitTiming = 0;
 	bootSectorFormat = CWOZHelper::bootUnknown;
 	maxNibblesPerTrack = 0;
+	pNibblizedTracks = NULL;
+	hFileMapping = NULL;
+	pMappedView = NULL;
+	uMappedSize = 0;
+	bMappedViewDirty = false;
+	bImageBufferDirty = false;
+	dwImageBufferWriteTime = 0;
+	pOverlay = NULL;
+	hGZFile = NULL;
+	hUnzFile = NULL;
+	uImageBufferValid = 0;
 }
 
 CImageBase::CImageBase()
@@ -124,35 +135,72 @@ bool CImageBase::ReadTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTrac
 
 //-------------------------------------
 
+// For a DO/PO image: read one 256-byte sector, where physicalSector is the sector # from the sector's address field
+bool CImageBase::ReadDenibblizedSector(ImageInfo* pImageInfo, const UINT track, const UINT physicalSector, SectorOrder_e SectorOrder, LPBYTE pSectorBuffer)
+{
+	if (physicalSector >= NUM_SECTORS)
+		return false;
+
+	const UINT offset = pImageInfo->uOffset + track * TRACK_DENIBBLIZED_SIZE + (ms_SectorNumber[SectorOrder][physicalSector] << 8);
+	if (offset + 256 > pImageInfo->uImageSize)
+		return false;
+
+	memcpy(pSectorBuffer, &pImageInfo->pImageBuffer[offset], 256);
+	return true;
+}
+
+//-------------------------------------
+
 bool CImageBase::WriteTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTrackBuffer, const UINT uTrackSize)
 {
 	const long offset = pImageInfo->uOffset + nTrack * uTrackSize;
 	memcpy(&pImageInfo->pImageBuffer[offset], pTrackBuffer, uTrackSize);
 
+	if (pImageInfo->pNibblizedTracks && (UINT)nTrack < TRACKS_MAX)
+		pImageInfo->pNibblizedTracks[nTrack].bValid = false;
+
 	return WriteImageData(pImageInfo, pTrackBuffer, uTrackSize, offset);
 }
 
 //-----------------------------------------------------------------------------
 
-bool CImageBase::ReadBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer)
+// nBlocks: read this many consecutive blocks in one go (eg. for read-ahead)
+bool CImageBase::ReadBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer, const UINT nBlocks/*=1*/)
 {
 	long Offset = pImageInfo->uOffset + nBlock * HD_BLOCK_SIZE;
+	const UINT uSize = nBlocks * HD_BLOCK_SIZE;
 
-	if (pImageInfo->FileType == eFileNormal)
+	if (pImageInfo->pMappedView)
+	{
+		if ((UINT)Offset + uSize > pImageInfo->uMappedSize)
+			return false;
+
+		memcpy(pBlockBuffer, &pImageInfo->pMappedView[Offset], uSize);
+
+		if (pImageInfo->pOverlay)
+			pImageInfo->pOverlay->Patch(Offset, pBlockBuffer, uSize);
+	}
+	else if (pImageInfo->FileType == eFileNormal)
 	{
 		if (pImageInfo->hFile == INVALID_HANDLE_VALUE)
 			return false;
 
+		if (pImageInfo->pOverlay)
+			return pImageInfo->pOverlay->Read(Offset, pBlockBuffer, uSize);
+
 		SetFilePointer(pImageInfo->hFile, Offset, NULL, FILE_BEGIN);
 
 		DWORD dwBytesRead;
-		BOOL bRes = ReadFile(pImageInfo->hFile, pBlockBuffer, HD_BLOCK_SIZE, &dwBytesRead, NULL);
-		if (!bRes || dwBytesRead != HD_BLOCK_SIZE)
+		BOOL bRes = ReadFile(pImageInfo->hFile, pBlockBuffer, uSize, &dwBytesRead, NULL);
+		if (!bRes || dwBytesRead != uSize)
 			return false;
 	}
 	else if ((pImageInfo->FileType == eFileGZip) || (pImageInfo->FileType == eFileZip))
 	{
-		memcpy(pBlockBuffer, &pImageInfo->pImageBuffer[Offset], HD_BLOCK_SIZE);
+		if (!InflateImageBuffer(pImageInfo, Offset + uSize))
+			return false;
+
+		memcpy(pBlockBuffer, &pImageInfo->pImageBuffer[Offset], uSize);
 	}
 	else
 	{
@@ -170,8 +218,32 @@ bool CImageBase::WriteBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlo
 	long offset = pImageInfo->uOffset + nBlock * HD_BLOCK_SIZE;
 	const bool bGrowImageBuffer = (UINT)offset+HD_BLOCK_SIZE > pImageInfo->uImageSize;
 
+	if (pImageInfo->pMappedView && pImageInfo->pOverlay && bGrowImageBuffer)
+	{
+		// The base image's view is read-only, and the appended block is beyond it
+		UnmapImageFile(pImageInfo);
+	}
+
+	if (pImageInfo->pMappedView && !pImageInfo->pOverlay)	// NB. an overlay's base image is mapped read-only, so write to the delta file (via WriteImageData())
+	{
+		if (!bGrowImageBuffer)
+		{
+			// Written back to the file by FlushImageFile() (on eject, save-state or periodically by the HDD card)
+			memcpy(&pImageInfo->pMappedView[offset], pBlockBuffer, HD_BLOCK_SIZE);
+			pImageInfo->bMappedViewDirty = true;
+			return true;
+		}
+
+		// A view can't grow, so revert to file I/O for this image (appending blocks is rare)
+		UnmapImageFile(pImageInfo);
+	}
+
 	if (pImageInfo->FileType == eFileGZip || pImageInfo->FileType == eFileZip)
 	{
+		// NB. inflate up to (and including) this block first, otherwise inflating it later would overwrite this write
+		if (!InflateImageBuffer(pImageInfo, bGrowImageBuffer ? pImageInfo->uImageSize : offset + HD_BLOCK_SIZE))
+			return false;
+
 		if (bGrowImageBuffer)
 		{
 			// Horribly inefficient! (Unzip to a normal file if you want better performance!)
@@ -213,6 +285,9 @@ bool CImageBase::WriteImageData(ImageInfo* pImageInfo, LPBYTE pSrcBuffer, const
 		if (pImageInfo->hFile == INVALID_HANDLE_VALUE)
 			return false;
 
+		if (pImageInfo->pOverlay)
+			return pImageInfo->pOverlay->Write(offset, pSrcBuffer, uSrcSize);
+
 		if (SetFilePointer(pImageInfo->hFile, offset, NULL, FILE_BEGIN) == INVALID_SET_FILE_POINTER)
 		{
 			DWORD err = GetLastError();
@@ -225,33 +300,339 @@ bool CImageBase::WriteImageData(ImageInfo* pImageInfo, LPBYTE pSrcBuffer, const
 		if (!bRes || dwBytesWritten != uSrcSize)
 			return false;
 	}
-	else if (pImageInfo->FileType == eFileGZip)
+	else if ((pImageInfo->FileType == eFileGZip) || (pImageInfo->FileType == eFileZip))
 	{
-		// Write entire compressed image each time (dirty track change or dirty disk removal or a HDD block is written)
-		gzFile hGZFile = gzopen(pImageInfo->szFilename.c_str(), "wb");
-		if (hGZFile == NULL)
+		// pImageBuffer has already been updated, and is written back (compressed) in the background - see CImageWriteBack
+		// NB. Only support Zip archives with a single file (see CImageWriteBack::Queue())
+		_ASSERT(pImageInfo->FileType != eFileZip || pImageInfo->uNumEntriesInZip == 1);	// Should never occur, since image will be write-protected in CheckZipFile()
+		if (pImageInfo->FileType == eFileZip && pImageInfo->uNumEntriesInZip > 1)
 			return false;
 
-		int nLen = gzwrite(hGZFile, pImageInfo->pImageBuffer, pImageInfo->uImageSize);
-		int nRes = gzclose(hGZFile);	// close before returning (due to error) to avoid resource leak
-		hGZFile = NULL;
+		pImageInfo->bImageBufferDirty = true;
+		pImageInfo->dwImageBufferWriteTime = GetTickCount();
+	}
+	else
+	{
+		_ASSERT(0);
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+// Map a normal (ie. not gzip/zip) HDD image file, so that block reads & writes are just a memcpy (rather than a seek+read/write per block)
+// . the OS tracks the view's dirty pages, and FlushImageFile() writes them back
+bool CImageBase::MapImageFile(ImageInfo* pImageInfo)
+{
+	_ASSERT(!pImageInfo->pMappedView);
+
+	if (pImageInfo->FileType != eFileNormal || pImageInfo->hFile == INVALID_HANDLE_VALUE || pImageInfo->uImageSize == 0)
+		return false;
+
+	const bool bReadOnly = pImageInfo->bWriteProtected || pImageInfo->pOverlay;	// NB. an overlay's read-only view of the base image is shared by all instances
+
+	HANDLE hFileMapping = CreateFileMapping(pImageInfo->hFile, NULL, bReadOnly ? PAGE_READONLY : PAGE_READWRITE, 0, pImageInfo->uImageSize, NULL);
+	if (hFileMapping == NULL)
+		return false;
+
+	BYTE* pView = (BYTE*) MapViewOfFile(hFileMapping, bReadOnly ? FILE_MAP_READ : FILE_MAP_WRITE, 0, 0, pImageInfo->uImageSize);
+	if (pView == NULL)
+	{
+		CloseHandle(hFileMapping);
+		return false;
+	}
+
+	pImageInfo->hFileMapping = hFileMapping;
+	pImageInfo->pMappedView = pView;
+	pImageInfo->uMappedSize = pImageInfo->uImageSize;
+	pImageInfo->bMappedViewDirty = false;
+	return true;
+}
 
-		if (nLen != pImageInfo->uImageSize)
+void CImageBase::UnmapImageFile(ImageInfo* pImageInfo)
+{
+	if (!pImageInfo->pMappedView)
+		return;
+
+	FlushImageFile(pImageInfo);
+
+	UnmapViewOfFile(pImageInfo->pMappedView);
+	CloseHandle(pImageInfo->hFileMapping);
+
+	pImageInfo->hFileMapping = NULL;
+	pImageInfo->pMappedView = NULL;
+	pImageInfo->uMappedSize = 0;
+}
+
+// Write back an image's dirty data:
+// . memory-mapped HDD images: flush the view's dirty pages
+// . gzip/zip images: queue the image for background recompression
+//   - bIdleOnly: only once there have been no writes for the write-back idle timeout (to avoid recompressing while the guest is still writing)
+bool CImageBase::FlushImageFile(ImageInfo* pImageInfo, const bool bIdleOnly/*=false*/)
+{
+	if (pImageInfo->bImageBufferDirty)
+	{
+		if (pImageInfo->bWriteProtected)	// eg. the image failed to inflate - so writing it back would overwrite the archive with a zero-padded image
+		{
+			pImageInfo->bImageBufferDirty = false;
 			return false;
+		}
+
+		if (bIdleOnly && (GetTickCount() - pImageInfo->dwImageBufferWriteTime) < GetImageWriteBack().GetIdleTimeout())
+			return true;
 
-		if (nRes != Z_OK)
+		if (!InflateImageBuffer(pImageInfo, pImageInfo->uImageSize))	// the whole image is written back
 			return false;
+
+		GetImageWriteBack().Queue(pImageInfo);
+		pImageInfo->bImageBufferDirty = false;
+	}
+
+	if (!pImageInfo->pMappedView || !pImageInfo->bMappedViewDirty)
+		return true;
+
+	if (!FlushViewOfFile(pImageInfo->pMappedView, 0))
+		return false;
+
+	pImageInfo->bMappedViewDirty = false;
+	return true;
+}
+
+// Lazily inflate a gzip/zip image, so that opening a large (eg. HDD) image doesn't need to inflate the whole image
+// . the image can only be inflated sequentially, so inflate up to uSize (and some read-ahead)
+bool CImageBase::InflateImageBuffer(ImageInfo* pImageInfo, const UINT uSize)
+{
+	if (uSize <= pImageInfo->uImageBufferValid)
+		return true;
+
+	const UINT kReadAheadSize = 64 * 1024;
+	const UINT uEnd = std::min<UINT>(std::max<UINT>(uSize, pImageInfo->uImageBufferValid + kReadAheadSize), pImageInfo->uImageSize);
+	const UINT uLen = uEnd - pImageInfo->uImageBufferValid;
+	BYTE* pDst = &pImageInfo->pImageBuffer[pImageInfo->uImageBufferValid];
+
+	int nLen = -1;
+	if (pImageInfo->hGZFile)
+		nLen = gzread(pImageInfo->hGZFile, pDst, uLen);
+	else if (pImageInfo->hUnzFile)
+		nLen = unzReadCurrentFile((unzFile)pImageInfo->hUnzFile, pDst, uLen);
+
+	if ((UINT)nLen != uLen)
+	{
+		_ASSERT(0);
+		LogFileOutput("InflateImageBuffer: failed to inflate %08X bytes at offset %08X for file: %s\n", uLen, pImageInfo->uImageBufferValid, pImageInfo->szFilename.c_str());
+
+		// Don't retry - just treat the rest of the image as zeros, and make the image read-only (so it's never written back)
+		memset(pDst, 0, uLen);
+		pImageInfo->uImageBufferValid = uEnd;
+		pImageInfo->bWriteProtected = true;
+		CloseInflateStream(pImageInfo);
+		return false;
+	}
+
+	pImageInfo->uImageBufferValid = uEnd;
+
+	if (pImageInfo->uImageBufferValid == pImageInfo->uImageSize)
+		CloseInflateStream(pImageInfo);
+
+	return true;
+}
+
+void CImageBase::CloseInflateStream(ImageInfo* pImageInfo)
+{
+	if (pImageInfo->hGZFile)
+	{
+		gzclose(pImageInfo->hGZFile);
+		pImageInfo->hGZFile = NULL;
+	}
+
+	if (pImageInfo->hUnzFile)
+	{
+		unzCloseCurrentFile((unzFile)pImageInfo->hUnzFile);	// Must CloseCurrentFile before Close
+		unzClose((unzFile)pImageInfo->hUnzFile);
+		pImageInfo->hUnzFile = NULL;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+CImageWriteBack& GetImageWriteBack(void)
+{
+	static CImageWriteBack sg_ImageWriteBack;
+	return sg_ImageWriteBack;
+}
+
+CImageWriteBack::CImageWriteBack(void)
+	: m_jobActive(false)
+	, m_quit(false)
+	, m_idleTimeoutMs(2000)
+	, m_hThread(NULL)
+	, m_hJobEvent(NULL)
+{
+	InitializeCriticalSection(&m_criticalSection);
+}
+
+void CImageWriteBack::Queue(const ImageInfo* pImageInfo)
+{
+	_ASSERT(pImageInfo->FileType == eFileGZip || pImageInfo->FileType == eFileZip);
+
+	// NB. Only support Zip archives with a single file
+	// - there is no delete in a zipfile, so would need to copy files from old to new zip file!
+	if (pImageInfo->FileType == eFileZip && pImageInfo->uNumEntriesInZip > 1)
+		return;
+
+	Job* pJob = new Job;
+	pJob->fileType = pImageInfo->FileType;
+	pJob->szFilename = pImageInfo->szFilename;
+	pJob->szFilenameInZip = pImageInfo->szFilenameInZip;
+	pJob->zipFileInfo = pImageInfo->zipFileInfo;
+	pJob->image.assign(pImageInfo->pImageBuffer, pImageInfo->pImageBuffer + pImageInfo->uImageSize);
+
+	EnterCriticalSection(&m_criticalSection);
+
+	if (m_hThread == NULL)
+	{
+		m_hJobEvent = CreateEvent(NULL,		// lpEventAttributes
+								FALSE,		// bManualReset (FALSE = auto-reset)
+								FALSE,		// bInitialState (FALSE = non-signaled)
+								NULL);		// lpName
+
+		DWORD dwThreadId;
+		m_hThread = CreateThread(NULL,			// lpThreadAttributes
+								0,				// dwStackSize
+								&CImageWriteBack::WriteBackThread,
+								this,			// lpParameter
+								0,				// dwCreationFlags : 0 = Run immediately
+								&dwThreadId);	// lpThreadId
+	}
+
+	// Coalesce with a queued (but not yet started) write-back of the same file
+	bool bCoalesced = false;
+	for (UINT i = 0; i < m_jobs.size(); i++)
+	{
+		if (m_jobs[i]->szFilename == pJob->szFilename)
+		{
+			delete m_jobs[i];
+			m_jobs[i] = pJob;
+			bCoalesced = true;
+			break;
+		}
+	}
+
+	if (!bCoalesced)
+		m_jobs.push_back(pJob);
+
+	LeaveCriticalSection(&m_criticalSection);
+
+	SetEvent(m_hJobEvent);
+}
+
+// Block until all queued write-backs have completed (eg. before (re)opening a gzip/zip image, or on exit)
+void CImageWriteBack::WaitUntilIdle(void)
+{
+	while (1)
+	{
+		EnterCriticalSection(&m_criticalSection);
+		const bool bBusy = !m_jobs.empty() || m_jobActive;
+		LeaveCriticalSection(&m_criticalSection);
+
+		if (!bBusy)
+			break;
+
+		Sleep(10);
+	}
+}
+
+void CImageWriteBack::Shutdown(void)
+{
+	if (m_hThread == NULL)
+		return;
+
+	WaitUntilIdle();
+
+	EnterCriticalSection(&m_criticalSection);
+	m_quit = true;
+	LeaveCriticalSection(&m_criticalSection);
+
+	SetEvent(m_hJobEvent);
+	WaitForSingleObject(m_hThread, INFINITE);
+
+	CloseHandle(m_hThread);
+	m_hThread = NULL;
+	CloseHandle(m_hJobEvent);
+	m_hJobEvent = NULL;
+	m_quit = false;
+}
+
+DWORD WINAPI CImageWriteBack::WriteBackThread(LPVOID lpParameter)
+{
+	CImageWriteBack* pWriteBack = (CImageWriteBack*) lpParameter;
+
+	while (1)
+	{
+		WaitForSingleObject(pWriteBack->m_hJobEvent, INFINITE);
+
+		while (1)
+		{
+			Job* pJob = NULL;
+
+			EnterCriticalSection(&pWriteBack->m_criticalSection);
+			if (!pWriteBack->m_jobs.empty())
+			{
+				pJob = pWriteBack->m_jobs.front();
+				pWriteBack->m_jobs.pop_front();
+				pWriteBack->m_jobActive = true;
+			}
+			const bool bQuit = pWriteBack->m_quit;
+			LeaveCriticalSection(&pWriteBack->m_criticalSection);
+
+			if (!pJob)
+			{
+				if (bQuit)
+					return 0;
+				break;
+			}
+
+			if (!WriteImage(*pJob))
+				LogFileOutput("ImageWriteBack: failed to write: %s\n", pJob->szFilename.c_str());
+
+			delete pJob;
+
+			EnterCriticalSection(&pWriteBack->m_criticalSection);
+			pWriteBack->m_jobActive = false;
+			LeaveCriticalSection(&pWriteBack->m_criticalSection);
+		}
 	}
-	else if (pImageInfo->FileType == eFileZip)
+}
+
+// Write the entire compressed image to a temp file, then replace the original file with it
+// . so a crash (or failure) part way through never leaves a truncated/corrupt image
+bool CImageWriteBack::WriteImage(const Job& job)
+{
+	const std::string szTempFilename = job.szFilename + ".tmp";
+	const BYTE* pImage = job.image.empty() ? NULL : &job.image[0];
+	const UINT uImageSize = job.image.size();
+
+	if (job.fileType == eFileGZip)
 	{
-		// Write entire compressed image each time (dirty track change or dirty disk removal or a HDD block is written)
-		// NB. Only support Zip archives with a single file
-		// - there is no delete in a zipfile, so would need to copy files from old to new zip file!
-		_ASSERT(pImageInfo->uNumEntriesInZip == 1);	// Should never occur, since image will be write-protected in CheckZipFile()
-		if (pImageInfo->uNumEntriesInZip > 1)
+		gzFile hGZFile = gzopen(szTempFilename.c_str(), "wb");
+		if (hGZFile == NULL)
 			return false;
 
-		zipFile hZipFile = zipOpen(pImageInfo->szFilename.c_str(), APPEND_STATUS_CREATE);
+		int nLen = gzwrite(hGZFile, pImage, uImageSize);
+		int nRes = gzclose(hGZFile);	// close before returning (due to error) to avoid resource leak
+		hGZFile = NULL;
+
+		if (nLen != uImageSize || nRes != Z_OK)
+		{
+			DeleteFile(szTempFilename.c_str());
+			return false;
+		}
+	}
+	else if (job.fileType == eFileZip)
+	{
+		zipFile hZipFile = zipOpen(szTempFilename.c_str(), APPEND_STATUS_CREATE);
 		if (hZipFile == NULL)
 			return false;
 
@@ -259,11 +640,12 @@ bool CImageBase::WriteImageData(ImageInfo* pImageInfo, LPBYTE pSrcBuffer, const
 
 		try
 		{
-			nOpenedFileInZip = zipOpenNewFileInZip(hZipFile, pImageInfo->szFilenameInZip.c_str(), &pImageInfo->zipFileInfo, NULL, 0, NULL, 0, NULL, Z_DEFLATED, Z_BEST_SPEED);
+			zip_fileinfo zipFileInfo = job.zipFileInfo;
+			nOpenedFileInZip = zipOpenNewFileInZip(hZipFile, job.szFilenameInZip.c_str(), &zipFileInfo, NULL, 0, NULL, 0, NULL, Z_DEFLATED, Z_BEST_SPEED);
 			if (nOpenedFileInZip != ZIP_OK)
 				throw false;
 
-			int nRes = zipWriteInFileInZip(hZipFile, pImageInfo->pImageBuffer, pImageInfo->uImageSize);
+			int nRes = zipWriteInFileInZip(hZipFile, pImage, uImageSize);
 			if (nRes != ZIP_OK)
 				throw false;
 
@@ -278,13 +660,17 @@ bool CImageBase::WriteImageData(ImageInfo* pImageInfo, LPBYTE pSrcBuffer, const
 				zipCloseFileInZip(hZipFile);
 
 			zipClose(hZipFile, NULL);
+			DeleteFile(szTempFilename.c_str());
 
 			return false;
 		}
 
 		int nRes = zipClose(hZipFile, NULL);
 		if (nRes != ZIP_OK)
+		{
+			DeleteFile(szTempFilename.c_str());
 			return false;
+		}
 	}
 	else
 	{
@@ -292,9 +678,327 @@ bool CImageBase::WriteImageData(ImageInfo* pImageInfo, LPBYTE pSrcBuffer, const
 		return false;
 	}
 
+	return MoveFileEx(szTempFilename.c_str(), job.szFilename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) ? true : false;
+}
+
+//-----------------------------------------------------------------------------
+
+std::string CImageOverlay::ms_directory;
+ImageOverlayOpen_e CImageOverlay::ms_openAction = eOVERLAY_OPEN_KEEP;
+
+static bool ReadFileAt(HANDLE hFile, const UINT offset, LPBYTE pBuffer, const UINT size)
+{
+	if (SetFilePointer(hFile, offset, NULL, FILE_BEGIN) == INVALID_SET_FILE_POINTER)
+		return false;
+
+	DWORD dwBytesRead;
+	BOOL bRes = ReadFile(hFile, pBuffer, size, &dwBytesRead, NULL);
+	return bRes && dwBytesRead == size;
+}
+
+static bool WriteFileAt(HANDLE hFile, const UINT offset, const BYTE* pBuffer, const UINT size)
+{
+	if (SetFilePointer(hFile, offset, NULL, FILE_BEGIN) == INVALID_SET_FILE_POINTER)
+		return false;
+
+	DWORD dwBytesWritten;
+	BOOL bRes = WriteFile(hFile, pBuffer, size, &dwBytesWritten, NULL);
+	return bRes && dwBytesWritten == size;
+}
+
+static std::string GetFullPathname(const std::string& pathname)
+{
+	char szFullPathname[MAX_PATH];
+	DWORD uNameLen = GetFullPathName(pathname.c_str(), MAX_PATH, szFullPathname, NULL);
+	if (uNameLen == 0 || uNameLen >= MAX_PATH)
+		return pathname;
+
+	return szFullPathname;
+}
+
+static UINT64 GetFileWriteTime(HANDLE hFile)
+{
+	FILETIME writeTime;
+	if (!GetFileTime(hFile, NULL, NULL, &writeTime))
+		return 0;
+
+	return ((UINT64)writeTime.dwHighDateTime << 32) | writeTime.dwLowDateTime;
+}
+
+CImageOverlay::CImageOverlay(void)
+	: m_hBaseFile(INVALID_HANDLE_VALUE)
+	, m_hDeltaFile(INVALID_HANDLE_VALUE)
+	, m_baseWriteTime(0)
+	, m_baseSize(0)
+	, m_imageSize(0)
+{
+}
+
+CImageOverlay::~CImageOverlay(void)
+{
+	Close();
+}
+
+// "<overlay dir>\<image name>.<hash of image's full pathname>.delta"
+// . so same-named images in different folders (eg. two "MASTER.DSK") each get their own delta file
+std::string CImageOverlay::GetDeltaFilename(const std::string& baseFilename)
+{
+	const std::string basePathname = GetFullPathname(baseFilename);
+
+	CHAR filename[_MAX_FNAME];
+	CHAR extension[_MAX_EXT];
+	_splitpath(basePathname.c_str(), NULL, NULL, filename, extension);
+
+	UINT32 hash = 2166136261u;	// FNV-1a (case-insensitive, like Windows pathnames)
+	for (size_t i = 0; i < basePathname.size(); i++)
+		hash = (hash ^ (BYTE)toupper((BYTE)basePathname[i])) * 16777619u;
+
+	std::string deltaFilename = ms_directory;
+	if (*(deltaFilename.end()-1) != PATH_SEPARATOR)
+		deltaFilename += PATH_SEPARATOR;
+
+	return deltaFilename + filename + extension + StrFormat(".%08X", hash) + ".delta";
+}
+
+bool CImageOverlay::ReadDelta(HANDLE hDeltaFile, DeltaHeader& hdr, std::map<UINT, UINT>& chunks)
+{
+	if (!ReadFileAt(hDeltaFile, 0, (LPBYTE)&hdr, sizeof(hdr)))
+		return false;
+
+	if (memcmp(hdr.id, "AWDELTA", sizeof(hdr.id)) != 0 || hdr.version != kDeltaVersion || hdr.chunkSize != kChunkSize)
+		return false;
+
+	// NB. Ignore any partial record at the end (eg. if the emulator was killed mid-write)
+	const DWORD dwDeltaSize = GetFileSize(hDeltaFile, NULL);
+	for (UINT offset = sizeof(hdr); offset + kRecordSize <= dwDeltaSize; offset += kRecordSize)
+	{
+		UINT32 chunk;
+		if (!ReadFileAt(hDeltaFile, offset, (LPBYTE)&chunk, sizeof(chunk)))
+			return false;
+
+		chunks[chunk] = offset + sizeof(chunk);
+	}
+
+	return true;
+}
+
+// A delta is only for the exact base image it was created from: same full pathname, and unchanged since (same size & last write time)
+bool CImageOverlay::IsDeltaForBase(DeltaHeader& hdr, const std::string& basePathname, HANDLE hBaseFile)
+{
+	hdr.basePathname[MAX_PATH-1] = 0;
+
+	return hdr.baseSize == GetFileSize(hBaseFile, NULL)
+		&& hdr.baseWriteTime == GetFileWriteTime(hBaseFile)
+		&& _stricmp(hdr.basePathname, basePathname.c_str()) == 0;
+}
+
+bool CImageOverlay::WriteHeader(void)
+{
+	DeltaHeader hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.id, "AWDELTA", sizeof(hdr.id));
+	hdr.version = kDeltaVersion;
+	hdr.chunkSize = kChunkSize;
+	hdr.baseSize = m_baseSize;
+	hdr.imageSize = m_imageSize;
+	hdr.baseWriteTime = m_baseWriteTime;
+	strncpy_s(hdr.basePathname, sizeof(hdr.basePathname), m_basePathname.c_str(), _TRUNCATE);
+
+	return WriteFileAt(m_hDeltaFile, 0, (const BYTE*)&hdr, sizeof(hdr));
+}
+
+// Pre: hBaseFile is the base image, opened read-only (and shared for reading, so other instances can use it too)
+bool CImageOverlay::Open(const std::string& baseFilename, HANDLE hBaseFile, const UINT baseSize)
+{
+	m_hBaseFile = hBaseFile;
+	m_basePathname = GetFullPathname(baseFilename);
+	m_baseWriteTime = GetFileWriteTime(hBaseFile);
+	m_baseSize = baseSize;
+	m_imageSize = baseSize;
+	m_chunks.clear();
+
+	CreateDirectory(ms_directory.c_str(), NULL);
+
+	const std::string deltaFilename = GetDeltaFilename(baseFilename);
+	m_hDeltaFile = CreateFile(deltaFilename.c_str(),
+						GENERIC_READ | GENERIC_WRITE,
+						FILE_SHARE_READ,
+						(LPSECURITY_ATTRIBUTES)NULL,
+						OPEN_ALWAYS,
+						FILE_ATTRIBUTE_NORMAL,
+						NULL);
+
+	if (m_hDeltaFile == INVALID_HANDLE_VALUE)
+	{
+		LogFileOutput("Overlay: failed to open delta file: %s\n", deltaFilename.c_str());
+		return false;
+	}
+
+	if (GetFileSize(m_hDeltaFile, NULL) == 0)
+		return WriteHeader();	// new delta file
+
+	DeltaHeader hdr;
+	if (!ReadDelta(m_hDeltaFile, hdr, m_chunks) || !IsDeltaForBase(hdr, m_basePathname, hBaseFile))
+	{
+		// Not a delta file (or an old version), or for a different base image, or the base image has changed since the delta file was created
+		// . so refuse to use it (and leave it untouched)
+		LogFileOutput("Overlay: delta file doesn't match base image: %s\n", deltaFilename.c_str());
+		Close();
+		return false;
+	}
+
+	m_imageSize = hdr.imageSize;
 	return true;
 }
 
+void CImageOverlay::Close(void)
+{
+	if (m_hDeltaFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_hDeltaFile);
+		m_hDeltaFile = INVALID_HANDLE_VALUE;
+	}
+
+	m_hBaseFile = INVALID_HANDLE_VALUE;
+	m_chunks.clear();
+}
+
+bool CImageOverlay::ReadBase(const UINT offset, LPBYTE pBuffer, const UINT size)
+{
+	memset(pBuffer, 0, size);	// beyond the end of the base image
+	if (offset >= m_baseSize)
+		return true;
+
+	return ReadFileAt(m_hBaseFile, offset, pBuffer, std::min<UINT>(size, m_baseSize - offset));
+}
+
+// Apply any of the delta's chunks that overlap [offset, offset+size) to pBuffer
+void CImageOverlay::Patch(const UINT offset, LPBYTE pBuffer, const UINT size)
+{
+	const UINT end = offset + size;
+
+	std::map<UINT, UINT>::const_iterator it = m_chunks.lower_bound(offset / kChunkSize);
+	for (; it != m_chunks.end() && it->first * kChunkSize < end; ++it)
+	{
+		BYTE chunk[kChunkSize];
+		if (!ReadFileAt(m_hDeltaFile, it->second, chunk, kChunkSize))
+		{
+			_ASSERT(0);
+			continue;
+		}
+
+		const UINT chunkStart = it->first * kChunkSize;
+		const UINT from = std::max<UINT>(offset, chunkStart);
+		const UINT to = std::min<UINT>(end, chunkStart + (UINT)kChunkSize);
+		memcpy(&pBuffer[from - offset], &chunk[from - chunkStart], to - from);
+	}
+}
+
+bool CImageOverlay::Read(const UINT offset, LPBYTE pBuffer, const UINT size)
+{
+	if (!ReadBase(offset, pBuffer, size))
+		return false;
+
+	Patch(offset, pBuffer, size);
+	return true;
+}
+
+bool CImageOverlay::Write(const UINT offset, const BYTE* pBuffer, const UINT size)
+{
+	const UINT end = offset + size;
+
+	for (UINT chunk = offset / kChunkSize; chunk * kChunkSize < end; chunk++)
+	{
+		const UINT chunkStart = chunk * kChunkSize;
+		const UINT from = std::max<UINT>(offset, chunkStart);
+		const UINT to = std::min<UINT>(end, chunkStart + (UINT)kChunkSize);
+
+		// Record: chunk index, then the chunk's data
+		BYTE record[kRecordSize];
+		*(UINT32*)record = chunk;
+		BYTE* pChunk = &record[sizeof(UINT32)];
+
+		if (to - from != kChunkSize)	// partial chunk (eg. WOZ header): merge with the chunk's current data
+		{
+			if (!Read(chunkStart, pChunk, kChunkSize))
+				return false;
+		}
+
+		memcpy(&pChunk[from - chunkStart], &pBuffer[from - offset], to - from);
+
+		std::map<UINT, UINT>::const_iterator it = m_chunks.find(chunk);
+		if (it != m_chunks.end())
+		{
+			if (!WriteFileAt(m_hDeltaFile, it->second, pChunk, kChunkSize))
+				return false;
+		}
+		else
+		{
+			const UINT recordOffset = sizeof(DeltaHeader) + m_chunks.size() * kRecordSize;	// NB. overwrites any partial record
+			if (!WriteFileAt(m_hDeltaFile, recordOffset, record, kRecordSize))
+				return false;
+
+			m_chunks[chunk] = recordOffset + sizeof(UINT32);
+		}
+	}
+
+	if (end > m_imageSize)
+	{
+		m_imageSize = end;
+		return WriteHeader();
+	}
+
+	return true;
+}
+
+// Merge an image's delta file into its base image, then delete the delta file
+// . NB. fails if the base image is open (eg. by another emulator instance)
+bool CImageOverlay::Commit(const std::string& baseFilename)
+{
+	const std::string deltaFilename = GetDeltaFilename(baseFilename);
+
+	HANDLE hDeltaFile = CreateFile(deltaFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, (LPSECURITY_ATTRIBUTES)NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hDeltaFile == INVALID_HANDLE_VALUE)
+		return true;	// nothing to commit
+
+	HANDLE hBaseFile = CreateFile(baseFilename.c_str(), GENERIC_READ | GENERIC_WRITE, 0, (LPSECURITY_ATTRIBUTES)NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hBaseFile == INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(hDeltaFile);
+		LogFileOutput("Overlay: failed to open base image for commit: %s\n", baseFilename.c_str());
+		return false;
+	}
+
+	DeltaHeader hdr;
+	std::map<UINT, UINT> chunks;
+	bool bRes = ReadDelta(hDeltaFile, hdr, chunks) && IsDeltaForBase(hdr, GetFullPathname(baseFilename), hBaseFile);
+
+	for (std::map<UINT, UINT>::const_iterator it = chunks.begin(); bRes && it != chunks.end(); ++it)
+	{
+		BYTE chunk[kChunkSize];
+		const UINT chunkStart = it->first * kChunkSize;
+		bRes = ReadFileAt(hDeltaFile, it->second, chunk, kChunkSize)
+			&& WriteFileAt(hBaseFile, chunkStart, chunk, std::min<UINT>((UINT)kChunkSize, hdr.imageSize - chunkStart));
+	}
+
+	CloseHandle(hBaseFile);
+	CloseHandle(hDeltaFile);
+
+	if (!bRes)
+	{
+		LogFileOutput("Overlay: failed to commit delta file: %s\n", deltaFilename.c_str());
+		return false;
+	}
+
+	return DeleteFile(deltaFilename.c_str()) ? true : false;
+}
+
+bool CImageOverlay::Discard(const std::string& baseFilename)
+{
+	const std::string deltaFilename = GetDeltaFilename(baseFilename);
+	return DeleteFile(deltaFilename.c_str()) || GetLastError() == ERROR_FILE_NOT_FOUND;
+}
+
 //-----------------------------------------------------------------------------
 
 LPBYTE CImageBase::Code62(int sector)
@@ -575,6 +1279,52 @@ DWORD CImageBase::NibblizeTrack(LPBYTE trackimagebuffer, SectorOrder_e SectorOrd
 
 //-------------------------------------
 
+// Fast-loaders and copiers seek back & forth across the same tracks, so keep each track's nibblized image
+// (post-skew) and just copy it out next time. An entry is only invalidated by WriteTrack().
+void CImageBase::ReadNibblizedTrack(ImageInfo* pImageInfo, const UINT track, SectorOrder_e SectorOrder, LPBYTE pTrackImageBuffer, int* pNibbles, const bool enhanceDisk)
+{
+	NibblizedTrack* pCached = NULL;
+
+	if (track < TRACKS_MAX)
+	{
+		if (!pImageInfo->pNibblizedTracks)
+		{
+			pImageInfo->pNibblizedTracks = new NibblizedTrack[TRACKS_MAX];
+			for (UINT i = 0; i < TRACKS_MAX; i++)
+				pImageInfo->pNibblizedTracks[i].bValid = false;
+		}
+
+		pCached = &pImageInfo->pNibblizedTracks[track];
+		if (pCached->bValid &&
+			pCached->sectorOrder == SectorOrder &&
+			pCached->volumeNumber == m_uVolumeNumber &&
+			pCached->enhanceDisk == enhanceDisk)
+		{
+			memcpy(pTrackImageBuffer, pCached->trackImage, pCached->nibbles);
+			*pNibbles = pCached->nibbles;
+			return;
+		}
+	}
+
+	ReadTrack(pImageInfo, track, m_pWorkBuffer, TRACK_DENIBBLIZED_SIZE);
+	*pNibbles = NibblizeTrack(pTrackImageBuffer, SectorOrder, track);
+	if (!enhanceDisk)
+		SkewTrack(track, *pNibbles, pTrackImageBuffer);
+
+	if (pCached)
+	{
+		_ASSERT(*pNibbles == NIBBLES_PER_TRACK_DSK);
+		memcpy(pCached->trackImage, pTrackImageBuffer, *pNibbles);
+		pCached->nibbles = *pNibbles;
+		pCached->sectorOrder = (BYTE)SectorOrder;
+		pCached->volumeNumber = m_uVolumeNumber;
+		pCached->enhanceDisk = enhanceDisk;
+		pCached->bValid = true;
+	}
+}
+
+//-------------------------------------
+
 void CImageBase::SkewTrack(const int nTrack, const int nNumNibbles, const LPBYTE pTrackImageBuffer)
 {
 	int nSkewBytes = (nTrack*768) % nNumNibbles;
@@ -662,10 +1412,12 @@ public:
 	virtual void Read(ImageInfo* pImageInfo, const float phase, LPBYTE pTrackImageBuffer, int* pNibbles, UINT* pBitCount, bool enhanceDisk)
 	{
 		const UINT track = PhaseToTrack(phase);
-		ReadTrack(pImageInfo, track, m_pWorkBuffer, TRACK_DENIBBLIZED_SIZE);
-		*pNibbles = NibblizeTrack(pTrackImageBuffer, eDOSOrder, track);
-		if (!enhanceDisk)
-			SkewTrack(track, *pNibbles, pTrackImageBuffer);
+		ReadNibblizedTrack(pImageInfo, track, eDOSOrder, pTrackImageBuffer, pNibbles, enhanceDisk);
+	}
+
+	virtual bool ReadSector(ImageInfo* pImageInfo, const UINT track, const UINT physicalSector, LPBYTE pSectorBuffer)
+	{
+		return ReadDenibblizedSector(pImageInfo, track, physicalSector, eDOSOrder, pSectorBuffer);
 	}
 
 	virtual void Write(ImageInfo* pImageInfo, const float phase, LPBYTE pTrackImageBuffer, int nNibbles)
@@ -730,10 +1482,12 @@ public:
 	virtual void Read(ImageInfo* pImageInfo, const float phase, LPBYTE pTrackImageBuffer, int* pNibbles, UINT* pBitCount, bool enhanceDisk)
 	{
 		const UINT track = PhaseToTrack(phase);
-		ReadTrack(pImageInfo, track, m_pWorkBuffer, TRACK_DENIBBLIZED_SIZE);
-		*pNibbles = NibblizeTrack(pTrackImageBuffer, eProDOSOrder, track);
-		if (!enhanceDisk)
-			SkewTrack(track, *pNibbles, pTrackImageBuffer);
+		ReadNibblizedTrack(pImageInfo, track, eProDOSOrder, pTrackImageBuffer, pNibbles, enhanceDisk);
+	}
+
+	virtual bool ReadSector(ImageInfo* pImageInfo, const UINT track, const UINT physicalSector, LPBYTE pSectorBuffer)
+	{
+		return ReadDenibblizedSector(pImageInfo, track, physicalSector, eProDOSOrder, pSectorBuffer);
 	}
 
 	virtual void Write(ImageInfo* pImageInfo, const float phase, LPBYTE pTrackImageBuffer, int nNibbles)
@@ -882,6 +1636,11 @@ public:
 		return ReadBlock(pImageInfo, nBlock, pBlockBuffer);
 	}
 
+	virtual bool ReadBlocks(ImageInfo* pImageInfo, UINT nBlock, UINT nBlocks, LPBYTE pBlockBuffer)
+	{
+		return ReadBlock(pImageInfo, nBlock, pBlockBuffer, nBlocks);
+	}
+
 	virtual bool Write(ImageInfo* pImageInfo, UINT nBlock, LPBYTE pBlockBuffer)
 	{
 		if (pImageInfo->bWriteProtected)
@@ -1009,10 +1768,9 @@ public:
 			return false;
 		}
 
-		ReadFile(ptr->hFile, mem+address, length, &bytesread, NULL);
-		int loop = 192;
-		while (loop--)
-			*(memdirty+loop) = 0xFF;
+		std::vector<BYTE> buffer(length);
+		ReadFile(ptr->hFile, &buffer[0], length, &bytesread, NULL);
+		MemWriteBlock(address, &buffer[0], length);
 
 		regs.pc = address;
 		return true;
@@ -1063,11 +1821,9 @@ public:
 		}
 
 		SetFilePointer(pImageInfo->hFile,128,NULL,FILE_BEGIN);
-		ReadFile(pImageInfo->hFile, mem+address, length, &bytesread, NULL);
-
-		int loop = 192;
-		while (loop--)
-			*(memdirty+loop) = 0xFF;
+		std::vector<BYTE> buffer(length);
+		ReadFile(pImageInfo->hFile, &buffer[0], length, &bytesread, NULL);
+		MemWriteBlock(address, &buffer[0], length);
 
 		regs.pc = address;
 		return true;
@@ -1579,47 +2335,57 @@ void CImageHelperBase::GetCharLowerExt2(TCHAR* pszExt, LPCTSTR pszImageFilename,
 
 //-----------------
 
+// Get the uncompressed size from the gzip trailer's ISIZE field, rather than inflating the whole image just to measure it
+// . NB. ISIZE is the size mod 2^32 (fine, as images are much smaller), and assumes a single-member gzip file (as created by gzip)
+static UINT GetGZipUncompressedSize(LPCTSTR pszImageFilename)
+{
+	HANDLE hFile = CreateFile(pszImageFilename, GENERIC_READ, FILE_SHARE_READ, (LPSECURITY_ATTRIBUTES)NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return 0;
+
+	const UINT kMinGZipFileSize = 18;	// 10-byte header + 8-byte trailer (CRC32, ISIZE)
+	const DWORD dwFileSize = GetFileSize(hFile, NULL);
+
+	UINT32 uISize = 0;
+	if (dwFileSize == INVALID_FILE_SIZE || dwFileSize < kMinGZipFileSize || !ReadFileAt(hFile, dwFileSize - sizeof(uISize), (LPBYTE)&uISize, sizeof(uISize)))
+		uISize = 0;
+
+	CloseHandle(hFile);
+	return uISize;
+}
+
+//-----------------
+
 ImageError_e CImageHelperBase::CheckGZipFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo)
 {
+	GetImageWriteBack().WaitUntilIdle();	// this image may have just been ejected and still be being written back
+
 	gzFile hGZFile = gzopen(pszImageFilename, "rb");
 	if (hGZFile == NULL)
 		return eIMAGE_ERROR_UNABLE_TO_OPEN_GZ;
 
-	// determine uncompressed file length
-	UINT fileSize = 0;
-	{
-		const UINT tempBufferSize = 256 * 1024;
-		BYTE* tempBuffer = new BYTE[tempBufferSize];
-		while (int len = gzread(hGZFile, tempBuffer, tempBufferSize))
-			fileSize += len;
-		delete[] tempBuffer;
-		int res = gzrewind(hGZFile);
-		if (res != 0)
-			return eIMAGE_ERROR_GZ;
-	}
+	pImageInfo->hGZFile = hGZFile;	// closed once the image is fully inflated, or by Close()
 
+	const UINT fileSize = GetGZipUncompressedSize(pszImageFilename);
 	if (fileSize == 0 || fileSize > GetMaxImageSize())
 		return eIMAGE_ERROR_BAD_SIZE;
 
 	pImageInfo->pImageBuffer = new BYTE[fileSize];
+	pImageInfo->uImageSize = fileSize;
 
-	int nLen = gzread(hGZFile, pImageInfo->pImageBuffer, fileSize);
-	int nRes = gzclose(hGZFile);	// close before returning (due to error) to avoid resource leak
-	hGZFile = NULL;
-
-	if (nLen <= 0)
+	// Only inflate what Detect() needs - the rest is inflated on demand
+	bool bTempDetectBuffer;
+	const UINT uDetectSize = GetMinDetectSize(fileSize, &bTempDetectBuffer);
+	if (!CImageBase::InflateImageBuffer(pImageInfo, uDetectSize))
 		return eIMAGE_ERROR_BAD_SIZE;
 
-	if (nRes != Z_OK)
-		return eIMAGE_ERROR_GZ;
-
 	//
 
 	// Strip .gz then try to determine the file's extension and convert it to lowercase
 	TCHAR szExt[_MAX_EXT] = "";
 	GetCharLowerExt2(szExt, pszImageFilename, _MAX_EXT);
 
-	DWORD dwSize = nLen;
+	DWORD dwSize = fileSize;
 	DWORD dwOffset = 0;
 	CImageBase* pImageType = Detect(pImageInfo->pImageBuffer, dwSize, szExt, dwOffset, pImageInfo);
 
@@ -1638,6 +2404,8 @@ ImageError_e CImageHelperBase::CheckGZipFile(LPCTSTR pszImageFilename, ImageInfo
 
 ImageError_e CImageHelperBase::CheckZipFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo, std::string& strFilenameInZip)
 {
+	GetImageWriteBack().WaitUntilIdle();	// this image may have just been ejected and still be being written back
+
 	unzFile hZipFile = unzOpen(pszImageFilename);
 	if (hZipFile == NULL)
 		return eIMAGE_ERROR_UNABLE_TO_OPEN_ZIP;
@@ -1689,8 +2457,12 @@ ImageError_e CImageHelperBase::CheckZipFile(LPCTSTR pszImageFilename, ImageInfo*
 			if (nRes != UNZ_OK)
 				throw eIMAGE_ERROR_ZIP;
 
+			// Only inflate what Detect() needs - the rest of the selected image is inflated on demand
+			bool bTempDetectBuffer;
+			const UINT uDetectSize = GetMinDetectSize(uFileSize, &bTempDetectBuffer);
+
 			BYTE* pImageBuffer = new BYTE[uFileSize];
-			int nLen = unzReadCurrentFile(hZipFile, pImageBuffer, uFileSize);
+			int nLen = unzReadCurrentFile(hZipFile, pImageBuffer, uDetectSize);
 			if (nLen < 0)
 			{
 				unzCloseCurrentFile(hZipFile);	// Must CloseCurrentFile before Close
@@ -1705,7 +2477,7 @@ ImageError_e CImageHelperBase::CheckZipFile(LPCTSTR pszImageFilename, ImageInfo*
 			TCHAR szExt[_MAX_EXT] = "";
 			GetCharLowerExt(szExt, szFilename, _MAX_EXT);
 
-			DWORD dwSize = nLen;
+			DWORD dwSize = ((UINT)nLen < uDetectSize) ? nLen : uFileSize;
 			DWORD dwOffset = 0;
 
 			ImageInfo*& pImageInfoForDetect = !pImageInfo2 ? pImageInfo : pImageInfo2;
@@ -1732,6 +2504,7 @@ ImageError_e CImageHelperBase::CheckZipFile(LPCTSTR pszImageFilename, ImageInfo*
 					strFilenameInZip = szFilename;
 
 					SetImageInfo(pImageInfo, eFileZip, dwOffset, pImageType, dwSize);
+					pImageInfo->uImageBufferValid = nLen;
 
 					pImageInfo2 = new ImageInfo();	// use this dummy one for remaining entries in zip archive, as some members get overwritten during Detect()
 				}
@@ -1773,6 +2546,24 @@ ImageError_e CImageHelperBase::CheckZipFile(LPCTSTR pszImageFilename, ImageInfo*
 	if (global_info.number_entry > 1)
 		pImageInfo->bWriteProtected = 1;	// Zip archives with multiple files are read-only (for now) - see WriteImageData() for zipfile
 
+	// Not fully inflated (eg. a HDD image), so re-open the image's entry to inflate the rest on demand
+	// . NB. inflating restarts from the beginning of the entry (only a few bytes were inflated for Detect())
+	if (pImageInfo->uImageBufferValid < pImageInfo->uImageSize)
+	{
+		unzFile hUnzFile = unzOpen(pszImageFilename);
+		if (hUnzFile == NULL)
+			return eIMAGE_ERROR_UNABLE_TO_OPEN_ZIP;
+
+		pImageInfo->hUnzFile = hUnzFile;	// closed once the image is fully inflated, or by Close()
+		pImageInfo->uImageBufferValid = 0;
+
+		if (unzLocateFile(hUnzFile, pImageInfo->szFilenameInZip.c_str(), 1) != UNZ_OK)
+			return eIMAGE_ERROR_ZIP;
+
+		if (unzOpenCurrentFile(hUnzFile) != UNZ_OK)
+			return eIMAGE_ERROR_ZIP;
+	}
+
 	pImageInfo->uNumValidImagesInZip = numValidImages;
 
 	return eIMAGE_ERROR_NONE;
@@ -1786,7 +2577,24 @@ ImageError_e CImageHelperBase::CheckNormalFile(LPCTSTR pszImageFilename, ImageIn
 
 	HANDLE& hFile = pImageInfo->hFile;
 
-	if (!pImageInfo->bWriteProtected)
+	// Overlay: open an existing base image read-only, and write to a delta file instead (see CImageOverlay)
+	// . NB. a new (or zero-length) image gets formatted, so isn't overlaid
+	bool bOverlay = false;
+	if (!pImageInfo->bWriteProtected && CImageOverlay::IsEnabled())
+	{
+		WIN32_FILE_ATTRIBUTE_DATA fileAttr;
+		bOverlay = GetFileAttributesEx(pszImageFilename, GetFileExInfoStandard, &fileAttr) && (fileAttr.nFileSizeLow || fileAttr.nFileSizeHigh);
+	}
+
+	if (bOverlay)
+	{
+		if (CImageOverlay::GetOpenAction() == eOVERLAY_OPEN_COMMIT)
+			CImageOverlay::Commit(pszImageFilename);
+		else if (CImageOverlay::GetOpenAction() == eOVERLAY_OPEN_DISCARD)
+			CImageOverlay::Discard(pszImageFilename);
+	}
+
+	if (!pImageInfo->bWriteProtected && !bOverlay)
 	{
 		hFile = CreateFile(pszImageFilename,
                       GENERIC_READ | GENERIC_WRITE,
@@ -1809,7 +2617,7 @@ ImageError_e CImageHelperBase::CheckNormalFile(LPCTSTR pszImageFilename, ImageIn
 			FILE_ATTRIBUTE_NORMAL,
 			NULL );
 		
-		if (hFile != INVALID_HANDLE_VALUE)
+		if (hFile != INVALID_HANDLE_VALUE && !bOverlay)
 			pImageInfo->bWriteProtected = true;
 	}
 
@@ -1837,6 +2645,17 @@ ImageError_e CImageHelperBase::CheckNormalFile(LPCTSTR pszImageFilename, ImageIn
 
 	if (dwSize > 0)
 	{
+		const DWORD dwBaseSize = dwSize;
+
+		if (bOverlay)
+		{
+			pImageInfo->pOverlay = new CImageOverlay;
+			if (!pImageInfo->pOverlay->Open(pszImageFilename, hFile, dwBaseSize))
+				return eIMAGE_ERROR_UNABLE_TO_OPEN;
+
+			dwSize = pImageInfo->pOverlay->GetImageSize();	// the delta may have extended the image
+		}
+
 		if (dwSize > GetMaxImageSize())
 			return eIMAGE_ERROR_BAD_SIZE;
 
@@ -1846,14 +2665,20 @@ ImageError_e CImageHelperBase::CheckNormalFile(LPCTSTR pszImageFilename, ImageIn
 		pImageInfo->pImageBuffer = new BYTE [dwSize];
 
 		DWORD dwBytesRead;
-		BOOL bRes = ReadFile(hFile, pImageInfo->pImageBuffer, dwSize, &dwBytesRead, NULL);
-		if (!bRes || dwSize != dwBytesRead)
+		BOOL bRes = ReadFile(hFile, pImageInfo->pImageBuffer, dwBaseSize, &dwBytesRead, NULL);
+		if (!bRes || dwBaseSize != dwBytesRead)
 		{
 			delete [] pImageInfo->pImageBuffer;
 			pImageInfo->pImageBuffer = NULL;
 			return eIMAGE_ERROR_BAD_SIZE;
 		}
 
+		if (pImageInfo->pOverlay)
+		{
+			memset(&pImageInfo->pImageBuffer[dwBaseSize], 0, dwSize - dwBaseSize);
+			pImageInfo->pOverlay->Patch(0, pImageInfo->pImageBuffer, dwSize);
+		}
+
 		pImageType = Detect(pImageInfo->pImageBuffer, dwSize, szExt, dwOffset, pImageInfo);
 		if (bTempDetectBuffer)
 		{
@@ -1971,7 +2796,8 @@ ImageError_e CImageHelperBase::Open(	LPCTSTR pszImageFilename,
 		Err = eIMAGE_ERROR_FAILED_TO_GET_PATHNAME;
 
     // Intercept write-enabled images to point to a local copy
-    if (!pImageInfo->bWriteProtected)
+    // . but not overlaid images, as their writes already go to a delta file
+    if (!pImageInfo->bWriteProtected && !pImageInfo->pOverlay)
     {
         // Create a local runtime copy or load an existing one
         HMODULE hModule = GetModuleHandle(NULL);
@@ -2042,6 +2868,14 @@ ImageError_e CImageHelperBase::Open(	LPCTSTR pszImageFilename,
 
 void CImageHelperBase::Close(ImageInfo* pImageInfo)
 {
+	CImageBase::FlushImageFile(pImageInfo);	// gzip/zip: queue any dirty image for write-back (NB. the write-back has its own copy of the image)
+	CImageBase::UnmapImageFile(pImageInfo);	// NB. before closing the file
+
+	delete pImageInfo->pOverlay;
+	pImageInfo->pOverlay = NULL;
+
+	CImageBase::CloseInflateStream(pImageInfo);
+
 	if (pImageInfo->hFile != INVALID_HANDLE_VALUE)
 	{
 		CloseHandle(pImageInfo->hFile);
@@ -2052,6 +2886,9 @@ void CImageHelperBase::Close(ImageInfo* pImageInfo)
 
 	delete [] pImageInfo->pImageBuffer;
 	pImageInfo->pImageBuffer = NULL;
+
+	delete [] pImageInfo->pNibblizedTracks;
+	pImageInfo->pNibblizedTracks = NULL;
 }
 
 //-------------------------------------
@@ -16,9 +16,21 @@ enum eDetectResult {eMismatch, ePossibleMatch, eMatch};
 
 class CImageBase;
 class CImageHelperBase;
+class CImageOverlay;
 
 enum FileType_e {eFileNormal, eFileGZip, eFileZip};
 
+// DO/PO only: a nibblized track, re-used until the track is written back to the image
+struct NibblizedTrack
+{
+	bool	bValid;
+	BYTE	sectorOrder;
+	BYTE	volumeNumber;
+	bool	enhanceDisk;
+	int		nibbles;
+	BYTE	trackImage[NIBBLES_PER_TRACK_DSK];
+};
+
 struct ImageInfo
 {
 	std::string 	szFilename;
@@ -40,6 +52,22 @@ struct ImageInfo
 	BYTE			optimalBitTiming;	// WOZ only
 	BYTE			bootSectorFormat;	// WOZ only
 	UINT			maxNibblesPerTrack;
+	NibblizedTrack*	pNibblizedTracks;	// DO/PO only (TRACKS_MAX entries, alloc'd on first track read)
+	// HDD only (eFileNormal): blocks are read/written via a view of the file (see CImageBase::MapImageFile())
+	HANDLE			hFileMapping;
+	BYTE*			pMappedView;
+	UINT			uMappedSize;
+	bool			bMappedViewDirty;
+	// gzip/zip only: pImageBuffer has writes not yet written back (see CImageWriteBack)
+	bool			bImageBufferDirty;
+	DWORD			dwImageBufferWriteTime;	// GetTickCount() of the last write
+	// gzip/zip only: pImageBuffer is only valid up to uImageBufferValid, the rest is inflated on demand (see CImageBase::InflateImageBuffer())
+	// . NB. floppy images are always fully inflated, as Detect() needs the whole image
+	gzFile			hGZFile;
+	void*			hUnzFile;			// unzFile
+	UINT			uImageBufferValid;
+	// eFileNormal only: base image is opened read-only and writes go to a per-instance delta file (see CImageOverlay)
+	CImageOverlay*	pOverlay;
 
 	ImageInfo();
 };
@@ -63,8 +91,10 @@ public:
 	virtual eDetectResult Detect(const LPBYTE pImage, const DWORD dwImageSize, const TCHAR* pszExt) = 0;
 	virtual void Read(ImageInfo* pImageInfo, const float phase, LPBYTE pTrackImageBuffer, int* pNibbles, UINT* pBitCount, bool enhanceDisk) { }
 	virtual bool Read(ImageInfo* pImageInfo, UINT nBlock, LPBYTE pBlockBuffer) { return false; }
+	virtual bool ReadBlocks(ImageInfo* pImageInfo, UINT nBlock, UINT nBlocks, LPBYTE pBlockBuffer) { return false; }	// Only: HDV
 	virtual void Write(ImageInfo* pImageInfo, const float phase, LPBYTE pTrackImageBuffer, int nNibbles) { }
 	virtual bool Write(ImageInfo* pImageInfo, UINT nBlock, LPBYTE pBlockBuffer) { return false; }
+	virtual bool ReadSector(ImageInfo* pImageInfo, const UINT track, const UINT physicalSector, LPBYTE pSectorBuffer) { return false; }	// Only: DO and PO
 
 	virtual bool AllowBoot(void) { return false; }		// Only:    APL and PRG
 	virtual bool AllowRW(void) { return true; }			// All but: APL and PRG
@@ -77,6 +107,7 @@ public:
 
 	bool WriteImageHeader(ImageInfo* pImageInfo, LPBYTE pHdr, const UINT hdrSize);
 	void SetVolumeNumber(const BYTE uVolumeNumber) { m_uVolumeNumber = uVolumeNumber; }
+	BYTE GetVolumeNumber(void) { return m_uVolumeNumber; }
 	bool IsValidImageSize(const DWORD uImageSize);
 
 	// To accurately convert a half phase (quarter track) back to a track (round half tracks down), use: ceil(phase)/2, eg:
@@ -86,12 +117,20 @@ public:
 
 	enum SectorOrder_e {eProDOSOrder, eDOSOrder, eSIMSYSTEMOrder, NUM_SECTOR_ORDERS};
 
+	static bool MapImageFile(ImageInfo* pImageInfo);
+	static void UnmapImageFile(ImageInfo* pImageInfo);
+	static bool FlushImageFile(ImageInfo* pImageInfo, const bool bIdleOnly=false);
+	static bool InflateImageBuffer(ImageInfo* pImageInfo, const UINT uSize);
+	static void CloseInflateStream(ImageInfo* pImageInfo);
+
 protected:
 	bool ReadTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTrackBuffer, const UINT uTrackSize);
+	bool ReadDenibblizedSector(ImageInfo* pImageInfo, const UINT track, const UINT physicalSector, SectorOrder_e SectorOrder, LPBYTE pSectorBuffer);
 	bool WriteTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTrackBuffer, const UINT uTrackSize);
-	bool ReadBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer);
+	bool ReadBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer, const UINT nBlocks=1);
 	bool WriteBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer);
 	bool WriteImageData(ImageInfo* pImageInfo, LPBYTE pSrcBuffer, const UINT uSrcSize, const long offset);
+	void ReadNibblizedTrack(ImageInfo* pImageInfo, const UINT track, SectorOrder_e SectorOrder, LPBYTE pTrackImageBuffer, int* pNibbles, const bool enhanceDisk);
 
 	LPBYTE Code62(int sector);
 	void Decode62(LPBYTE imageptr);
@@ -111,6 +150,116 @@ protected:
 
 //-------------------------------------
 
+// Background write-back for gzip/zip images
+// . writes just update the (uncompressed) ImageInfo::pImageBuffer and mark it dirty
+// . on eject, exit, save-state or after an idle timeout, a copy of the image is queued to a worker thread
+// . the worker recompresses the image to a temp file, which then atomically replaces the original file
+class CImageWriteBack
+{
+public:
+	CImageWriteBack(void);
+	~CImageWriteBack(void) {}
+
+	void Queue(const ImageInfo* pImageInfo);
+	void WaitUntilIdle(void);
+	void Shutdown(void);
+
+	UINT GetIdleTimeout(void) { return m_idleTimeoutMs; }
+	void SetIdleTimeout(const UINT ms) { m_idleTimeoutMs = ms; }
+
+private:
+	struct Job
+	{
+		FileType_e fileType;
+		std::string szFilename;
+		std::string szFilenameInZip;
+		zip_fileinfo zipFileInfo;
+		std::vector<BYTE> image;
+	};
+
+	static DWORD WINAPI WriteBackThread(LPVOID lpParameter);
+	static bool WriteImage(const Job& job);
+
+	std::deque<Job*> m_jobs;
+	bool m_jobActive;
+	bool m_quit;
+	UINT m_idleTimeoutMs;
+	HANDLE m_hThread;
+	HANDLE m_hJobEvent;
+	CRITICAL_SECTION m_criticalSection;
+};
+
+CImageWriteBack& GetImageWriteBack(void);
+
+//-------------------------------------
+
+// Copy-on-write overlay for a (read-only, shared) base image
+// . eg. many emulator instances booting the same master image, each with its own overlay directory
+// . writes go to a sparse delta file "<overlay dir>\<image name>.delta", as a list of fixed-size chunks
+// . reads are from the base image, then patched with any chunks in the delta
+class CImageOverlay
+{
+public:
+	CImageOverlay(void);
+	~CImageOverlay(void);
+
+	bool Open(const std::string& baseFilename, HANDLE hBaseFile, const UINT baseSize);
+	void Close(void);
+	UINT GetImageSize(void) { return m_imageSize; }
+
+	void Patch(const UINT offset, LPBYTE pBuffer, const UINT size);
+	bool Read(const UINT offset, LPBYTE pBuffer, const UINT size);
+	bool Write(const UINT offset, const BYTE* pBuffer, const UINT size);
+
+	static bool IsEnabled(void) { return !ms_directory.empty(); }
+	static void SetDirectory(const std::string& directory) { ms_directory = directory; }
+	static void SetOpenAction(const ImageOverlayOpen_e openAction) { ms_openAction = openAction; }
+	static ImageOverlayOpen_e GetOpenAction(void) { return ms_openAction; }
+
+	static bool Commit(const std::string& baseFilename);
+	static bool Discard(const std::string& baseFilename);
+
+private:
+	static const UINT kChunkSize = HD_BLOCK_SIZE;	// a DSK track is 8 chunks, a HDD block is 1 chunk
+
+#pragma pack(push, 1)
+	struct DeltaHeader
+	{
+		char id[8];		// "AWDELTA"
+		UINT32 version;
+		UINT32 chunkSize;
+		UINT32 baseSize;	// size of the base image when the delta was created
+		UINT32 imageSize;	// size of the image (can be larger than the base image, eg. HDD blocks appended)
+		UINT64 baseWriteTime;			// last write time (FILETIME) of the base image when the delta was created
+		char basePathname[MAX_PATH];	// full pathname of the base image
+	};
+#pragma pack(pop)
+
+	static const UINT32 kDeltaVersion = 2;	// v2: added base image's write time & pathname
+
+	// Each chunk record in the delta file is: UINT32 chunk index, then kChunkSize bytes
+	static const UINT kRecordSize = sizeof(UINT32) + kChunkSize;
+
+	static std::string GetDeltaFilename(const std::string& baseFilename);
+	static bool ReadDelta(HANDLE hDeltaFile, DeltaHeader& hdr, std::map<UINT, UINT>& chunks);
+	static bool IsDeltaForBase(DeltaHeader& hdr, const std::string& basePathname, HANDLE hBaseFile);
+	bool ReadBase(const UINT offset, LPBYTE pBuffer, const UINT size);
+	bool WriteHeader(void);
+
+	HANDLE m_hBaseFile;		// NB. owned by ImageInfo
+	HANDLE m_hDeltaFile;
+	std::string m_basePathname;	// full pathname
+	UINT64 m_baseWriteTime;
+	UINT m_baseSize;
+	UINT m_imageSize;
+	std::map<UINT, UINT> m_chunks;	// chunk index -> offset of chunk's data in delta file
+
+	static std::string ms_directory;
+	static ImageOverlayOpen_e ms_openAction;
+};
+
+//-------------------------------------
+
 class CHdrHelper
 {
 public:
@@ -154,7 +154,120 @@ Overview
       sound card in slot 7 is a generally bad idea) will cause problems.
 */
 
+//===========================================================================
+
+void HardDiskBlockCache::Clear(void)
+{
+	Invalidate();
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void HardDiskBlockCache::Invalidate(void)
+{
+	m_blockToEntry.clear();
+	for (UINT i = 0; i < m_entries.size(); i++)
+		m_entries[i].lastUse = 0;
+	m_useCount = 0;
+	m_nextBlock = 0;
+	m_readAhead = 0;
+}
+
+// Get an entry for this block, evicting the least recently used block if necessary
+HardDiskBlockCache::Entry* HardDiskBlockCache::Insert(const UINT block)
+{
+	if (m_entries.empty())
+		m_entries.resize(kNumEntries);
+
+	UINT lru = 0;
+	for (UINT i = 1; i < kNumEntries; i++)
+	{
+		if (m_entries[i].lastUse < m_entries[lru].lastUse)
+			lru = i;
+	}
+
+	Entry& entry = m_entries[lru];
+	if (entry.lastUse)
+		m_blockToEntry.erase(entry.block);
+
+	entry.block = block;
+	entry.lastUse = ++m_useCount;
+	entry.readAhead = false;
+	m_blockToEntry[block] = lru;
+	return &entry;
+}
+
+bool HardDiskBlockCache::Read(ImageInfo* const pImageInfo, const UINT block, LPBYTE pBlockBuffer)
+{
+	const bool isSequential = (block == m_nextBlock);
+	m_nextBlock = block + 1;
+
+	std::map<UINT, UINT>::const_iterator it = m_blockToEntry.find(block);
+	if (it != m_blockToEntry.end())
+	{
+		Entry& entry = m_entries[it->second];
+		if (entry.readAhead)
+		{
+			entry.readAhead = false;
+			m_stats.readAheadHits++;
+		}
+		entry.lastUse = ++m_useCount;
+		memcpy(pBlockBuffer, entry.data, HD_BLOCK_SIZE);
+		m_stats.hits++;
+		return true;
+	}
+
+	m_stats.misses++;
+
+	if (!isSequential)
+		m_readAhead = 0;
+	else
+		m_readAhead = m_readAhead ? std::min<UINT>(m_readAhead * 2, kMaxReadAhead) : kMinReadAhead;
+
+	// Read the block & any read-ahead blocks in one go (but not past the end of the image)
+	const UINT imageBlocks = ImageGetImageSize(pImageInfo) / HD_BLOCK_SIZE;
+	UINT numBlocks = 1;
+	if (block < imageBlocks)
+		numBlocks += std::min<UINT>(m_readAhead, imageBlocks - block - 1);
+
+	if (m_readBuffer.size() < numBlocks * HD_BLOCK_SIZE)
+		m_readBuffer.resize((1 + kMaxReadAhead) * HD_BLOCK_SIZE);
+
+	bool bRes = (numBlocks > 1) && ImageReadBlocks(pImageInfo, block, numBlocks, &m_readBuffer[0]);
+	if (!bRes)
+	{
+		numBlocks = 1;
+		bRes = ImageReadBlock(pImageInfo, block, &m_readBuffer[0]);
+	}
+
+	if (!bRes)
+		return false;
+
+	memcpy(pBlockBuffer, &m_readBuffer[0], HD_BLOCK_SIZE);
+	memcpy(Insert(block)->data, &m_readBuffer[0], HD_BLOCK_SIZE);
+
+	for (UINT i = 1; i < numBlocks; i++)
+	{
+		if (m_blockToEntry.find(block + i) != m_blockToEntry.end())
+			continue;	// already cached (and the image is the same, since writes are write-through)
+
+		Entry* pEntry = Insert(block + i);
+		memcpy(pEntry->data, &m_readBuffer[i * HD_BLOCK_SIZE], HD_BLOCK_SIZE);
+		pEntry->readAhead = true;
+		m_stats.readAheadBlocks++;
+	}
+
+	return true;
+}
 
+// Pre: block has been successfully written to the image
+void HardDiskBlockCache::Write(const UINT block, const BYTE* pBlockBuffer)
+{
+	std::map<UINT, UINT>::const_iterator it = m_blockToEntry.find(block);
+	if (it != m_blockToEntry.end())
+		memcpy(m_entries[it->second].data, pBlockBuffer, HD_BLOCK_SIZE);
+}
+
+//===========================================================================
 
 HarddiskInterfaceCard::HarddiskInterfaceCard(UINT slot) :
 	Card(CT_GenericHDD, slot), m_userNumBlocks(0), m_isFirmwareV1or2(false), m_useHdcFirmwareV1(false), m_useHdcFirmwareV2(false), m_useHdcFirmwareMode(HdcDefault)
@@ -178,6 +291,7 @@ HarddiskInterfaceCard::HarddiskInterfaceCard(UINT slot) :
 
 	// Interface busy doing DMA for r/w when current cycle is earlier than this cycle
 	m_notBusyCycle = 0;
+	m_lastFlushCycle = 0;
 
 	m_saveStateFirmwareV1 = false;
 	m_saveStateFirmwareV2 = false;
@@ -199,6 +313,27 @@ void HarddiskInterfaceCard::Reset(const bool powerCycle)
 	m_fifoIdx = 0;
 }
 
+void HarddiskInterfaceCard::Update(const ULONG nExecutedCycles)
+{
+	// Periodically write back blocks written to memory-mapped images, so a crash doesn't lose more than ~1s of writes
+	// . and gzip/zip images, once they've been idle for the write-back idle timeout
+	const UINT64 FLUSH_CYCLES = 1000 * 1000;	// ~1s
+	if (g_nCumulativeCycles - m_lastFlushCycle < FLUSH_CYCLES)
+		return;
+
+	m_lastFlushCycle = g_nCumulativeCycles;
+	FlushImages(true);
+}
+
+void HarddiskInterfaceCard::FlushImages(const bool bIdleOnly/*=false*/)
+{
+	for (UINT i = 0; i < NUM_HARDDISKS; i++)
+	{
+		if (m_hardDiskDrive[i].m_imageloaded)
+			ImageFlush(m_hardDiskDrive[i].m_imagehandle, bIdleOnly);
+	}
+}
+
 //===========================================================================
 
 void HarddiskInterfaceCard::InitializeIO(LPBYTE pCxRomPeripheral)
@@ -272,6 +407,7 @@ void HarddiskInterfaceCard::CleanupDriveInternal(const int iDrive)
 	}
 
 	m_hardDiskDrive[iDrive].m_imageloaded = false;
+	m_hardDiskDrive[iDrive].m_blockCache.Clear();
 
 	m_hardDiskDrive[iDrive].m_imagename.clear();
 	m_hardDiskDrive[iDrive].m_fullname.clear();
@@ -441,7 +577,7 @@ bool HarddiskInterfaceCard::Insert(const int iDrive, const std::string& pathname
 	if (dwAttributes == INVALID_FILE_ATTRIBUTES)
 		m_hardDiskDrive[iDrive].m_bWriteProtected = false;	// File doesn't exist - so ImageOpen() below will fail
 	else
-		m_hardDiskDrive[iDrive].m_bWriteProtected = (dwAttributes & FILE_ATTRIBUTE_READONLY) ? true : false;
+		m_hardDiskDrive[iDrive].m_bWriteProtected = ((dwAttributes & FILE_ATTRIBUTE_READONLY) && !ImageIsOverlayEnabled()) ? true : false;	// overlay: a read-only base image is fine
 
 	// Check if image is being used by the other HDD, and unplug it in order to be swapped
 	{
@@ -469,7 +605,11 @@ bool HarddiskInterfaceCard::Insert(const int iDrive, const std::string& pathname
 		m_hardDiskDrive[iDrive].m_strFilenameInZip,	// TODO: Use this
 		bExpectFloppy);
 
+	if (Error == eIMAGE_ERROR_NONE)
+		ImageMapFile(m_hardDiskDrive[iDrive].m_imagehandle);
+
 	m_hardDiskDrive[iDrive].m_imageloaded = (Error == eIMAGE_ERROR_NONE);
+	m_hardDiskDrive[iDrive].m_blockCache.Clear();
 
 	m_hardDiskDrive[iDrive].m_status_next = DISK_STATUS_OFF;
 	m_hardDiskDrive[iDrive].m_status_prev = DISK_STATUS_OFF;
@@ -723,22 +863,23 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD)
 		{
 			bool breakpointHit = false;
 
-			bool bRes = ImageReadBlock(pHDD->m_imagehandle, pHDD->m_diskblock, pHDD->m_buf);
+			bool bRes = pHDD->m_blockCache.Read(pHDD->m_imagehandle, pHDD->m_diskblock, pHDD->m_buf);
 			if (bRes)
 			{
 				pHDD->m_buf_ptr = 0;
 
 				// Apple II's MMU could be setup so that read & write memory is different,
-				// so can't use 'mem' (like we can for HDD block writes)
+				// so can't use memread[] (like we can for HDD block writes)
 				WORD dstAddr = pHDD->m_memblock;
 				UINT remaining = HD_BLOCK_SIZE;
 				BYTE* pSrc = pHDD->m_buf;
 
 				while (remaining)
 				{
-					memdirty[dstAddr >> 8] = 0xFF;
 					LPBYTE page = memwrite[dstAddr >> 8];
-					if (!page)	// I/O space or ROM
+					if (!page)
+						page = MemWriteTrap(dstAddr);	// 1st write to a clean page
+					if (!page || page == memWriteSink)	// I/O space or ROM
 					{
 						if (g_nAppMode == MODE_STEPPING)
 							DebuggerBreakOnDmaToOrFromIoMemory(dstAddr, true);	//  GH#1007
@@ -841,7 +982,7 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD)
 					if (g_nAppMode == MODE_STEPPING)
 						breakpointHit = DebuggerCheckMemBreakpoints(srcAddr, size, false);
 
-					memcpy(pDst, mem + srcAddr, size);
+					memcpy(pDst, MemGetReadPtr(srcAddr), size);
 					pDst += size;
 					srcAddr = (srcAddr + size) & (MEMORY_LENGTH - 1);	// wraps at 64KiB boundary
 
@@ -852,6 +993,9 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD)
 			if (bRes)
 				bRes = ImageWriteBlock(pHDD->m_imagehandle, pHDD->m_diskblock, pHDD->m_buf);
 
+			if (bRes)
+				pHDD->m_blockCache.Write(pHDD->m_diskblock, pHDD->m_buf);
+
 			if (bRes)
 			{
 				pHDD->m_error = DEVICE_OK;
@@ -881,6 +1025,7 @@ BYTE HarddiskInterfaceCard::CmdExecute(HardDiskDrive* pHDD)
 			const UINT numBlocks = GetImageSizeInBlocks(pHDD->m_imagehandle);
 			memset(pHDD->m_buf, 0, HD_BLOCK_SIZE);
 			bool res = false;
+			pHDD->m_blockCache.Invalidate();
 			m_notBusyCycle = g_nCumulativeCycles;
 
 			for (UINT block = 0; block < numBlocks; block++)
@@ -1068,21 +1213,20 @@ HardDiskDrive* HarddiskInterfaceCard::GetUnit(void)
 
 void HarddiskInterfaceCard::SetIdString(WORD addr, const char* str)
 {
-	BYTE& idStrLen = mem[addr];	// ID string length
+	BYTE idStr[1 + 16];
+	BYTE& idStrLen = idStr[0];	// ID string length
 	idStrLen = 0;
 
-	WORD idStrAddr = addr + 1;
 	for (UINT i = 0; i < 16; i++)
-		mem[idStrAddr + i] = ' ';	// ID string padded with ASCII spaces
+		idStr[1 + i] = ' ';	// ID string padded with ASCII spaces
 
-	if (str == NULL)
-		return;
-
-	while (*str && idStrLen < 16)
+	while (str && *str && idStrLen < 16)
 	{
 		idStrLen++;
-		mem[idStrAddr++] = *str++;
+		idStr[idStrLen] = *str++;
 	}
+
+	MemWriteDMA(addr, idStr, sizeof(idStr));
 }
 
 BYTE HarddiskInterfaceCard::SmartPortCmdStatus(HardDiskDrive* pHDD)
@@ -1112,19 +1256,19 @@ BYTE HarddiskInterfaceCard::SmartPortCmdStatus(HardDiskDrive* pHDD)
 		case SP_Cmd_status_GETDIB:
 		{
 			// SmartPort driver status (8 bytes)
-			mem[statusListAddr++] = numDevices;
+			MemWriteDMA(statusListAddr++, numDevices);
 			for (UINT i = 0; i < 7; i++)
-				mem[statusListAddr++] = 0;	// reserved
+				MemWriteDMA(statusListAddr++, 0);	// reserved
 			if (m_statusCode == SP_Cmd_status_STATUS)
 				break;
 			// Device Information Block (DIB)
 			std::string idStr = "AppleWin SP";
 			SetIdString(statusListAddr, idStr.c_str());
 			statusListAddr += 17;
-			mem[statusListAddr++] = 0x00;	// device type (0x00: Apple II memory expansion card)
-			mem[statusListAddr++] = 0x00;	// device subtype (0x00: Apple II memory expansion card)
-			mem[statusListAddr++] = fwVerMajor;	// f/w version (major)
-			mem[statusListAddr++] = fwVerMinor;	// f/w version (minor)
+			MemWriteDMA(statusListAddr++, 0x00);	// device type (0x00: Apple II memory expansion card)
+			MemWriteDMA(statusListAddr++, 0x00);	// device subtype (0x00: Apple II memory expansion card)
+			MemWriteDMA(statusListAddr++, fwVerMajor);	// f/w version (major)
+			MemWriteDMA(statusListAddr++, fwVerMinor);	// f/w version (minor)
 			break;
 		}
 		case SP_Cmd_status_GETDCB:
@@ -1150,12 +1294,12 @@ BYTE HarddiskInterfaceCard::SmartPortCmdStatus(HardDiskDrive* pHDD)
 			// . b3=format allowed, b2=media write protected (block devices only), b1=device currently interrupting (//c only), b0=device currently open (char device only)
 			BYTE generalStatus = isImageLoaded ? 0xF8 : 0xE8;			// Loaded: b#11111000: bwrlf--- / Not loaded: b#11101000: bwr-f---
 			if (pHDD->m_bWriteProtected) generalStatus |= (1 << 2);
-			mem[statusListAddr++] = generalStatus;
+			MemWriteDMA(statusListAddr++, generalStatus);
 
 			const UINT imageSizeInBlocks = isImageLoaded ? GetImageSizeInBlocks(pHDD->m_imagehandle) : 0;
-			mem[statusListAddr++] = imageSizeInBlocks & 0xff;			// num blocks (lo)
-			mem[statusListAddr++] = (imageSizeInBlocks >> 8) & 0xff;	// num blocks (med)
-			mem[statusListAddr++] = (imageSizeInBlocks >> 16) & 0xff;	// num blocks (hi)
+			MemWriteDMA(statusListAddr++, imageSizeInBlocks & 0xff);			// num blocks (lo)
+			MemWriteDMA(statusListAddr++, (imageSizeInBlocks >> 8) & 0xff);	// num blocks (med)
+			MemWriteDMA(statusListAddr++, (imageSizeInBlocks >> 16) & 0xff);	// num blocks (hi)
 
 			if (m_statusCode == SP_Cmd_status_STATUS)
 				break;
@@ -1166,10 +1310,10 @@ BYTE HarddiskInterfaceCard::SmartPortCmdStatus(HardDiskDrive* pHDD)
 			idStr += (char)('0' + m_unitNum % 10);
 			SetIdString(statusListAddr, idStr.c_str());
 			statusListAddr += 17;
-			mem[statusListAddr++] = 0x02;	// device type (0x02: Hard disk)
-			mem[statusListAddr++] = 0x20;	// device subtype (0x20: Hard disk)
-			mem[statusListAddr++] = fwVerMajor;	// f/w version (major)
-			mem[statusListAddr++] = fwVerMinor;	// f/w version (minor)
+			MemWriteDMA(statusListAddr++, 0x02);	// device type (0x02: Hard disk)
+			MemWriteDMA(statusListAddr++, 0x20);	// device subtype (0x20: Hard disk)
+			MemWriteDMA(statusListAddr++, fwVerMajor);	// f/w version (major)
+			MemWriteDMA(statusListAddr++, fwVerMinor);	// f/w version (minor)
 			break;
 		}
 		case SP_Cmd_status_GETDCB:
@@ -1293,6 +1437,9 @@ void HarddiskInterfaceCard::SaveSnapshotHDDUnit(YamlSaveHelper& yamlSaveHelper,
 
 void HarddiskInterfaceCard::SaveSnapshot(YamlSaveHelper& yamlSaveHelper)
 {
+	if (!yamlSaveHelper.IsSavingToMemory())	// NB. not for rewind snapshots (these don't reference the image files)
+		FlushImages();	// so the image files are consistent with the save-state
+
 	YamlSaveHelper::Slot slot(yamlSaveHelper, GetSnapshotCardName(), m_slot, kUNIT_VERSION);
 
 	YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
@@ -1305,7 +1452,7 @@ void HarddiskInterfaceCard::SaveSnapshot(YamlSaveHelper& yamlSaveHelper)
 	// New label
 	{
 		YamlSaveHelper::Label buffer(yamlSaveHelper, "%s:\n", SS_YAML_KEY_FIRMWARE);
-		yamlSaveHelper.SaveMemory(mem + APPLE_IO_BEGIN + m_slot * APPLE_SLOT_SIZE, APPLE_SLOT_SIZE);
+		yamlSaveHelper.SaveMemory(MemGetReadPtr(APPLE_IO_BEGIN + m_slot * APPLE_SLOT_SIZE), APPLE_SLOT_SIZE);
 	}
 
 	for (UINT i = 0; i < NUM_HARDDISKS; i++)
@@ -1321,16 +1468,27 @@ bool HarddiskInterfaceCard::LoadSnapshotHDDUnit(YamlLoadHelper& yamlLoadHelper,
 
 	std::string hddUnitName = std::string(SS_YAML_KEY_HDDUNIT) + (char)('0' + baseUnitNum + unit);
 	if (!yamlLoadHelper.GetSubMap(hddUnitName))
+	{
+		Unplug(unit);	// In-place: unplug any HDD that's not in the save-state
 		return false;	// No HDD plugged in for this unit#
+	}
 
-	m_hardDiskDrive[unit].m_fullname.clear();
-	m_hardDiskDrive[unit].m_imagename.clear();
-	m_hardDiskDrive[unit].m_imageloaded = false;	// Default to false (until image is successfully loaded below)
+	const std::string simpleFilename = yamlLoadHelper.LoadString(SS_YAML_KEY_FILENAME);
+	const std::string absolutePath = version >= 6 ? yamlLoadHelper.LoadString(SS_YAML_KEY_ABSOLUTE_PATH) : "";
+
+	// In-place (eg. rewind) and it's the same image: keep it plugged in
+	const bool keepImage = yamlLoadHelper.IsLoadingFromMemory() && m_hardDiskDrive[unit].m_imageloaded
+							&& absolutePath == ImageGetPathname(m_hardDiskDrive[unit].m_imagehandle);
+	if (!keepImage)
+	{
+		Unplug(unit);
+		m_hardDiskDrive[unit].m_fullname.clear();
+		m_hardDiskDrive[unit].m_imagename.clear();
+		m_hardDiskDrive[unit].m_imageloaded = false;	// Default to false (until image is successfully loaded below)
+	}
 	m_hardDiskDrive[unit].m_status_next = DISK_STATUS_OFF;
 	m_hardDiskDrive[unit].m_status_prev = DISK_STATUS_OFF;
 
-	const std::string simpleFilename = yamlLoadHelper.LoadString(SS_YAML_KEY_FILENAME);
-	const std::string absolutePath = version >= 6 ? yamlLoadHelper.LoadString(SS_YAML_KEY_ABSOLUTE_PATH) : "";
 	m_hardDiskDrive[unit].m_error = yamlLoadHelper.LoadUint(SS_YAML_KEY_ERROR);
 	m_hardDiskDrive[unit].m_memblock = yamlLoadHelper.LoadUint(SS_YAML_KEY_MEMBLOCK);
 	m_hardDiskDrive[unit].m_diskblock = yamlLoadHelper.LoadUint(SS_YAML_KEY_DISKBLOCK);
@@ -1352,6 +1510,13 @@ bool HarddiskInterfaceCard::LoadSnapshotHDDUnit(YamlLoadHelper& yamlLoadHelper,
 
 	bool userSelectedImageFolder = false;
 
+	if (keepImage)
+	{
+		m_hardDiskDrive[unit].m_status_next = diskStatusNext;
+		m_hardDiskDrive[unit].m_status_prev = diskStatusPrev;
+		return false;
+	}
+
 	std::string filename = simpleFilename;
 	if (!filename.empty())
 	{
@@ -1440,17 +1605,21 @@ bool HarddiskInterfaceCard::LoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT ve
 	}
 
 	// Unplug all HDDs first in case eg. HDD-2 is to be plugged in as HDD-1
-	for (UINT i = 0; i < NUM_HARDDISKS; i++)
+	// . except in-place (eg. rewind): LoadSnapshotHDDUnit() keeps an HDD that's still in the same unit
+	if (!yamlLoadHelper.IsLoadingFromMemory())
 	{
-		Unplug(i);
-		m_hardDiskDrive[i].clear();
+		for (UINT i = 0; i < NUM_HARDDISKS; i++)
+		{
+			Unplug(i);
+			m_hardDiskDrive[i].clear();
+		}
 	}
 
 	bool userSelectedImageFolder = false;
 	for (UINT i = 0; i < NUM_HARDDISKS; i++)
 		userSelectedImageFolder |= LoadSnapshotHDDUnit(yamlLoadHelper, i, version);
 
-	if (!userSelectedImageFolder)
+	if (!userSelectedImageFolder && !yamlLoadHelper.IsLoadingFromMemory())
 		RegSaveString(TEXT(REG_PREFS), TEXT(REGVALUE_PREF_HDV_START_DIR), 1, Snapshot_GetPath());
 
 	GetFrame().FrameRefreshStatus(DRAW_LEDS | DRAW_DISK_STATUS);
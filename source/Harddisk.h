@@ -46,6 +46,53 @@ enum HdcMode
 const UINT kHarddiskMaxNumBlocks = 0x007FFFFF;	// Maximum number of blocks we can report.
 const UINT kMaxSmartPortUnits = NUM_HARDDISKS;
 
+// Per-drive LRU cache of blocks read, with read-ahead for sequential reads
+// . write-through: writes still go straight to the image, and just update any cached copy of the block
+// . sequential read misses read ahead kMinReadAhead blocks, doubling (up to kMaxReadAhead) while the sequence continues
+class HardDiskBlockCache
+{
+public:
+	HardDiskBlockCache(void) { Clear(); }
+	~HardDiskBlockCache(void) {}
+
+	struct Stats
+	{
+		UINT64 hits;
+		UINT64 misses;
+		UINT64 readAheadBlocks;		// # blocks read ahead
+		UINT64 readAheadHits;		// # blocks read ahead that were then read
+	};
+
+	void Clear(void);	// Pre: new image (so also resets stats)
+	bool Read(ImageInfo* const pImageInfo, const UINT block, LPBYTE pBlockBuffer);
+	void Write(const UINT block, const BYTE* pBlockBuffer);
+	void Invalidate(void);
+	const Stats& GetStats(void) { return m_stats; }
+
+private:
+	static const UINT kNumEntries = 256;	// 128KiB per drive
+	static const UINT kMinReadAhead = 8;
+	static const UINT kMaxReadAhead = 64;
+
+	struct Entry
+	{
+		UINT block;
+		UINT64 lastUse;
+		bool readAhead;	// not yet read
+		BYTE data[HD_BLOCK_SIZE];
+	};
+
+	Entry* Insert(const UINT block);
+
+	std::vector<Entry> m_entries;		// allocated on 1st read
+	std::map<UINT, UINT> m_blockToEntry;
+	std::vector<BYTE> m_readBuffer;
+	UINT64 m_useCount;
+	UINT m_nextBlock;	// next block of a sequential read
+	UINT m_readAhead;	// 0 if the last read wasn't sequential
+	Stats m_stats;
+};
+
 class HardDiskDrive
 {
 public:
@@ -71,6 +118,7 @@ public:
 		memset(m_buf, 0, sizeof(m_buf));
 		m_status_next = DISK_STATUS_OFF;
 		m_status_prev = DISK_STATUS_OFF;
+		m_blockCache.Clear();
 	}
 
 	// From FloppyDisk
@@ -86,6 +134,7 @@ public:
 	WORD m_buf_ptr;
 	bool m_imageloaded;
 	BYTE m_buf[HD_BLOCK_SIZE];
+	HardDiskBlockCache m_blockCache;
 
 	Disk_Status_e m_status_next;
 	Disk_Status_e m_status_prev;
@@ -98,7 +147,7 @@ public:
 	virtual ~HarddiskInterfaceCard(void);
 
 	virtual void Reset(const bool powerCycle);
-	virtual void Update(const ULONG nExecutedCycles) {}
+	virtual void Update(const ULONG nExecutedCycles);
 
 	virtual void InitializeIO(LPBYTE pCxRomPeripheral);
 	virtual void Destroy(void);
@@ -116,6 +165,8 @@ public:
 
 	void GetLightStatus(Disk_Status_e* pDisk1Status);
 	bool ImageSwap(void);
+	bool IsDriveLoaded(const int iDrive) { return m_hardDiskDrive[iDrive].m_imageloaded; }
+	const HardDiskBlockCache::Stats& GetBlockCacheStats(const int iDrive) { return m_hardDiskDrive[iDrive].m_blockCache.GetStats(); }
 
 	static const std::string& GetSnapshotCardName(void);
 	virtual void SaveSnapshot(YamlSaveHelper& yamlSaveHelper);
@@ -141,6 +192,7 @@ private:
 	void SetIdString(WORD addr, const char* str);
 	BYTE SmartPortCmdStatus(HardDiskDrive* pHDD);
 	UINT GetImageSizeInBlocks(ImageInfo* const pImageInfo, const bool is16bit = false);
+	void FlushImages(const bool bIdleOnly = false);
 	void SaveSnapshotHDDUnit(YamlSaveHelper& yamlSaveHelper, const UINT unit);
 	bool LoadSnapshotHDDUnit(YamlLoadHelper& yamlLoadHelper, const UINT unit, const UINT version);
 
@@ -151,6 +203,7 @@ private:
 	BYTE m_fifoIdx;
 	BYTE m_statusCode;
 	UINT64 m_notBusyCycle;
+	UINT64 m_lastFlushCycle;
 	UINT m_userNumBlocks;
 	bool m_isFirmwareV1or2;
 	bool m_useHdcFirmwareV1;
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CardManager.h"
+#include "SynchronousEventManager.h"
+
+// Per-machine emulator state, that was previously held in process-wide singletons.
+// NB. There is currently only one Machine (see GetMachine()), as much of the core's state is still global:
+// . regs, mem[]/memwrite[]/memread[], IORead[]/IOWrite[], g_nCumulativeCycles, and the module statics.
+// These are to be moved in here, one module at a time.
+
+class Machine
+{
+public:
+	Machine(void) {}
+	~Machine(void) {}
+
+	CardManager& GetCardMgr(void) { return m_cardMgr; }
+	SynchronousEventManager& GetSynchronousEventMgr(void) { return m_syncEventMgr; }
+
+private:
+	// NB. m_syncEventMgr must be constructed before (and so destroyed after) m_cardMgr, since cards remove their events in their dtors
+	SynchronousEventManager m_syncEventMgr;
+	CardManager m_cardMgr;
+};
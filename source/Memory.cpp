@@ -174,6 +174,14 @@ SOFT SWITCH STATUS FLAGS
 // - physical contiguous 64KB "backing-store" for main & aux respectively
 // - NB. 4K bank1 BSR is at $C000-$CFFF
 //
+// memread
+// - 1 pointer entry per 256-byte page
+// - used by the CPU (and others) to read from a page (excludes $Cxxx I/O memory)
+// - normally memread[page] = mem+page*256 (and never changes)
+// - for pointer-based paging then memread[page] = memshadow[page], ie. points directly to the backing-store (or ROM)
+//		. 'mem' isn't used, and memwrite will point to the backing-store too (ie. never to 'mem')
+//		. so a paging change is just a pointer table update, with no 256-byte page copies
+//
 // memwrite
 // - 1 pointer entry per 256-byte page
 // - used to write to a page
@@ -181,16 +189,17 @@ SOFT SWITCH STATUS FLAGS
 //		. ie. when SW_AUXREAD==SW_AUXWRITE, or 4K-BSR is r/w, or 8K BSR is r/w, or SW_80STORE=1
 //		. So 'mem' remains correct for both r&w operations, but the physical 64K mem block becomes stale
 // - if RD & WR point to different 256-byte pages, then memwrite will point to the page in the physical 64K mem block
-//		. writes will still set the dirty flag (but can be ignored)
-//		. UpdatePaging() ignores this, as it only copies back to the physical 64K mem block when memshadow changes (for that 256-byte page)
+//		. writes don't set the dirty flag, as the backing-store is already up-to-date
+// - a clean page in 'mem' has memwrite = NULL (the write trap), so the 1st write to it calls MemWriteTrap()
+//		. this sets the page's dirty flag and restores memwrite, so subsequent writes take the fast path
 //
 // memdirty
-// - 1 byte entry per 256-byte page
-// - set when a write occurs to a 256-byte page
+// - a bitmap: 1 bit per 256-byte page
+// - set by the 1st write to a page in 'mem' since the last paging change (or by MemSetDirty())
 // - indicates that 'mem' (ie. the cache) is out-of-sync with the "physical" 64K backing-store memory
-// - NB. a page's dirty flag is only useful(valid) when 'mem' is used for both read & write for the corresponding page
+// - NB. only pages where 'mem' is used for both read & write get set by the CPU
 //   When they differ, then writes go directly to the backing-store.
-//   . In this case, the dirty flag will just force a memcpy() to the same address in backing-store.
+// - Page0 (ZP) and Page1 (stack) are never write trapped, and are always treated as dirty
 //
 // memshadow
 // - 1 pointer entry per 256-byte page
@@ -202,7 +211,9 @@ SOFT SWITCH STATUS FLAGS
 //
 
 static LPBYTE  memshadow[0x100];
+LPBYTE         memread[0x100];
 LPBYTE         memwrite[0x100];
+BYTE           memWriteSink[0x100];	// memwrite[] for ROM pages: the CPU's writes to ROM land here (and are never read)
 
 iofunction		IORead[256];
 iofunction		IOWrite[256];
@@ -215,7 +226,8 @@ LPBYTE         mem          = NULL;
 static LPBYTE  memaux       = NULL;
 static LPBYTE  memmain      = NULL;
 
-LPBYTE         memdirty     = NULL;
+static UINT32  memdirty[0x100/32];		// Bitmap: 1 bit per page
+static UINT32  memwritetrap[0x100/32];	// Bitmap: 1 bit per page (for clean pages in 'mem' with memwrite = NULL)
 static LPBYTE  memrom       = NULL;
 
 static LPBYTE  memimage     = NULL;
@@ -228,6 +240,9 @@ static LPBYTE g_pMemMainLanguageCard = NULL;
 static DWORD   g_memmode = LanguageCardUnit::kMemModeInitialState;
 static BOOL    modechanging = 0;				// An Optimisation: means delay calling UpdatePaging() for 1 instruction
 
+static bool    g_isPagingByPointerEnabled = false;	// User option: use pointer-based paging when running
+static bool    g_isPagingByPointer = false;			// Currently active: memread[] & memwrite[] point to the backing-store (not 'mem')
+
 static UINT    memrompages = 1;
 
 LPBYTE  memVidHD = NULL;	// For Apple II/II+ writes to aux mem (on VidHD card). memVidHD = memaux or NULL (depends on //e soft-switches)
@@ -786,6 +801,20 @@ static bool IsCardInSlot(UINT slot);
 // . Reset: On access to $CFFF or an MMU reset
 //
 
+// Map the 2K expansion ROM into [$C800..$CFFF] of the CPU's view of memory
+static void SetExpansionRomView(const LPBYTE pExpansionRom)
+{
+	if (g_isPagingByPointer)
+	{
+		for (UINT page = 0; page < FIRMWARE_EXPANSION_SIZE / 256; page++)
+			memread[(FIRMWARE_EXPANSION_BEGIN >> 8) + page] = pExpansionRom + page * 256;
+	}
+	else
+	{
+		memcpy(mem+FIRMWARE_EXPANSION_BEGIN, pExpansionRom, FIRMWARE_EXPANSION_SIZE);
+	}
+}
+
 static BYTE __stdcall IO_Cxxx(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nExecutedCycles)
 {
 	if (address == 0xCFFF)
@@ -800,7 +829,7 @@ static BYTE __stdcall IO_Cxxx(WORD programcounter, WORD address, BYTE write, BYT
 		{
 			// NB. SW_INTCXROM==1 ensures that internal rom stays switched in
 			memset(pCxRomPeripheral+0x800, 0, FIRMWARE_EXPANSION_SIZE);
-			memset(mem+FIRMWARE_EXPANSION_BEGIN, 0, FIRMWARE_EXPANSION_SIZE);
+			SetExpansionRomView(pCxRomPeripheral+0x800);
 			g_eExpansionRomType = eExpRomNull;
 		}
 
@@ -855,7 +884,7 @@ static BYTE __stdcall IO_Cxxx(WORD programcounter, WORD address, BYTE write, BYT
 			if (ExpansionRom[uSlot] && (g_uPeripheralRomSlot != uSlot))
 			{
 				memcpy(pCxRomPeripheral+0x800, ExpansionRom[uSlot], FIRMWARE_EXPANSION_SIZE);
-				memcpy(mem+FIRMWARE_EXPANSION_BEGIN, ExpansionRom[uSlot], FIRMWARE_EXPANSION_SIZE);
+				SetExpansionRomView(pCxRomPeripheral+0x800);
 				g_eExpansionRomType = eExpRomPeripheral;
 				g_uPeripheralRomSlot = uSlot;
 			}
@@ -864,7 +893,7 @@ static BYTE __stdcall IO_Cxxx(WORD programcounter, WORD address, BYTE write, BYT
 		{
 			// Enable Internal ROM
 			// . Get this for PR#3
-			memcpy(mem+FIRMWARE_EXPANSION_BEGIN, pCxRomInternal+0x800, FIRMWARE_EXPANSION_SIZE);
+			SetExpansionRomView(pCxRomInternal+0x800);
 			g_eExpansionRomType = eExpRomInternal;
 			g_uPeripheralRomSlot = 0;
 		}
@@ -896,7 +925,7 @@ static BYTE __stdcall IO_Cxxx(WORD programcounter, WORD address, BYTE write, BYT
 		if (INTC8ROM && (g_eExpansionRomType != eExpRomInternal))
 		{
 			// Enable Internal ROM
-			memcpy(mem+FIRMWARE_EXPANSION_BEGIN, pCxRomInternal+0x800, FIRMWARE_EXPANSION_SIZE);
+			SetExpansionRomView(pCxRomInternal+0x800);
 			g_eExpansionRomType = eExpRomInternal;
 			g_uPeripheralRomSlot = 0;
 		}
@@ -920,7 +949,7 @@ static BYTE __stdcall IO_Cxxx(WORD programcounter, WORD address, BYTE write, BYT
 	if ((g_eExpansionRomType == eExpRomNull) && (address >= FIRMWARE_EXPANSION_BEGIN))
 		return IO_Null(programcounter, address, write, value, nExecutedCycles);
 
-	return mem[address];
+	return *MemGetReadPtr(address);
 }
 
 BYTE __stdcall IO_F8xx(WORD programcounter, WORD address, BYTE write, BYTE value, ULONG nCycles)	// NSC for Apple II/II+ (GH#827)
@@ -935,12 +964,13 @@ BYTE __stdcall IO_F8xx(WORD programcounter, WORD address, BYTE write, BYTE value
 
 	if (!write)
 	{
-		return *(mem+address);
+		return *MemGetReadPtr(address);
 	}
 	else
 	{
-		memdirty[address >> 8] = 0xFF;
 		LPBYTE page = memwrite[address >> 8];
+		if (!page)
+			page = MemWriteTrap(address);
 		if (page)
 			*(page+(address & 0xFF)) = value;
 		return 0;
@@ -1136,6 +1166,7 @@ void SetMemMode(DWORD uNewMemMode)
 
 static void ResetPaging(BOOL initialize);
 static void UpdatePaging(BOOL initialize);
+static void BackMainImage(void);
 
 // Call by:
 // . CtrlReset() Soft-reset (Ctrl+Reset) for //e
@@ -1160,6 +1191,124 @@ void MemUpdatePaging(BOOL initialize)
 	UpdatePaging(initialize);
 }
 
+//===========================================================================
+
+// Pointer-based paging:
+// . memread[] & memwrite[] point directly to the backing-store pages, so a paging change (eg. RAMRD/RAMWRT, ALTZP, 80STORE, LC)
+//   is just a pointer table update, rather than copying 256-byte pages to & from 'mem'
+// . 'mem' becomes stale, so this is only active when running - the debugger (& single-stepping) still use the 'mem' cache
+
+void MemSetPagingByPointer(const bool enable)
+{
+	g_isPagingByPointerEnabled = enable;
+}
+
+bool MemIsPagingByPointer(void)
+{
+	return g_isPagingByPointer;
+}
+
+static void SetPagingByPointer(const bool enable)
+{
+	if (g_isPagingByPointer == enable || !mem)
+		return;
+
+	if (enable)
+		BackMainImage();	// Flush any dirty pages to back-buffer, as 'mem' is about to become stale
+
+	g_isPagingByPointer = enable;
+	UpdatePaging(TRUE);		// Either point to the backing-store, or refill 'mem' from it
+}
+
+// Called before executing any opcodes (and on entering the debugger)
+void MemUpdatePagingByPointer(void)
+{
+	SetPagingByPointer(g_isPagingByPointerEnabled && g_nAppMode == MODE_RUNNING);
+}
+
+//===========================================================================
+
+// Dirty page tracking (for copy-based paging)
+
+static inline bool IsPageSet(const UINT32* bitmap, const UINT page)
+{
+	return (bitmap[page >> 5] & (1u << (page & 31))) != 0;
+}
+
+static inline void SetPage(UINT32* bitmap, const UINT page)
+{
+	bitmap[page >> 5] |= 1u << (page & 31);
+}
+
+static inline void ClearPage(UINT32* bitmap, const UINT page)
+{
+	bitmap[page >> 5] &= ~(1u << (page & 31));
+}
+
+static inline UINT GetLowestSetBit(const UINT32 bits)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, bits);
+	return index;
+#else
+	return __builtin_ctz(bits);
+#endif
+}
+
+static void ClearDirtyPages(void)
+{
+	memset(memdirty, 0, sizeof(memdirty));
+}
+
+// Write trap any clean page that's r/w via 'mem', so that its 1st write will set the dirty flag
+static void ArmWriteTraps(void)
+{
+	for (UINT page = 0x02; page < 0x100; page++)	// Page0 & Page1 are always treated as dirty
+	{
+		if (memwrite[page] == mem+(page << 8) && !IsPageSet(memdirty, page))
+		{
+			memwrite[page] = NULL;
+			SetPage(memwritetrap, page);
+		}
+	}
+}
+
+static void DisarmWriteTrap(const UINT page)
+{
+	if (IsPageSet(memwritetrap, page))
+	{
+		ClearPage(memwritetrap, page);
+		memwrite[page] = mem+(page << 8);
+	}
+}
+
+// Called on a write to a page with memwrite = NULL
+// . returns the write page, or NULL if it's really not writeable (ie. I/O)
+LPBYTE MemWriteTrap(const WORD addr)
+{
+	const UINT page = addr >> 8;
+	if (!IsPageSet(memwritetrap, page))
+		return NULL;
+
+	DisarmWriteTrap(page);
+	SetPage(memdirty, page);
+	return memwrite[page];
+}
+
+// Use when writing directly to 'mem' (ie. not via memwrite), so that the page gets copied back to the backing-store
+void MemSetDirty(const WORD addr)
+{
+	const UINT page = addr >> 8;
+	if (g_isPagingByPointer || (page & 0xF0) == 0xC0)
+		return;	// 'mem' isn't used, or mem(cache) can't be dirty for ROM
+
+	DisarmWriteTrap(page);
+	SetPage(memdirty, page);
+}
+
+//===========================================================================
+
 static void UpdatePaging(BOOL initialize)
 {
 	modechanging = 0;
@@ -1169,6 +1318,8 @@ static void UpdatePaging(BOOL initialize)
 	if (!initialize)
 		memcpy(oldshadow,memshadow,256*sizeof(LPBYTE));
 
+	memset(memwritetrap, 0, sizeof(memwritetrap));	// memwrite[] gets recalculated below
+
 	// UPDATE THE PAGING TABLES BASED ON THE NEW PAGING SWITCH VALUES
 	UINT loop;
 	if (initialize)
@@ -1178,6 +1329,9 @@ static void UpdatePaging(BOOL initialize)
 
 		for (loop = 0xC0; loop < 0xD0; loop++)
 			memwrite[loop] = NULL;
+
+		for (loop = 0x00; loop < 0x100; loop++)
+			memread[loop] = mem+(loop << 8);
 	}
 
 	for (loop = 0x00; loop < 0x02; loop++)
@@ -1196,7 +1350,6 @@ static void UpdatePaging(BOOL initialize)
 
 	for (loop = 0xC0; loop < 0xC8; loop++)
 	{
-		memdirty[loop] = 0;	// mem(cache) can't be dirty for ROM (but STA $Csnn will set the dirty flag)
 		const UINT uSlotOffset = (loop & 0x0f) * 0x100;
 		if (loop == 0xC3)
 			memshadow[loop] = (SW_SLOTC3ROM && !SW_INTCXROM)	? pCxRomPeripheral+uSlotOffset	// C300..C3FF - Slot 3 ROM (all 0x00's)
@@ -1208,7 +1361,6 @@ static void UpdatePaging(BOOL initialize)
 
 	for (loop = 0xC8; loop < 0xD0; loop++)
 	{
-		memdirty[loop] = 0;	// mem(cache) can't be dirty for ROM (but STA $Cnnn will set the dirty flag)
 		const UINT uRomOffset = (loop & 0x0f) * 0x100;
 		memshadow[loop] = (!SW_INTCXROM && !INTC8ROM)	? pCxRomPeripheral+uRomOffset			// C800..CFFF - Peripheral ROM (GH#486)
 														: pCxRomInternal+uRomOffset;			// C800..CFFF - Internal ROM
@@ -1229,7 +1381,7 @@ static void UpdatePaging(BOOL initialize)
 		memwrite[loop]  = SW_WRITERAM	? SW_HIGHRAM	? mem+(loop << 8)
 														: SW_ALTZP	? memaux+(loop << 8)-bankoffset
 																	: g_pMemMainLanguageCard+((loop-0xC0)<<8)-bankoffset
-										: NULL;
+										: memWriteSink;
 	}
 
 	for (loop = 0xE0; loop < 0x100; loop++)
@@ -1241,7 +1393,7 @@ static void UpdatePaging(BOOL initialize)
 		memwrite[loop]  = SW_WRITERAM	? SW_HIGHRAM	? mem+(loop << 8)
 														: SW_ALTZP	? memaux+(loop << 8)
 																	: g_pMemMainLanguageCard+((loop-0xC0)<<8)
-										: NULL;
+										: memWriteSink;
 	}
 
 	if (SW_80STORE)
@@ -1264,31 +1416,61 @@ static void UpdatePaging(BOOL initialize)
 		}
 	}
 
+	if (g_isPagingByPointer)
+	{
+		// Point directly to the backing-store, so no memory needs moving:
+		// . where RD & WR are the same page (ie. memwrite points to 'mem'), then write directly to the shadow page
+		// . Page0 (ZP) and Page1 (stack) are always r/w to the same page (and memwrite[0..1] only get set by initialize)
+		for (loop = 0x00; loop < 0x100; loop++)
+		{
+			if ((loop <= 1) || (memwrite[loop] == mem+(loop << 8)))
+				memwrite[loop] = memshadow[loop];
+
+			memread[loop] = memshadow[loop];
+		}
+
+		return;
+	}
+
 	// MOVE MEMORY BACK AND FORTH AS NECESSARY BETWEEN THE SHADOW AREAS AND
 	// THE MAIN RAM IMAGE TO KEEP BOTH SETS OF MEMORY CONSISTENT WITH THE NEW
 	// PAGING SHADOW TABLE
 	//
-	// NB. the condition 'loop <= 1' is there because:
-	// . Page0 (ZP) and Page1 (stack) are written to so often that it's almost certain that they'll be dirty every time this function is called.
-	// Note also that:
-	// . Page0 (ZP)    : memdirty[0] is set when the 6502 CPU writes to ZP.
-	// . Page1 (stack) : memdirty[1] is NOT set when the 6502 CPU writes to this page with JSR, PHA, etc.
-	// Ultimately this is an optimisation (due to Page1 writes not setting memdirty[1]) and Page0 could be optimised to also not set memdirty[0].
+	// NB. Page0 (ZP) and Page1 (stack) are always treated as dirty because:
+	// . they are written to so often that it's almost certain that they'll be dirty every time this function is called.
+	// . so they're never write trapped, and the CPU's writes to them (including JSR, PHA, etc) don't set their dirty flags.
 
-	for (loop = 0x00; loop < 0x100; loop++)
+	if (initialize)
 	{
-		if (initialize || (oldshadow[loop] != memshadow[loop]))
+		ClearDirtyPages();	// 'mem' is completely refilled below
+	}
+	else
+	{
+		// Only walk the dirty pages
+		for (UINT i = 0; i < 0x100/32; i++)
 		{
-			if (!initialize &&
-				((*(memdirty+loop) & 1) || (loop <= 1)))
+			UINT32 bits = memdirty[i] | (i == 0 ? 3 : 0);
+			while (bits)
 			{
-				*(memdirty+loop) &= ~1;
-				memcpy(oldshadow[loop],mem+(loop << 8),256);
+				loop = i * 32 + GetLowestSetBit(bits);
+				bits &= bits - 1;
+
+				if (oldshadow[loop] != memshadow[loop])
+				{
+					ClearPage(memdirty, loop);
+					memcpy(oldshadow[loop],mem+(loop << 8),256);
+				}
 			}
+		}
+	}
 
+	for (loop = 0x00; loop < 0x100; loop++)
+	{
+		if (initialize || (oldshadow[loop] != memshadow[loop]))
 			memcpy(mem+(loop << 8),memshadow[loop],256);
-		}
 	}
+
+	ArmWriteTraps();
 }
 
 //
@@ -1303,7 +1485,6 @@ void MemDestroy()
 	ALIGNED_FREE(memmain);
 	FreeMemImage();
 
-	delete [] memdirty;
 	delete [] memrom;
 
 	delete [] pCxRomInternal;
@@ -1323,7 +1504,6 @@ void MemDestroy()
 
 	memaux   = NULL;
 	memmain  = NULL;
-	memdirty = NULL;
 	memrom   = NULL;
 	memimage = NULL;
 
@@ -1332,8 +1512,13 @@ void MemDestroy()
 
 	mem      = NULL;
 
+	memset(memread,   0, sizeof(memread));
 	memset(memwrite,  0, sizeof(memwrite));
 	memset(memshadow, 0, sizeof(memshadow));
+	memset(memwritetrap, 0, sizeof(memwritetrap));
+	ClearDirtyPages();
+
+	g_isPagingByPointer = false;
 }
 
 //===========================================================================
@@ -1358,7 +1543,7 @@ static LPBYTE MemGetPtrBANK1(const WORD offset, const LPBYTE pMemBase)
 	// NB. This works for memaux when set to any RWpages[] value, ie. RamWork III "just works"
 	const BYTE bank1page = (offset >> 8) & 0xF;
 	return (memshadow[0xD0+bank1page] == pMemBase+(0xC0+bank1page)*256)
-		? mem+offset+0x1000				// Return ptr to $Dxxx address - 'mem' has (a potentially dirty) 4K RAM BANK1 mapped in at $D000
+		? MemGetReadPtr(offset+0x1000)	// Return ptr to $Dxxx address - 'mem' has (a potentially dirty) 4K RAM BANK1 mapped in at $D000
 		: pMemBase+offset;				// Else return ptr to $Cxxx address
 }
 
@@ -1371,7 +1556,7 @@ LPBYTE MemGetAuxPtr(const WORD offset)
 		return lpMem;
 
 	lpMem = (memshadow[(offset >> 8)] == (memaux+(offset & 0xFF00)))
-			? mem+offset				// Return 'mem' copy if possible, as page could be dirty
+			? MemGetReadPtr(offset)		// Return 'mem' copy if possible, as page could be dirty
 			: memaux+offset;
 
 #ifdef RAMWORKS
@@ -1384,7 +1569,7 @@ LPBYTE MemGetAuxPtr(const WORD offset)
 		)
 	{
 		lpMem = (memshadow[(offset >> 8)] == (RWpages[0]+(offset & 0xFF00)))
-			? mem+offset
+			? MemGetReadPtr(offset)
 			: RWpages[0]+offset;
 	}
 #endif
@@ -1429,7 +1614,7 @@ LPBYTE MemGetMainPtr(const WORD offset)
 		return lpMem;
 
 	return (memshadow[(offset >> 8)] == (memmain+(offset & 0xFF00)))
-			? mem+offset				// Return 'mem' copy if possible, as page could be dirty
+			? MemGetReadPtr(offset)		// Return 'mem' copy if possible, as page could be dirty
 			: memmain+offset;
 }
 
@@ -1437,13 +1622,24 @@ LPBYTE MemGetMainPtr(const WORD offset)
 
 static void BackMainImage(void)
 {
-	for (UINT loop = 0; loop < 256; loop++)
+	if (g_isPagingByPointer)
+		return;	// 'mem' isn't used, so the backing-store is already up-to-date
+
+	for (UINT i = 0; i < 0x100/32; i++)
 	{
-		if (memshadow[loop] && ((*(memdirty + loop) & 1) || (loop <= 1)))
-			memcpy(memshadow[loop], mem + (loop << 8), 256);
+		UINT32 bits = memdirty[i] | (i == 0 ? 3 : 0);	// Page0 & Page1 are always treated as dirty
+		while (bits)
+		{
+			const UINT loop = i * 32 + GetLowestSetBit(bits);
+			bits &= bits - 1;
 
-		*(memdirty + loop) &= ~1;
+			if (memshadow[loop])
+				memcpy(memshadow[loop], mem + (loop << 8), 256);
+		}
 	}
+
+	ClearDirtyPages();
+	ArmWriteTraps();
 }
 
 //-------------------------------------
@@ -1669,13 +1865,12 @@ void MemInitialize()
 	memmain  = ALIGNED_ALLOC(_6502_MEM_LEN);
 	memimage = AllocMemImage();
 
-	memdirty = new BYTE[0x100];
 	memrom   = new BYTE[0x3000 * MaxRomPages];
 
 	pCxRomInternal		= new BYTE[CxRomSize];
 	pCxRomPeripheral	= new BYTE[CxRomSize];
 
-	if (!memaux || !memdirty || !memimage || !memmain || !memrom || !pCxRomInternal || !pCxRomPeripheral)
+	if (!memaux || !memimage || !memmain || !memrom || !pCxRomInternal || !pCxRomPeripheral)
 	{
 		GetFrame().FrameMessageBox(
 			TEXT("The emulator was unable to allocate the memory it ")
@@ -1974,7 +2169,8 @@ void MemReset()
 	g_eExpansionRomType = eExpRomNull;
 	g_uPeripheralRomSlot = 0;
 
-	memset(memdirty, 0, 0x100);
+	ClearDirtyPages();
+	memset(memwritetrap, 0, sizeof(memwritetrap));
 
 	memVidHD = NULL;
 
@@ -2120,9 +2316,56 @@ void MemReset()
 
 //===========================================================================
 
+// Copy to the CPU's current (read) view of memory, wrapping at $FFFF
+// . NB. like writing to 'mem', so bypasses memwrite[]
+void MemWriteBlock(const WORD addr, const BYTE* pSrc, const UINT size)
+{
+	WORD dstAddr = addr;
+	UINT remaining = size;
+
+	while (remaining)
+	{
+		UINT chunk = 256 - (dstAddr & 0xff);
+		if (chunk > remaining) chunk = remaining;
+
+		memcpy(MemGetReadPtr(dstAddr), pSrc, chunk);
+		MemSetDirty(dstAddr);
+		pSrc += chunk;
+		dstAddr += chunk;
+		remaining -= chunk;
+	}
+}
+
+// Copy to the CPU's current write view of memory (ie. via memwrite[]), as a card's DMA would, wrapping at $FFFF
+// . bytes destined for ROM (ie. memWriteSink) or I/O are dropped
+void MemWriteDMA(const WORD addr, const BYTE* pSrc, const UINT size)
+{
+	WORD dstAddr = addr;
+	UINT remaining = size;
+
+	while (remaining)
+	{
+		UINT chunk = 256 - (dstAddr & 0xff);
+		if (chunk > remaining) chunk = remaining;
+
+		LPBYTE page = memwrite[dstAddr >> 8];
+		if (!page)
+			page = MemWriteTrap(dstAddr);	// 1st write to a clean page
+
+		if (page)
+			memcpy(page + (dstAddr & 0xff), pSrc, chunk);
+
+		pSrc += chunk;
+		dstAddr += chunk;
+		remaining -= chunk;
+	}
+}
+
+//===========================================================================
+
 BYTE MemReadFloatingBus(const ULONG uExecutedCycles)
 {
-	return mem[ NTSC_VideoGetScannerAddress(uExecutedCycles) ];		// OK: This does the 2-cycle adjust for ANSI STORY (End Credits)
+	return *MemGetReadPtr( NTSC_VideoGetScannerAddress(uExecutedCycles) );		// OK: This does the 2-cycle adjust for ANSI STORY (End Credits)
 }
 
 //===========================================================================
@@ -2246,7 +2489,7 @@ BYTE __stdcall MemSetPaging(WORD programcounter, WORD address, BYTE write, BYTE
 					// . Similar to $CFFF access
 					// . None of the peripheral cards can be driving the bus - so use the null ROM
 					memset(pCxRomPeripheral+0x800, 0, FIRMWARE_EXPANSION_SIZE);
-					memset(mem+FIRMWARE_EXPANSION_BEGIN, 0, FIRMWARE_EXPANSION_SIZE);
+					SetExpansionRomView(pCxRomPeripheral+0x800);
 					g_eExpansionRomType = eExpRomNull;
 					g_uPeripheralRomSlot = 0;
 				}
@@ -2255,7 +2498,7 @@ BYTE __stdcall MemSetPaging(WORD programcounter, WORD address, BYTE write, BYTE
 			else
 			{
 				// Enable Internal ROM
-				memcpy(mem+0xC800, pCxRomInternal+0x800, FIRMWARE_EXPANSION_SIZE);
+				SetExpansionRomView(pCxRomInternal+0x800);
 				g_eExpansionRomType = eExpRomInternal;
 				g_uPeripheralRomSlot = 0;
 				IoHandlerCardsOut();
@@ -2276,6 +2519,9 @@ BYTE __stdcall MemSetPaging(WORD programcounter, WORD address, BYTE write, BYTE
 
 bool MemOptimizeForModeChanging(WORD programcounter, WORD address)
 {
+	if (g_isPagingByPointer)
+		return false;	// Paging changes don't copy any memory, so there's nothing to optimise
+
 	if (IsAppleIIeOrAbove(GetApple2Type()))
 	{
 		if (programcounter > 0xFFFC)	// Prevent out of bounds access!
@@ -2549,7 +2795,7 @@ bool MemLoadSnapshot(YamlLoadHelper& yamlLoadHelper, UINT unitVersion)
 		memcpy(g_pMemMainLanguageCard, memmain+0xC000, LanguageCardSlot0::kMemBankSize);
 		memset(memmain+0xC000, 0, LanguageCardSlot0::kMemBankSize);
 	}
-	memset(memdirty, 0, 0x100);
+	ClearDirtyPages();
 
 	yamlLoadHelper.PopMap();
 
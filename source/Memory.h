@@ -40,11 +40,19 @@ typedef BYTE (__stdcall *iofunction)(WORD nPC, WORD nAddr, BYTE nWriteFlag, BYTE
 
 extern iofunction IORead[256];
 extern iofunction IOWrite[256];
+extern LPBYTE     memread[0x100];
 extern LPBYTE     memwrite[0x100];
+extern BYTE       memWriteSink[0x100];
 extern LPBYTE     mem;
-extern LPBYTE     memdirty;
 extern LPBYTE     memVidHD;
 
+// Ptr to addr in the CPU's current (read) view of memory, ie. what 'mem' used to be used for
+// . NB. only valid up to the end of addr's 256-byte page
+inline LPBYTE MemGetReadPtr(const WORD addr)
+{
+	return memread[addr >> 8] + (addr & 0xFF);
+}
+
 #ifdef RAMWORKS
 const UINT kMaxExMemoryBanks = 127;	// 127 * aux mem(64K) + main mem(64K) = 8MB
 #endif
@@ -74,6 +82,14 @@ BYTE    MemReadFloatingBus(const BYTE highbit, const ULONG uExecutedCycles);
 void    MemReset ();
 void    MemResetPaging ();
 void    MemUpdatePaging(BOOL initialize);
+void    MemSetPagingByPointer(const bool enable);
+bool    MemIsPagingByPointer(void);
+void    MemUpdatePagingByPointer(void);
+void    MemWriteBlock(const WORD addr, const BYTE* pSrc, const UINT size);
+void    MemWriteDMA(const WORD addr, const BYTE* pSrc, const UINT size);
+inline void MemWriteDMA(const WORD addr, const BYTE value) { MemWriteDMA(addr, &value, 1); }
+LPBYTE  MemWriteTrap(const WORD addr);
+void    MemSetDirty(const WORD addr);
 LPVOID	MemGetSlotParameters (UINT uSlot);
 void	MemAnnunciatorReset(void);
 bool    MemGetAnnunciator(UINT annunciator);
@@ -50,6 +50,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "CPU.h"
 #include "Log.h"
 #include "Memory.h"
+#include "SoundCapture.h"
 #include "SoundCore.h"
 #include "SynchronousEventManager.h"
 #include "YamlHelper.h"
@@ -70,6 +71,15 @@ MockingboardCard::MockingboardCard(UINT slot, SS_CARDTYPE type) : Card(type, slo
 	for (UINT i = 0; i < NUM_VOICES; i++)
 		m_ppAYVoiceBuffer[i] = new short[MAX_SAMPLES];	// Buffer can hold a max of 0.37 seconds worth of samples (16384/44100)
 
+	for (UINT i = 0; i < NUM_AY8913; i++)
+		m_isAYSilent[i] = false;
+
+	for (UINT i = 0; i < NUM_VOICES; i++)
+		m_pAYVoiceCapture[i] = NULL;
+
+	for (UINT i = 0; i < NUM_AY8913; i++)
+		m_isAYVoiceCaptureResolved[i] = false;
+
 	m_inActiveCycleCount = 0;
 	m_regAccessedFlag = false;
 	m_isActive = false;
@@ -513,19 +523,27 @@ UINT MockingboardCard::MB_Update(void)
 			for (BYTE ay = 0; ay < NUM_AY8913_PER_SUBUNIT; ay++)
 			{
 				const UINT chip = subunit * NUM_AY8913_PER_SUBUNIT + ay;
-				AY8910Update(subunit, ay, &m_ppAYVoiceBuffer[chip * NUM_VOICES_PER_AY8913], nNumSamples);
+				m_isAYSilent[chip] = !AY8910Update(subunit, ay, &m_ppAYVoiceBuffer[chip * NUM_VOICES_PER_AY8913], nNumSamples);
 			}
 		}
 
 		// Echo+ right speaker is also output to left speaker
 		if (m_phasorEnable && m_phasorMode == PH_EchoPlus)
 		{
+			m_isAYSilent[0] = m_isAYSilent[2];
+			m_isAYSilent[1] = m_isAYSilent[3];
+
 			for (UINT j = 0; j < NUM_VOICES_PER_AY8913; j++)
 			{
-				memcpy(m_ppAYVoiceBuffer[0 * NUM_VOICES_PER_AY8913 + j], m_ppAYVoiceBuffer[2 * NUM_VOICES_PER_AY8913 + j], nNumSamples * sizeof(short));
-				memcpy(m_ppAYVoiceBuffer[1 * NUM_VOICES_PER_AY8913 + j], m_ppAYVoiceBuffer[3 * NUM_VOICES_PER_AY8913 + j], nNumSamples * sizeof(short));
+				if (!m_isAYSilent[0])
+					memcpy(m_ppAYVoiceBuffer[0 * NUM_VOICES_PER_AY8913 + j], m_ppAYVoiceBuffer[2 * NUM_VOICES_PER_AY8913 + j], nNumSamples * sizeof(short));
+				if (!m_isAYSilent[1])
+					memcpy(m_ppAYVoiceBuffer[1 * NUM_VOICES_PER_AY8913 + j], m_ppAYVoiceBuffer[3 * NUM_VOICES_PER_AY8913 + j], nNumSamples * sizeof(short));
 			}
 		}
+
+		if (GetSoundCapture().IsCapturingAll())
+			CaptureVoices(nNumSamples);
 	}
 
 	return (UINT) nNumSamples;
@@ -556,7 +574,7 @@ void MockingboardCard::Destroy(void)
 	for (UINT id = 0; id < kNumSyncEvents; id++)
 	{
 		if (m_syncEvent[id] && m_syncEvent[id]->m_active)
-			g_SynchronousEventMgr.Remove(m_syncEvent[id]->m_id);
+			GetSynchronousEventMgr().Remove(m_syncEvent[id]->m_id);
 
 		delete m_syncEvent[id];
 		m_syncEvent[id] = NULL;
@@ -595,7 +613,7 @@ void MockingboardCard::Reset(const bool powerCycle)	// CTRL+RESET or power-cycle
 		for (int id = 0; id < kNumSyncEvents; id++)
 		{
 			if (m_syncEvent[id] && m_syncEvent[id]->m_active)
-				g_SynchronousEventMgr.Remove(m_syncEvent[id]->m_id);
+				GetSynchronousEventMgr().Remove(m_syncEvent[id]->m_id);
 		}
 
 		// Not this, since no change on a CTRL+RESET or power-cycle:
@@ -624,7 +642,7 @@ BYTE MockingboardCard::IOReadInternal(WORD PC, WORD nAddr, BYTE bWrite, BYTE nVa
 	if (!IS_APPLE2 && MemCheckINTCXROM())
 	{
 		_ASSERT(0);	// Card ROM disabled, so IO_Cxxx() returns the internal ROM
-		return mem[nAddr];
+		return *MemGetReadPtr(nAddr);
 	}
 #endif
 
@@ -696,22 +714,22 @@ BYTE MockingboardCard::IOWriteInternal(WORD PC, WORD nAddr, BYTE bWrite, BYTE nV
 #endif
 
 	// Support 6502/65C02 false-reads of 6522 (GH#52)
-	if ( ((mem[(PC-2)&0xffff] == 0x91) && GetMainCpu() == CPU_6502) ||	// sta (zp),y - 6502 only (no-PX variant only) (UTAIIe:4-23)
-		 (mem[(PC-3)&0xffff] == 0x99) ||	// sta abs16,y - 6502/65C02, but for 65C02 only the no-PX variant that does the false-read (UTAIIe:4-27)
-		 (mem[(PC-3)&0xffff] == 0x9D) )		// sta abs16,x - 6502/65C02, but for 65C02 only the no-PX variant that does the false-read (UTAIIe:4-27)
+	if ( ((*MemGetReadPtr((PC-2)&0xffff) == 0x91) && GetMainCpu() == CPU_6502) ||	// sta (zp),y - 6502 only (no-PX variant only) (UTAIIe:4-23)
+		 (*MemGetReadPtr((PC-3)&0xffff) == 0x99) ||	// sta abs16,y - 6502/65C02, but for 65C02 only the no-PX variant that does the false-read (UTAIIe:4-27)
+		 (*MemGetReadPtr((PC-3)&0xffff) == 0x9D) )		// sta abs16,x - 6502/65C02, but for 65C02 only the no-PX variant that does the false-read (UTAIIe:4-27)
 	{
 		WORD base;
 		WORD addr16;
-		if (mem[(PC-2)&0xffff] == 0x91)
+		if (*MemGetReadPtr((PC-2)&0xffff) == 0x91)
 		{
-			BYTE zp = mem[(PC-1)&0xffff];
-			base = (mem[zp] | (mem[(zp+1)&0xff]<<8));
+			BYTE zp = *MemGetReadPtr((PC-1)&0xffff);
+			base = (*MemGetReadPtr(zp) | (*MemGetReadPtr((zp+1)&0xff)<<8));
 			addr16 = base + regs.y;
 		}
 		else
 		{
-			base = mem[(PC-2)&0xffff] | (mem[(PC-1)&0xffff]<<8);
-			addr16 = base + ((mem[(PC-3)&0xffff] == 0x99) ? regs.y : regs.x);
+			base = *MemGetReadPtr((PC-2)&0xffff) | (*MemGetReadPtr((PC-1)&0xffff)<<8);
+			addr16 = base + ((*MemGetReadPtr((PC-3)&0xffff) == 0x99) ? regs.y : regs.x);
 		}
 
 		if (((base ^ addr16) >> 8) == 0)	// Only the no-PX variant does the false read (to the same I/O SELECT page)
@@ -1081,14 +1099,54 @@ void MockingboardCard::AY8910UpdateSetCycles()
 	m_lastAYUpdateCycle = g_nCumulativeCycles;
 }
 
-void MockingboardCard::AY8910Update(BYTE subunit, BYTE ay, INT16** buffer, int nNumSamples)
+// Capture each AY voice to its own (mono) stream, eg. "Slot4-AY0-A"
+// . chips 0 & 2 are the regular MB's AY's (L & R), and chips 1 & 3 are the extra Phasor AY's
+void MockingboardCard::CaptureVoices(int nNumSamples)
+{
+	for (UINT chip = 0; chip < NUM_AY8913; chip++)
+	{
+		if ((chip & 1) && !m_phasorEnable)
+			continue;
+
+		if (!m_isAYVoiceCaptureResolved[chip])
+		{
+			for (UINT j = 0; j < NUM_VOICES_PER_AY8913; j++)
+			{
+				const std::string name = StrFormat("Slot%u-AY%u-%c", m_slot, chip, 'A' + j);
+				m_pAYVoiceCapture[chip * NUM_VOICES_PER_AY8913 + j] = GetSoundCapture().GetStream(name, SAMPLE_RATE, 1);
+			}
+
+			m_isAYVoiceCaptureResolved[chip] = true;
+		}
+
+		for (UINT j = 0; j < NUM_VOICES_PER_AY8913; j++)
+		{
+			SoundCaptureStream* pStream = m_pAYVoiceCapture[chip * NUM_VOICES_PER_AY8913 + j];
+			if (!pStream)
+				continue;
+
+			if (m_isAYSilent[chip])
+				pStream->WriteSilence(nNumSamples);
+			else
+				pStream->Write(m_ppAYVoiceBuffer[chip * NUM_VOICES_PER_AY8913 + j], nNumSamples);
+		}
+	}
+}
+
+// Returns false (and leaves the buffers untouched) if the AY is silent for this frame
+// . eg. a game that inits the MB once and never plays any music
+bool MockingboardCard::AY8910Update(BYTE subunit, BYTE ay, INT16** buffer, int nNumSamples)
 {
 	_ASSERT(subunit < NUM_SUBUNITS_PER_MB && ay < NUM_AY8913_PER_SUBUNIT);
 	AY8910UpdateSetCycles();
 
+	if (m_MBSubUnit[subunit].ay8913[ay].IsSilent())
+		return false;
+
 	m_MBSubUnit[subunit].ay8913[ay].SetFramesize(nNumSamples);
 	m_MBSubUnit[subunit].ay8913[ay].SetSoundBuffers(buffer);
 	m_MBSubUnit[subunit].ay8913[ay].sound_frame();
+	return true;
 }
 
 void MockingboardCard::AY8910_InitAll(int nClock, int nSampleRate)
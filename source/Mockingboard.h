@@ -7,6 +7,8 @@
 #include "SSI263.h"
 #include "SynchronousEventManager.h"
 
+class SoundCaptureStream;
+
 class MockingboardCard : public Card
 {
 public:
@@ -36,6 +38,7 @@ public:
 	void SetCumulativeCycles(void);
 	UINT MB_Update(void);
 	short** GetVoiceBuffers(void) { return m_ppAYVoiceBuffer; }
+	bool IsAYSilent(UINT chip) { return m_isAYSilent[chip]; }	// If true, then this AY's voice buffers weren't updated by the last MB_Update()
 	int GetNumSamplesError(void) { return m_numSamplesError; }
 	void SetNumSamplesError(int numSamplesError) { m_numSamplesError = numSamplesError; }
 #ifdef _DEBUG
@@ -132,7 +135,8 @@ private:
 	BYTE AYReadReg(BYTE subunit, BYTE ay, int r);
 	void _AYWriteReg(BYTE subunit, BYTE ay, int r, int v);
 	void AY8910_reset(BYTE subunit, BYTE ay);
-	void AY8910Update(BYTE subunit, BYTE ay, INT16** buffer, int nNumSamples);
+	bool AY8910Update(BYTE subunit, BYTE ay, INT16** buffer, int nNumSamples);
+	void CaptureVoices(int nNumSamples);
 
 	void AY8910_InitAll(int nClock, int nSampleRate);
 	void AY8910_InitClock(int nClock);
@@ -167,6 +171,11 @@ private:
 	UINT64 m_lastCumulativeCycle;
 
 	short* m_ppAYVoiceBuffer[NUM_VOICES];
+	bool m_isAYSilent[NUM_AY8913];
+
+	// Per-voice capture (-wav-capture): each AY's streams are resolved on its first CaptureVoices(), then just indexed
+	SoundCaptureStream* m_pAYVoiceCapture[NUM_VOICES];
+	bool m_isAYVoiceCaptureResolved[NUM_AY8913];
 
 	UINT64 m_inActiveCycleCount;
 	bool m_regAccessedFlag;
@@ -34,7 +34,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "CardManager.h"
 #include "CPU.h"
 #include "MockingboardDefs.h"
-#include "Riff.h"
 
 //#define DBG_MB_UPDATE
 
@@ -64,10 +63,7 @@ void MockingboardCardManager::InitializeForLoadingSnapshot(void)
 	if (g_bDisableDirectSound || g_bDisableDirectSoundMockingboard)
 		return;
 
-	if (!m_mockingboardVoice.lpDSBvoice)
-		return;
-
-	DSVoiceStop(&m_mockingboardVoice);	// Reason: 'MB voice is playing' then loading a save-state where 'no MB present' (GH#609)
+	m_mockingboardSource.Flush();	// Reason: 'MB voice is playing' then loading a save-state where 'no MB present' (GH#609)
 }
 
 void MockingboardCardManager::MuteControl(bool mute)
@@ -78,22 +74,7 @@ void MockingboardCardManager::MuteControl(bool mute)
 			dynamic_cast<MockingboardCard&>(GetCardMgr().GetRef(i)).MuteControl(mute);
 	}
 
-	if (mute)
-	{
-		if (m_mockingboardVoice.bActive && !m_mockingboardVoice.bMute)
-		{
-			m_mockingboardVoice.lpDSBvoice->SetVolume(DSBVOLUME_MIN);
-			m_mockingboardVoice.bMute = true;
-		}
-	}
-	else
-	{
-		if (m_mockingboardVoice.bActive && m_mockingboardVoice.bMute)
-		{
-			m_mockingboardVoice.lpDSBvoice->SetVolume(m_mockingboardVoice.nVolume);
-			m_mockingboardVoice.bMute = false;
-		}
-	}
+	m_mockingboardSource.SetMute(mute);
 }
 
 void MockingboardCardManager::SetCumulativeCycles(void)
@@ -132,7 +113,7 @@ void MockingboardCardManager::UpdateIRQ(void)
 
 bool MockingboardCardManager::IsActive(void)
 {
-	if (!m_mockingboardVoice.bActive)
+	if (!m_mockingboardSource.IsActive())
 		return false;
 
 	for (UINT i = SLOT0; i < NUM_SLOTS; i++)
@@ -147,18 +128,12 @@ bool MockingboardCardManager::IsActive(void)
 
 DWORD MockingboardCardManager::GetVolume(void)
 {
-	return m_userVolume;
+	return m_mockingboardSource.GetVolume();
 }
 
 void MockingboardCardManager::SetVolume(DWORD volume, DWORD volumeMax)
 {
-	m_userVolume = volume;
-
-	m_mockingboardVoice.dwUserVolume = volume;
-	m_mockingboardVoice.nVolume = NewVolume(volume, volumeMax);
-
-	if (m_mockingboardVoice.bActive && !m_mockingboardVoice.bMute)
-		m_mockingboardVoice.lpDSBvoice->SetVolume(m_mockingboardVoice.nVolume);
+	m_mockingboardSource.SetVolume(volume, volumeMax);
 
 	for (UINT i = SLOT0; i < NUM_SLOTS; i++)
 	{
@@ -206,10 +181,7 @@ void MockingboardCardManager::Destroy(void)
 {
 	// NB. All cards (including any Mockingboard cards) have just been destroyed by CardManager
 
-	if (m_mockingboardVoice.lpDSBvoice && m_mockingboardVoice.bActive)
-		DSVoiceStop(&m_mockingboardVoice);
-
-	DSReleaseSoundBuffer(&m_mockingboardVoice);
+	GetSoundMixer().RemoveSource(&m_mockingboardSource);
 }
 
 // Called by ContinueExecution() at the end of every execution period (~1000 cycles or ~3 cycles when MODE_STEPPING)
@@ -255,7 +227,7 @@ void MockingboardCardManager::UpdateSoundBuffer(void)
 	PerfMarker perfMarker(!IsAnyTimer1Active() ? g_timeMB_NoTimer : g_timeMB_Timer);
 #endif
 
-	if (!m_mockingboardVoice.lpDSBvoice)
+	if (!m_mockingboardSource.IsActive())
 	{
 		if (g_bDisableDirectSound || g_bDisableDirectSoundMockingboard)
 			return;
@@ -264,15 +236,6 @@ void MockingboardCardManager::UpdateSoundBuffer(void)
 			return;
 	}
 
-	if (!m_mockingboardVoice.bActive)
-	{
-		// Sound buffer may have been stopped by MB_InitializeForLoadingSnapshot().
-		// NB. DSZeroVoiceBuffer() also zeros the sound buffer, so it's better than directly calling IDirectSoundBuffer::Play():
-		// - without zeroing, then the previous sound buffer can be heard for a fraction of a second
-		// - eg. when doing Mockingboard playback, then loading a save-state which is also doing Mockingboard playback
-		DSZeroVoiceBuffer(&m_mockingboardVoice, SOUNDBUFFER_SIZE);	// ... and Play()
-	}
-
 	UINT numSamples = GenerateAllSoundData();
 	if (numSamples)
 		MixAllAndCopyToRingBuffer(numSamples);
@@ -280,31 +243,15 @@ void MockingboardCardManager::UpdateSoundBuffer(void)
 
 bool MockingboardCardManager::Init(void)
 {
-	if (!g_bDSAvailable)
-		return false;
-
-	HRESULT hr = DSGetSoundBuffer(&m_mockingboardVoice, DSBCAPS_CTRLVOLUME, SOUNDBUFFER_SIZE, MockingboardCard::SAMPLE_RATE, MockingboardCard::NUM_MB_CHANNELS, "MB");
-	LogFileOutput("MBCardMgr: DSGetSoundBuffer(), hr=0x%08X\n", hr);
-	if (FAILED(hr))
-	{
-		LogFileOutput("MBCardMgr: DSGetSoundBuffer failed (%08X)\n", hr);
-		return false;
-	}
-
-	bool bRes = DSZeroVoiceBuffer(&m_mockingboardVoice, SOUNDBUFFER_SIZE);	// ... and Play()
-	LogFileOutput("MBCardMgr: DSZeroVoiceBuffer(), res=%d\n", bRes ? 1 : 0);
-	if (!bRes)
+	if (!GetSoundMixer().IsOutputAvailable())
 		return false;
 
-	m_mockingboardVoice.bActive = true;
+	// NB. Volume might've already been setup from value in Registry
+	m_mockingboardSource.Init("MB", MockingboardCard::SAMPLE_RATE, MockingboardCard::NUM_MB_CHANNELS);
 
-	// Volume might've been setup from value in Registry
-	if (!m_mockingboardVoice.nVolume)
-		m_mockingboardVoice.nVolume = DSBVOLUME_MAX;
-
-	hr = m_mockingboardVoice.lpDSBvoice->SetVolume(m_mockingboardVoice.nVolume);
-	LogFileOutput("MBCardMgr: SetVolume(), hr=0x%08X\n", hr);
-	return true;
+	bool bRes = GetSoundMixer().AddSource(&m_mockingboardSource);
+	LogFileOutput("MBCardMgr: AddSource(), res=%d\n", bRes ? 1 : 0);
+	return bRes;
 }
 
 UINT MockingboardCardManager::GenerateAllSoundData(void)
@@ -318,73 +265,10 @@ UINT MockingboardCardManager::GenerateAllSoundData(void)
 
 		MockingboardCard& MB = dynamic_cast<MockingboardCard&>(GetCardMgr().GetRef(slot));
 
-		MB.SetNumSamplesError(m_numSamplesError);
+		// NB. The mixer calcs the correction factor from this source's backlog, so that it doesn't under/overflow
+		MB.SetNumSamplesError(m_mockingboardSource.GetNumSamplesError());
 		nNumSamples = MB.MB_Update();
-		m_numSamplesError = MB.GetNumSamplesError();
-	}
-
-	//
-
-	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
-	HRESULT hr = m_mockingboardVoice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
-	if (FAILED(hr))
-		return 0;
-
-	if (m_byteOffset == (DWORD)-1)
-	{
-		// First time in this func
-
-		m_byteOffset = dwCurrentWriteCursor;
 	}
-	else
-	{
-		// Check that our offset isn't between Play & Write positions
-
-		if (dwCurrentWriteCursor > dwCurrentPlayCursor)
-		{
-			// |-----PxxxxxW-----|
-			if ((m_byteOffset > dwCurrentPlayCursor) && (m_byteOffset < dwCurrentWriteCursor))
-			{
-#ifdef DBG_MB_UPDATE
-				double fTicksSecs = (double)GetTickCount() / 1000.0;
-				LogOutput("%010.3f: [MBUpdt]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X xxx\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor - dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-#endif
-				m_byteOffset = dwCurrentWriteCursor;
-				m_numSamplesError = 0;
-			}
-		}
-		else
-		{
-			// |xxW----------Pxxx|
-			if ((m_byteOffset > dwCurrentPlayCursor) || (m_byteOffset < dwCurrentWriteCursor))
-			{
-#ifdef DBG_MB_UPDATE
-				double fTicksSecs = (double)GetTickCount() / 1000.0;
-				LogOutput("%010.3f: [MBUpdt]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X XXX\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor - dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-#endif
-				m_byteOffset = dwCurrentWriteCursor;
-				m_numSamplesError = 0;
-			}
-		}
-	}
-
-	int nBytesRemaining = m_byteOffset - dwCurrentPlayCursor;
-	if (nBytesRemaining < 0)
-		nBytesRemaining += SOUNDBUFFER_SIZE;
-
-	// Calc correction factor so that play-buffer doesn't under/overflow
-	const int nErrorInc = SoundCore_GetErrorInc();
-	if (nBytesRemaining < SOUNDBUFFER_SIZE / 4)
-		m_numSamplesError += nErrorInc;				// < 0.25 of buffer remaining
-	else if (nBytesRemaining > SOUNDBUFFER_SIZE / 2)
-		m_numSamplesError -= nErrorInc;				// > 0.50 of buffer remaining
-	else
-		m_numSamplesError = 0;						// Acceptable amount of data in buffer
-
-#ifdef DBG_MB_UPDATE
-	double fTicksSecs = (double)GetTickCount() / 1000.0;
-	LogOutput("%010.3f: [MBUpdt]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X, NSE=%08X, Interval=%f\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor - dwCurrentPlayCursor, dwByteOffset, nNumSamples, nNumSamplesError, updateInterval);
-#endif
 
 	return nNumSamples;
 }
@@ -392,78 +276,64 @@ UINT MockingboardCardManager::GenerateAllSoundData(void)
 void MockingboardCardManager::MixAllAndCopyToRingBuffer(UINT nNumSamples)
 {
 //	const double fAttenuation = g_bPhasorEnable ? 2.0 / 3.0 : 1.0;
-	const double fAttenuation = true ? 2.0 / 3.0 : 1.0;
+	// NB. The attenuation is applied once to the sum of all voices (rather than to each voice)
 
-	short** slotAYVoiceBuffers[NUM_SLOTS] = {0};
+	int* pSumL = &m_sumBufferL[0];
+	int* pSumR = &m_sumBufferR[0];
+	memset(pSumL, 0, nNumSamples * sizeof(int));
+	memset(pSumR, 0, nNumSamples * sizeof(int));
+
+	// Mockingboard stereo (all voices on an AY8910 wire-or'ed together)
+	// L = Address.b7=0, R = Address.b7=1
+	// . AY's 0,1 (regular MB-C AY & extra Phasor AY) are L, and AY's 2,3 are R
+	// . sum one voice at a time over all the samples (rather than all voices for each sample), so the inner loop is a simple vector add
+	// . silent AY's haven't updated their voice buffers, so skip them
+	bool isSilent = true;
 
 	for (UINT slot = SLOT0; slot < NUM_SLOTS; slot++)
 	{
-		if (IsMockingboard(slot))
-			slotAYVoiceBuffers[slot] = dynamic_cast<MockingboardCard&>(GetCardMgr().GetRef(slot)).GetVoiceBuffers();
-	}
+		if (!IsMockingboard(slot))
+			continue;
 
-	for (UINT i = 0; i < nNumSamples; i++)
-	{
-		// Mockingboard stereo (all voices on an AY8910 wire-or'ed together)
-		// L = Address.b7=0, R = Address.b7=1
-		int nDataL = 0, nDataR = 0;
+		MockingboardCard& MB = dynamic_cast<MockingboardCard&>(GetCardMgr().GetRef(slot));
+		short** ppAYVoiceBuffer = MB.GetVoiceBuffers();
 
-		for (UINT slot = SLOT0; slot < NUM_SLOTS; slot++)
+		for (UINT chip = 0; chip < NUM_AY8913; chip++)
 		{
-			if (!slotAYVoiceBuffers[slot])
+			if (MB.IsAYSilent(chip))
 				continue;
 
+			isSilent = false;
+			int* pSum = (chip < 2) ? pSumL : pSumR;
+
 			for (UINT j = 0; j < NUM_VOICES_PER_AY8913; j++)
 			{
-				short** ppAYVoiceBuffer = slotAYVoiceBuffers[slot];
-
-				// Regular MB-C AY's
-				nDataL += (int)((double)ppAYVoiceBuffer[0 * NUM_VOICES_PER_AY8913 + j][i] * fAttenuation);
-				nDataR += (int)((double)ppAYVoiceBuffer[2 * NUM_VOICES_PER_AY8913 + j][i] * fAttenuation);
+				const short* pVoice = ppAYVoiceBuffer[chip * NUM_VOICES_PER_AY8913 + j];
 
-				// Extra Phasor AY's
-				nDataL += (int)((double)ppAYVoiceBuffer[1 * NUM_VOICES_PER_AY8913 + j][i] * fAttenuation);
-				nDataR += (int)((double)ppAYVoiceBuffer[3 * NUM_VOICES_PER_AY8913 + j][i] * fAttenuation);
+				for (UINT i = 0; i < nNumSamples; i++)
+					pSum[i] += (int)pVoice[i];
 			}
 		}
-
-		// Cap the superpositioned output
-		if (nDataL < WAVE_DATA_MIN)
-			nDataL = WAVE_DATA_MIN;
-		else if (nDataL > WAVE_DATA_MAX)
-			nDataL = WAVE_DATA_MAX;
-
-		if (nDataR < WAVE_DATA_MIN)
-			nDataR = WAVE_DATA_MIN;
-		else if (nDataR > WAVE_DATA_MAX)
-			nDataR = WAVE_DATA_MAX;
-
-		m_mixBuffer[i * MockingboardCard::NUM_MB_CHANNELS + 0] = (short)nDataL;	// L
-		m_mixBuffer[i * MockingboardCard::NUM_MB_CHANNELS + 1] = (short)nDataR;	// R
 	}
 
-	//
-
-	DWORD dwDSLockedBufferSize0, dwDSLockedBufferSize1;
-	SHORT* pDSLockedBuffer0, * pDSLockedBuffer1;
-
-	HRESULT hr = DSGetLock(m_mockingboardVoice.lpDSBvoice,
-		m_byteOffset, (DWORD)nNumSamples * sizeof(short) * MockingboardCard::NUM_MB_CHANNELS,
-		&pDSLockedBuffer0, &dwDSLockedBufferSize0,
-		&pDSLockedBuffer1, &dwDSLockedBufferSize1);
-	if (FAILED(hr))
+	if (isSilent)
+	{
+		m_mockingboardSource.WriteSilence(nNumSamples);
 		return;
+	}
 
-	memcpy(pDSLockedBuffer0, &m_mixBuffer[0], dwDSLockedBufferSize0);
-	if (pDSLockedBuffer1)
-		memcpy(pDSLockedBuffer1, &m_mixBuffer[dwDSLockedBufferSize0 / sizeof(short)], dwDSLockedBufferSize1);
+	// Attenuate & cap the superpositioned output
+	// . NB. INT64, as the sum of all voices (eg. for 7 Phasors) * ATTENUATION_Q15 can overflow an int
+	for (UINT i = 0; i < nNumSamples; i++)
+	{
+		const int nDataL = (int)(((INT64)pSumL[i] * ATTENUATION_Q15) >> 15);
+		const int nDataR = (int)(((INT64)pSumR[i] * ATTENUATION_Q15) >> 15);
 
-	// Commit sound buffer
-	hr = m_mockingboardVoice.lpDSBvoice->Unlock((void*)pDSLockedBuffer0, dwDSLockedBufferSize0,
-		(void*)pDSLockedBuffer1, dwDSLockedBufferSize1);
+		m_mixBuffer[i * MockingboardCard::NUM_MB_CHANNELS + 0] = (short)std::min<int>(std::max<int>(nDataL, WAVE_DATA_MIN), WAVE_DATA_MAX);	// L
+		m_mixBuffer[i * MockingboardCard::NUM_MB_CHANNELS + 1] = (short)std::min<int>(std::max<int>(nDataR, WAVE_DATA_MIN), WAVE_DATA_MAX);	// R
+	}
 
-	m_byteOffset = (m_byteOffset + (DWORD)nNumSamples * sizeof(short) * MockingboardCard::NUM_MB_CHANNELS) % SOUNDBUFFER_SIZE;
+	//
 
-	if (m_outputToRiff)
-		RiffPutSamples(&m_mixBuffer[0], nNumSamples);
+	m_mockingboardSource.Write(&m_mixBuffer[0], nNumSamples);
 }
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Core.h"
-#include "SoundCore.h"
+#include "SoundMixer.h"
 #include "Mockingboard.h"
 
 class MockingboardCardManager
@@ -9,11 +9,7 @@ class MockingboardCardManager
 public:
 	MockingboardCardManager(void)
 	{
-		m_numSamplesError = 0;
-		m_byteOffset = (DWORD)-1;
 		m_cyclesThisAudioFrame = 0;
-		m_userVolume = 0;
-		m_outputToRiff = false;
 		m_enableExtraCardTypes = false;
 
 		// NB. Cmd line has already been processed
@@ -32,7 +28,6 @@ public:
 	bool IsActive(void);
 	DWORD GetVolume(void);
 	void SetVolume(DWORD volume, DWORD volumeMax);
-	void OutputToRiff(void) { m_outputToRiff = true; }
 	void SetEnableExtraCardTypes(bool enable) { m_enableExtraCardTypes = enable; }
 	bool GetEnableExtraCardTypes(void);
 
@@ -60,15 +55,15 @@ private:
 	static const SHORT WAVE_DATA_MIN = (SHORT)0x8000;
 	static const SHORT WAVE_DATA_MAX = (SHORT)0x7FFF;
 
+	static const int ATTENUATION_Q15 = (2 << 15) / 3;	// 2/3 (see MixAllAndCopyToRingBuffer())
+
 	short m_mixBuffer[SOUNDBUFFER_SIZE / sizeof(short)];
-	VOICE m_mockingboardVoice;
+	int m_sumBufferL[MAX_SAMPLES];	// Sum of all voices, before attenuation
+	int m_sumBufferR[MAX_SAMPLES];
+	SoundSource m_mockingboardSource;
 
 	//
 
-	int m_numSamplesError;
-	DWORD m_byteOffset;
 	UINT m_cyclesThisAudioFrame;
-	DWORD m_userVolume;	// GUI's slide volume
-	bool m_outputToRiff;
 	bool m_enableExtraCardTypes;
 };
@@ -45,7 +45,7 @@ Etc.
 #include "MouseInterface.h"
 #include "Common.h"
 
-#include "Core.h"	// g_SynchronousEventMgr
+#include "Core.h"	// GetSynchronousEventMgr()
 #include "CardManager.h"
 #include "CPU.h"
 #include "Interface.h"	// FrameSetCursorPosByMousePos()
@@ -155,7 +155,7 @@ CMouseInterface::~CMouseInterface()
 	delete [] m_pSlotRom;
 
 	if (m_syncEvent.m_active)
-		g_SynchronousEventMgr.Remove(m_syncEvent.m_id);
+		GetSynchronousEventMgr().Remove(m_syncEvent.m_id);
 }
 
 //===========================================================================
@@ -182,9 +182,9 @@ void CMouseInterface::InitializeIO(LPBYTE pCxRomPeripheral)
 	SetSlotRom();	// Pre: m_bActive == true
 	RegisterIoHandler(m_slot, &CMouseInterface::IORead, &CMouseInterface::IOWrite, NULL, NULL, this, NULL);
 
-	if (m_syncEvent.m_active) g_SynchronousEventMgr.Remove(m_syncEvent.m_id);
+	if (m_syncEvent.m_active) GetSynchronousEventMgr().Remove(m_syncEvent.m_id);
 	m_syncEvent.m_cyclesRemaining = NTSC_GetCyclesUntilVBlank(0);
-	g_SynchronousEventMgr.Insert(&m_syncEvent);
+	GetSynchronousEventMgr().Insert(&m_syncEvent);
 }
 
 #if 0
@@ -237,7 +237,7 @@ void CMouseInterface::SetSlotRom()
 
 	UINT uOffset = (m_by6821B << 7) & 0x0700;
 	memcpy(pCxRomPeripheral+m_slot*256, m_pSlotRom+uOffset, 256);
-	if (mem)
+	if (mem && !MemIsPagingByPointer())	// NB. pointer-based paging reads directly from pCxRomPeripheral
 		memcpy(mem+0xC000+m_slot*256, m_pSlotRom+uOffset, 256);
 }
 
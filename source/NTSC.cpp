@@ -55,6 +55,15 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	#define INLINE inline
 #endif
 
+// 4-pixel wide blends for the batched (14M pixels per 6502 cycle) framebuffer writes; otherwise scalar only
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+	#define NTSC_SIMD_SSE2 1
+	#include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+	#define NTSC_SIMD_NEON 1
+	#include <arm_neon.h>
+#endif
+
 	#define PI 3.1415926535898f
 	#define DEG_TO_RAD(x) (PI*(x)/180.f) // 2PI=360, PI=180,PI/2=90,PI/4=45
 	#define RAD_45  PI*0.25f
@@ -121,6 +130,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static UpdatePixelFunc_t g_pFuncUpdateBnWPixel = 0; //updatePixelBnWMonitorSingleScanline;
 	static UpdatePixelFunc_t g_pFuncUpdateHuePixel = 0; //updatePixelHueMonitorSingleScanline;
 
+	typedef void (*Update14PixelsFunc_t)(uint16_t);
+	static Update14PixelsFunc_t g_pFuncUpdate14BnWPixels = 0; //update14PixelsBnWMonitorSingleScanline;
+	static Update14PixelsFunc_t g_pFuncUpdate14HuePixels = 0; //update14PixelsHueMonitorSingleScanline;
+
 	static uint8_t  g_nTextFlashCounter = 0;
 	static uint16_t g_nTextFlashMask    = 0;
 
@@ -134,6 +147,40 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static int g_nColorPhaseNTSC = INITIAL_COLOR_PHASE;
 	static int g_nSignalBitsNTSC = 0;
 
+	// Scanline cache: skip the visible cycles of a scanline whose inputs are unchanged since it was last rendered
+	// . per visible cycle: the video bytes fetched, and the renderer's state before the cycle (so rendering can resume mid-line)
+	struct ScanlineCycle_t
+	{
+		uint8_t  main;
+		uint8_t  aux;
+		uint8_t  colorPhase;
+		uint8_t  lastColumnPixel;
+		uint16_t signalBits;
+	};
+
+	// . per scanline: the state at the start of the visible part of the line (VIDEO_SCANNER_HORZ_START)
+	struct ScanlineCache_t
+	{
+		bool valid;
+		UpdateScreenFunc_t pFunc;	// Text or graphics screen func for this line
+		bgra_t* pVideoAddress;
+		bool colorBurst;
+		uint16_t textFlashMask;		// Text lines only
+		int videoCharSet;			// Text lines only
+		UINT64 renderSeq;			// For TV styles: this line blends with the previous line, so must re-render if the previous line has since been re-rendered
+		ScanlineCycle_t cycle[VIDEO_SCANNER_MAX_HORZ - VIDEO_SCANNER_HORZ_START];
+	};
+
+	static bool g_bScanlineCacheEnabled = false;
+	static ScanlineCache_t g_aScanlineCache[VIDEO_SCANNER_Y_DISPLAY];
+	static UINT64 g_nScanlineCacheRenderSeq = 0;
+	static int  g_nScanlineCacheAddrLine = -1;		// Line that updateVideoScannerAddress() last set up g_pVideoAddress for
+	static int  g_nScanlineCacheLine = -1;			// Line being tracked (-1 if none)
+	static bool g_bScanlineCacheRecord = false;		// Tracked line's video mode can be cached
+	static bool g_bScanlineCacheSkipping = false;	// Tracked line is being skipped
+	static bool g_bScanlineCacheLineDirty = false;	// Tracked line had a mid-line video mode change
+	static bool g_bScanlineCacheLineRendered = false;
+
 	#define NTSC_NUM_PHASES     4
 	#define NTSC_NUM_SEQUENCES  4096
 
@@ -337,6 +384,15 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static void updatePixelHueMonitorSingleScanline( uint16_t compositeSignal );
 	static void updatePixelHueMonitorDoubleScanline( uint16_t compositeSignal );
 
+	static void update14PixelsBnWColorTVSingleScanline( uint16_t bits );
+	static void update14PixelsBnWColorTVDoubleScanline( uint16_t bits );
+	static void update14PixelsBnWMonitorSingleScanline( uint16_t bits );
+	static void update14PixelsBnWMonitorDoubleScanline( uint16_t bits );
+	static void update14PixelsHueColorTVSingleScanline( uint16_t bits );
+	static void update14PixelsHueColorTVDoubleScanline( uint16_t bits );
+	static void update14PixelsHueMonitorSingleScanline( uint16_t bits );
+	static void update14PixelsHueMonitorDoubleScanline( uint16_t bits );
+
 	static void updateScreenDoubleHires40( long cycles6502 );
 	static void updateScreenDoubleHires80( long cycles6502 );
 	static void updateScreenDoubleLores40( long cycles6502 );
@@ -577,6 +633,120 @@ inline void updateFramebufferMonitorDoubleScanline( uint16_t signal, bgra_t *pTa
 }
 #endif
 
+//===========================================================================
+
+// Batched versions of the above for the 14 pixels of one 6502 cycle:
+// . first shift all 14 bits into g_nSignalBitsNTSC and gather the colours (this part is inherently serial)
+// . then do the framebuffer stores and the inbetween-scanline blends 4 pixels at a time (SSE2/NEON), with a scalar tail
+// The output is bit-identical to 14 calls of the per-pixel functions.
+
+#define NTSC_PIXELS_PER_CYCLE 14
+
+// phaseStride = NTSC_NUM_SEQUENCES for the per-phase hue tables, or 0 for the B&W tables
+INLINE void getScanlineColors14( uint16_t bits, const bgra_t *pTable, const UINT phaseStride, uint32_t *pColors )
+{
+	int signal = g_nSignalBitsNTSC;
+	int phase = g_nColorPhaseNTSC;
+
+	for (int i = 0; i < NTSC_PIXELS_PER_CYCLE; i++)
+	{
+		signal = ((signal << 1) | (bits & 1)) & 0xFFF; bits >>= 1;
+		pColors[i] = *(const uint32_t*) &pTable[phase * phaseStride + signal];
+		phase = (phase + 1) & 3;	// Maintain color-phase, as could be switching graphics/text video modes mid-scanline
+	}
+
+	g_nSignalBitsNTSC = signal;
+	g_nColorPhaseNTSC = phase;
+}
+
+#if NTSC_SIMD_SSE2
+	typedef __m128i pixel4_t;
+	INLINE pixel4_t load4  ( const uint32_t *p )         { return _mm_loadu_si128((const __m128i*)p); }
+	INLINE void     store4 ( uint32_t *p, pixel4_t v )   { _mm_storeu_si128((__m128i*)p, v); }
+	INLINE pixel4_t dup4   ( uint32_t x )                { return _mm_set1_epi32((int)x); }
+	INLINE pixel4_t or4    ( pixel4_t a, pixel4_t b )    { return _mm_or_si128(a, b); }
+	INLINE pixel4_t add4   ( pixel4_t a, pixel4_t b )    { return _mm_add_epi32(a, b); }
+	INLINE pixel4_t half4  ( pixel4_t a )                { return _mm_srli_epi32(_mm_and_si128(a, _mm_set1_epi32(0x00fefefe)), 1); }
+	INLINE pixel4_t quarter4( pixel4_t a )               { return _mm_srli_epi32(_mm_and_si128(a, _mm_set1_epi32(0x00fcfcfc)), 2); }
+#elif NTSC_SIMD_NEON
+	typedef uint32x4_t pixel4_t;
+	INLINE pixel4_t load4  ( const uint32_t *p )         { return vld1q_u32(p); }
+	INLINE void     store4 ( uint32_t *p, pixel4_t v )   { vst1q_u32(p, v); }
+	INLINE pixel4_t dup4   ( uint32_t x )                { return vdupq_n_u32(x); }
+	INLINE pixel4_t or4    ( pixel4_t a, pixel4_t b )    { return vorrq_u32(a, b); }
+	INLINE pixel4_t add4   ( pixel4_t a, pixel4_t b )    { return vaddq_u32(a, b); }
+	INLINE pixel4_t half4  ( pixel4_t a )                { return vshrq_n_u32(vandq_u32(a, vdupq_n_u32(0x00fefefe)), 1); }
+	INLINE pixel4_t quarter4( pixel4_t a )               { return vshrq_n_u32(vandq_u32(a, vdupq_n_u32(0x00fcfcfc)), 2); }
+#endif
+
+// See updateFramebufferTVSingleScanline() & updateFramebufferTVDoubleScanline()
+INLINE void updateFramebufferTV14( const uint32_t *pColors, const bool bSingleScanline )
+{
+	uint32_t *pLine0Curr = getScanlineCurrent();
+	uint32_t *pLine1Prev = getScanlinePreviousInbetween();
+	const uint32_t *pLine2Prev = getScanlinePrevious();
+	uint32_t *pLine1Next = (g_nVideoClockVert == (VIDEO_SCANNER_Y_DISPLAY-1)) ? getScanlineNextInbetween() : NULL;	// GH#650
+
+	int i = 0;
+#if NTSC_SIMD_SSE2 || NTSC_SIMD_NEON
+	const pixel4_t alpha = dup4(ALPHA32_MASK);
+	for (; i <= NTSC_PIXELS_PER_CYCLE-4; i += 4)
+	{
+		const pixel4_t color0 = load4(&pColors[i]);
+		pixel4_t color1 = add4(half4(color0), half4(load4(&pLine2Prev[i])));	// 50% Blend
+		if (bSingleScanline)
+			color1 = half4(color1);		// ... then 50% brightness for inbetween line
+
+		store4(&pLine1Prev[i], or4(color1, alpha));
+		store4(&pLine0Curr[i], color0);
+
+		if (pLine1Next)
+			store4(&pLine1Next[i], or4(bSingleScanline ? quarter4(color0) : half4(color0), alpha));
+	}
+#endif
+	for (; i < NTSC_PIXELS_PER_CYCLE; i++)
+	{
+		const uint32_t color0 = pColors[i];
+		uint32_t color1 = ((color0 & 0x00fefefe) >> 1) + ((pLine2Prev[i] & 0x00fefefe) >> 1);	// 50% Blend
+		if (bSingleScanline)
+			color1 = (color1 & 0x00fefefe) >> 1;	// ... then 50% brightness for inbetween line
+
+		pLine1Prev[i] = color1 | ALPHA32_MASK;
+		pLine0Curr[i] = color0;
+
+		if (pLine1Next)
+			pLine1Next[i] = (bSingleScanline ? ((color0 & 0x00fcfcfc) >> 2) : ((color0 & 0x00fefefe) >> 1)) | ALPHA32_MASK;
+	}
+
+	g_pVideoAddress += NTSC_PIXELS_PER_CYCLE;
+}
+
+// See updateFramebufferMonitorSingleScanline() & updateFramebufferMonitorDoubleScanline()
+INLINE void updateFramebufferMonitor14( const uint32_t *pColors, const bool bSingleScanline )
+{
+	uint32_t *pLine0Curr = getScanlineCurrent();
+	uint32_t *pLine1Next = getScanlineNextInbetween();
+
+	int i = 0;
+#if NTSC_SIMD_SSE2 || NTSC_SIMD_NEON
+	const pixel4_t alpha = dup4(ALPHA32_MASK);
+	for (; i <= NTSC_PIXELS_PER_CYCLE-4; i += 4)
+	{
+		const pixel4_t color0 = load4(&pColors[i]);
+		store4(&pLine1Next[i], bSingleScanline ? alpha : color0);	// Single: remove blending for consistent DHGR MIX mode (GH#631)
+		store4(&pLine0Curr[i], color0);
+	}
+#endif
+	for (; i < NTSC_PIXELS_PER_CYCLE; i++)
+	{
+		const uint32_t color0 = pColors[i];
+		pLine1Next[i] = bSingleScanline ? (0 | ALPHA32_MASK) : color0;
+		pLine0Curr[i] = color0;
+	}
+
+	g_pVideoAddress += NTSC_PIXELS_PER_CYCLE;
+}
+
 //===========================================================================
 inline bool GetColorBurst( void )
 {
@@ -603,54 +773,16 @@ void update7MonoPixels( uint16_t bits )
 inline void updatePixels(uint16_t bits)
 {
 	if (!GetColorBurst())
-	{ 
-		/* #1 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #2 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #3 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #4 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #5 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #6 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #7 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1);
-        g_nLastColumnPixelNTSC = bits & 1;
+	{
+		// Batched equivalent of 14x g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
+		g_pFuncUpdate14BnWPixels(bits);
+		g_nLastColumnPixelNTSC = (bits >> 13) & 1;
 	}
 	else
 	{
-		/* #1 of 7 */                                // abcd efgh ijkl mnop
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0abc defg hijk lmno
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 00ab cdef ghi jklmn
-		/* #2 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 000a bcde fghi jklm
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 abcd efgh ijkl
-		/* #3 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0abc defg hijk
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 00ab cdef ghij
-		/* #4 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 000a bcde fghi
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 abcd efgh
-		/* #5 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 0abc defg
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 00ab cdef
-		/* #6 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 000a bcde
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 0000 abcd
-		/* #7 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 0000 0abc
-		g_pFuncUpdateHuePixel(bits & 1);           
-        g_nLastColumnPixelNTSC = bits & 1;
+		// Batched equivalent of 14x g_pFuncUpdateHuePixel(bits & 1); bits >>= 1;
+		g_pFuncUpdate14HuePixels(bits);
+		g_nLastColumnPixelNTSC = (bits >> 13) & 1;
 	}
 }
 
@@ -801,6 +933,8 @@ inline void updateVideoScannerAddress()
 	g_nColorPhaseNTSC      = INITIAL_COLOR_PHASE;
 	g_nLastColumnPixelNTSC = 0;
 	g_nSignalBitsNTSC      = 0;
+
+	g_nScanlineCacheAddrLine = g_nVideoClockVert;
 }
 
 //===========================================================================
@@ -1241,6 +1375,70 @@ static void updatePixelHueMonitorDoubleScanline (uint16_t compositeSignal)
 	updateColorPhase();
 }
 
+//===========================================================================
+static void update14PixelsBnWColorTVSingleScanline (uint16_t bits)
+{
+	uint32_t aColors[NTSC_PIXELS_PER_CYCLE];
+	getScanlineColors14(bits, g_aBnWColorTVCustom, 0, aColors);
+	updateFramebufferTV14(aColors, true);
+}
+
+//===========================================================================
+static void update14PixelsBnWColorTVDoubleScanline (uint16_t bits)
+{
+	uint32_t aColors[NTSC_PIXELS_PER_CYCLE];
+	getScanlineColors14(bits, g_aBnWColorTVCustom, 0, aColors);
+	updateFramebufferTV14(aColors, false);
+}
+
+//===========================================================================
+static void update14PixelsBnWMonitorSingleScanline (uint16_t bits)
+{
+	uint32_t aColors[NTSC_PIXELS_PER_CYCLE];
+	getScanlineColors14(bits, g_aBnWMonitorCustom, 0, aColors);
+	updateFramebufferMonitor14(aColors, true);
+}
+
+//===========================================================================
+static void update14PixelsBnWMonitorDoubleScanline (uint16_t bits)
+{
+	uint32_t aColors[NTSC_PIXELS_PER_CYCLE];
+	getScanlineColors14(bits, g_aBnWMonitorCustom, 0, aColors);
+	updateFramebufferMonitor14(aColors, false);
+}
+
+//===========================================================================
+static void update14PixelsHueColorTVSingleScanline (uint16_t bits)
+{
+	uint32_t aColors[NTSC_PIXELS_PER_CYCLE];
+	getScanlineColors14(bits, &g_aHueColorTV[0][0], NTSC_NUM_SEQUENCES, aColors);
+	updateFramebufferTV14(aColors, true);
+}
+
+//===========================================================================
+static void update14PixelsHueColorTVDoubleScanline (uint16_t bits)
+{
+	uint32_t aColors[NTSC_PIXELS_PER_CYCLE];
+	getScanlineColors14(bits, &g_aHueColorTV[0][0], NTSC_NUM_SEQUENCES, aColors);
+	updateFramebufferTV14(aColors, false);
+}
+
+//===========================================================================
+static void update14PixelsHueMonitorSingleScanline (uint16_t bits)
+{
+	uint32_t aColors[NTSC_PIXELS_PER_CYCLE];
+	getScanlineColors14(bits, &g_aHueMonitor[0][0], NTSC_NUM_SEQUENCES, aColors);
+	updateFramebufferMonitor14(aColors, true);
+}
+
+//===========================================================================
+static void update14PixelsHueMonitorDoubleScanline (uint16_t bits)
+{
+	uint32_t aColors[NTSC_PIXELS_PER_CYCLE];
+	getScanlineColors14(bits, &g_aHueMonitor[0][0], NTSC_NUM_SEQUENCES, aColors);
+	updateFramebufferMonitor14(aColors, false);
+}
+
 //===========================================================================
 void updateScreenDoubleHires40 (long cycles6502) // wsUpdateVideoHires0
 {
@@ -1876,6 +2074,215 @@ void updateScreenSHR(long cycles6502)
 	}
 }
 
+//===========================================================================
+
+// Scanline cache
+// . Only for the NTSC screen funcs, which render exactly 14 pixels per visible cycle from the byte(s) at the video scanner address
+//   (the RGB/idealized funcs look at neighbouring bytes, so a per-cycle comparison isn't enough).
+// . At the start of the visible part of a line, if the line's signature matches the cache then start skipping.
+//   Each skipped cycle still compares the byte(s) the scanner would fetch, so writes to video memory that race the beam are seen:
+//   on the first difference (or a video mode change), the renderer's state is restored and rendering resumes from that cycle.
+
+static bool isScanlineCacheable(const UpdateScreenFunc_t pFunc)
+{
+	return pFunc == updateScreenText40 || pFunc == updateScreenText80
+		|| pFunc == updateScreenSingleLores40 || pFunc == updateScreenDoubleLores40 || pFunc == updateScreenDoubleLores80
+		|| pFunc == updateScreenSingleHires40 || pFunc == updateScreenDoubleHires40 || pFunc == updateScreenDoubleHires80;
+}
+
+INLINE void getScanlineCycleBytes(const UpdateScreenFunc_t pFunc, uint8_t& main, uint8_t& aux)
+{
+	const bool isHiresAddr = pFunc == updateScreenSingleHires40 || pFunc == updateScreenDoubleHires40 || pFunc == updateScreenDoubleHires80;
+	const uint16_t addr = isHiresAddr ? getVideoScannerAddressHGR() : getVideoScannerAddressTXT();
+
+	main = *MemGetMainPtr(addr);
+
+	const bool hasAux = pFunc == updateScreenText80 || pFunc == updateScreenDoubleLores80 || pFunc == updateScreenDoubleHires80;
+	aux = hasAux ? *MemGetAuxPtr(addr) : 0;
+}
+
+static void invalidateScanlineCache(void)
+{
+	for (UINT i = 0; i < VIDEO_SCANNER_Y_DISPLAY; i++)
+		g_aScanlineCache[i].valid = false;
+}
+
+// Stop skipping the tracked line: restore the renderer's state for the current cycle, so that rendering continues from here
+static void resumeScanline(void)
+{
+	ScanlineCache_t& line = g_aScanlineCache[g_nScanlineCacheLine];
+	const UINT i = g_nVideoClockHorz - VIDEO_SCANNER_HORZ_START;
+	const ScanlineCycle_t& cycle = line.cycle[i];
+
+	g_pVideoAddress        = line.pVideoAddress + i * NTSC_PIXELS_PER_CYCLE;
+	g_nColorPhaseNTSC      = cycle.colorPhase;
+	g_nLastColumnPixelNTSC = cycle.lastColumnPixel;
+	g_nSignalBitsNTSC      = cycle.signalBits;
+
+	g_bScanlineCacheSkipping = false;
+	line.valid = false;	// Until the end of the line
+}
+
+// Stop tracking the current line (eg. the video scanner's position has been changed)
+static void resetScanlineTracking(void)
+{
+	g_nScanlineCacheLine = -1;
+	g_bScanlineCacheSkipping = false;
+}
+
+static void beginScanline(void)
+{
+	resetScanlineTracking();
+
+	if (g_nScanlineCacheAddrLine != g_nVideoClockVert)
+		return;	// g_pVideoAddress isn't for this line (eg. after NTSC_VideoClockResync()), so don't track it
+
+	const UpdateScreenFunc_t pFunc = (g_nVideoMixed && g_nVideoClockVert >= VIDEO_SCANNER_Y_MIXED) ? g_pFuncUpdateTextScreen : g_pFuncUpdateGraphicsScreen;
+	const bool isText = pFunc == updateScreenText40 || pFunc == updateScreenText80;
+	const uint16_t textFlashMask = isText ? g_nTextFlashMask : 0;
+	const int videoCharSet = isText ? g_nVideoCharSet : 0;
+
+	const bool isTV = g_pFuncUpdate14BnWPixels == update14PixelsBnWColorTVSingleScanline || g_pFuncUpdate14BnWPixels == update14PixelsBnWColorTVDoubleScanline;
+
+	ScanlineCache_t& line = g_aScanlineCache[g_nVideoClockVert];
+
+	g_nScanlineCacheLine = g_nVideoClockVert;
+	g_bScanlineCacheRecord = isScanlineCacheable(pFunc);
+	g_bScanlineCacheLineDirty = false;
+	g_bScanlineCacheLineRendered = false;
+
+	if (g_bScanlineCacheRecord && line.valid
+		&& line.pFunc == pFunc
+		&& line.pVideoAddress == g_pVideoAddress
+		&& line.colorBurst == GetColorBurst()
+		&& line.textFlashMask == textFlashMask
+		&& line.videoCharSet == videoCharSet
+		&& line.cycle[0].signalBits == g_nSignalBitsNTSC && line.cycle[0].colorPhase == g_nColorPhaseNTSC && line.cycle[0].lastColumnPixel == g_nLastColumnPixelNTSC
+		&& (!isTV || g_nVideoClockVert == 0 || g_aScanlineCache[g_nVideoClockVert-1].renderSeq < line.renderSeq))
+	{
+		g_bScanlineCacheSkipping = true;
+		return;
+	}
+
+	line.valid = false;
+	line.pFunc = pFunc;
+	line.pVideoAddress = g_pVideoAddress;
+	line.colorBurst = GetColorBurst();
+	line.textFlashMask = textFlashMask;
+	line.videoCharSet = videoCharSet;
+}
+
+static void endScanline(void)
+{
+	if (g_bScanlineCacheLineRendered)
+		g_aScanlineCache[g_nScanlineCacheLine].valid = g_bScanlineCacheRecord && !g_bScanlineCacheLineDirty;
+
+	resetScanlineTracking();
+}
+
+// The video mode (or anything else that affects rendering) is changing, so the rest of the tracked line must be rendered, and not cached
+static void scanlineVideoModeChanged(void)
+{
+	if (g_nScanlineCacheLine != g_nVideoClockVert || g_nVideoClockHorz < VIDEO_SCANNER_HORZ_START)
+		return;
+
+	if (g_bScanlineCacheSkipping)
+		resumeScanline();
+
+	g_bScanlineCacheLineDirty = true;
+}
+
+// Update a single visible cycle (pre: g_nVideoClockVert < VIDEO_SCANNER_Y_DISPLAY && g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
+INLINE void updateScanlineCycle(void)
+{
+	if (g_nScanlineCacheLine != g_nVideoClockVert)
+	{
+		// Untracked: g_pVideoAddress may point into any line, so nothing in the cache can be trusted
+		invalidateScanlineCache();
+		g_pFuncUpdateGraphicsScreen(1);
+		return;
+	}
+
+	ScanlineCache_t& line = g_aScanlineCache[g_nScanlineCacheLine];
+	ScanlineCycle_t& cycle = line.cycle[g_nVideoClockHorz - VIDEO_SCANNER_HORZ_START];
+
+	if (g_bScanlineCacheSkipping)
+	{
+		uint8_t main, aux;
+		getScanlineCycleBytes(line.pFunc, main, aux);
+
+		if (main == cycle.main && aux == cycle.aux)
+		{
+			// Same as updateVideoScannerHorzEOL(), but without drawing anything
+			if (VIDEO_SCANNER_MAX_HORZ == ++g_nVideoClockHorz)
+			{
+				endScanline();
+
+				g_nVideoClockHorz = 0;
+				if (++g_nVideoClockVert < VIDEO_SCANNER_Y_DISPLAY)
+					updateVideoScannerAddress();
+			}
+			return;
+		}
+
+		resumeScanline();
+	}
+
+	if (g_bScanlineCacheRecord)
+	{
+		getScanlineCycleBytes(line.pFunc, cycle.main, cycle.aux);
+		cycle.colorPhase      = g_nColorPhaseNTSC;
+		cycle.lastColumnPixel = g_nLastColumnPixelNTSC;
+		cycle.signalBits      = g_nSignalBitsNTSC;
+	}
+
+	if (!g_bScanlineCacheLineRendered)
+	{
+		g_bScanlineCacheLineRendered = true;
+		line.renderSeq = ++g_nScanlineCacheRenderSeq;
+	}
+
+	const bool isEOL = g_nVideoClockHorz == (VIDEO_SCANNER_MAX_HORZ-1);
+	if (isEOL)
+		endScanline();	// NB. Before the screen func's EOL calls updateVideoScannerAddress() for the next line
+
+	g_pFuncUpdateGraphicsScreen(1);
+}
+
+// Same as g_pFuncUpdateGraphicsScreen(cycles6502), but via the scanline cache (if enabled)
+// Pre: cycles6502 doesn't span the start of the frame or line 160 (see VideoUpdateCycles())
+static void updateScreen(long cycles6502)
+{
+	if (!g_bScanlineCacheEnabled || g_pFuncUpdateGraphicsScreen == updateScreenSHR)
+	{
+		g_pFuncUpdateGraphicsScreen(cycles6502);
+		return;
+	}
+
+	while (cycles6502 > 0)
+	{
+		if (g_nVideoClockVert < VIDEO_SCANNER_Y_DISPLAY && g_nVideoClockHorz >= VIDEO_SCANNER_HORZ_START)
+		{
+			if (g_nVideoClockHorz == VIDEO_SCANNER_HORZ_START)
+				beginScanline();
+
+			updateScanlineCycle();
+			cycles6502--;
+			continue;
+		}
+
+		// Not visible: update up to the next visible cycle, or to the end of the frame
+		long cycles = (g_nVideoClockVert < VIDEO_SCANNER_Y_DISPLAY)
+			? VIDEO_SCANNER_HORZ_START - g_nVideoClockHorz
+			: (g_videoScannerMaxVert - g_nVideoClockVert) * VIDEO_SCANNER_MAX_HORZ - g_nVideoClockHorz;
+		if (cycles > cycles6502)
+			cycles = cycles6502;
+
+		g_pFuncUpdateGraphicsScreen(cycles);
+		cycles6502 -= cycles;
+	}
+}
+
 // Functions (Public) _____________________________________________________________________________
 
 //===========================================================================
@@ -1906,6 +2313,8 @@ uint32_t*NTSC_VideoGetChromaTable( bool bHueTypeMonochrome, bool bMonitorTypeCol
 //===========================================================================
 void NTSC_VideoClockResync(const DWORD dwCyclesThisFrame)
 {
+	resetScanlineTracking();
+
 	g_nVideoClockVert = (uint16_t)(dwCyclesThisFrame / VIDEO_SCANNER_MAX_HORZ) % g_videoScannerMaxVert;
 	g_nVideoClockHorz = (uint16_t)(dwCyclesThisFrame % VIDEO_SCANNER_MAX_HORZ);
 }
@@ -1958,6 +2367,8 @@ uint16_t NTSC_GetVideoVertForDebugger(void)
 //===========================================================================
 void NTSC_SetVideoTextMode( int cols )
 {
+	scanlineVideoModeChanged();
+
 	if (GetVideo().GetVideoType() == VT_COLOR_VIDEOCARD_RGB)
 	{
 		if (cols == 40)
@@ -1974,6 +2385,8 @@ void NTSC_SetVideoTextMode( int cols )
 //===========================================================================
 void NTSC_SetVideoMode( uint32_t uVideoModeFlags, bool bDelay/*=false*/ )
 {
+	scanlineVideoModeChanged();
+
 	g_uNewVideoModeFlags = uVideoModeFlags;
 
 	if (uVideoModeFlags & VF_SHR)
@@ -2195,6 +2608,8 @@ void NTSC_SetVideoMode( uint32_t uVideoModeFlags, bool bDelay/*=false*/ )
 
 void NTSC_SetVideoStyle(void)
 {
+	NTSC_InvalidateScanlineCache();
+
 	const bool half = GetVideo().IsVideoStyle(VS_HALF_SCANLINES);
 	const VideoRefreshRate_e refresh = GetVideo().GetVideoRefreshRate();
 	uint8_t r, g, b;
@@ -2210,11 +2625,15 @@ void NTSC_SetVideoStyle(void)
 			{
 				g_pFuncUpdateBnWPixel = updatePixelBnWColorTVSingleScanline;
 				g_pFuncUpdateHuePixel = updatePixelHueColorTVSingleScanline;
+				g_pFuncUpdate14BnWPixels = update14PixelsBnWColorTVSingleScanline;
+				g_pFuncUpdate14HuePixels = update14PixelsHueColorTVSingleScanline;
 			}
 			else
 			{
 				g_pFuncUpdateBnWPixel = updatePixelBnWColorTVDoubleScanline;
 				g_pFuncUpdateHuePixel = updatePixelHueColorTVDoubleScanline;
+				g_pFuncUpdate14BnWPixels = update14PixelsBnWColorTVDoubleScanline;
+				g_pFuncUpdate14HuePixels = update14PixelsHueColorTVDoubleScanline;
 			}
 			break;
 
@@ -2228,11 +2647,15 @@ void NTSC_SetVideoStyle(void)
 			{
 				g_pFuncUpdateBnWPixel = updatePixelBnWMonitorSingleScanline;
 				g_pFuncUpdateHuePixel = updatePixelHueMonitorSingleScanline;
+				g_pFuncUpdate14BnWPixels = update14PixelsBnWMonitorSingleScanline;
+				g_pFuncUpdate14HuePixels = update14PixelsHueMonitorSingleScanline;
 			}
 			else
 			{
 				g_pFuncUpdateBnWPixel = updatePixelBnWMonitorDoubleScanline;
 				g_pFuncUpdateHuePixel = updatePixelHueMonitorDoubleScanline;
+				g_pFuncUpdate14BnWPixels = update14PixelsBnWMonitorDoubleScanline;
+				g_pFuncUpdate14HuePixels = update14PixelsHueMonitorDoubleScanline;
 			}
 			break;
 
@@ -2242,9 +2665,15 @@ void NTSC_SetVideoStyle(void)
 			b = 0xFF;
 			updateMonochromeTables( r, g, b ); // Custom Monochrome color
 			if (half)
+			{
 				g_pFuncUpdateBnWPixel = g_pFuncUpdateHuePixel = updatePixelBnWColorTVSingleScanline;
+				g_pFuncUpdate14BnWPixels = g_pFuncUpdate14HuePixels = update14PixelsBnWColorTVSingleScanline;
+			}
 			else
+			{
 				g_pFuncUpdateBnWPixel = g_pFuncUpdateHuePixel = updatePixelBnWColorTVDoubleScanline;
+				g_pFuncUpdate14BnWPixels = g_pFuncUpdate14HuePixels = update14PixelsBnWColorTVDoubleScanline;
+			}
 			break;
 
 		case VT_MONO_AMBER:
@@ -2279,9 +2708,15 @@ void NTSC_SetVideoStyle(void)
 _mono:
 			updateMonochromeTables( r, g, b ); // Custom Monochrome color
 			if (half)
+			{
 				g_pFuncUpdateBnWPixel = g_pFuncUpdateHuePixel = updatePixelBnWMonitorSingleScanline;
+				g_pFuncUpdate14BnWPixels = g_pFuncUpdate14HuePixels = update14PixelsBnWMonitorSingleScanline;
+			}
 			else
+			{
 				g_pFuncUpdateBnWPixel = g_pFuncUpdateHuePixel = updatePixelBnWMonitorDoubleScanline;
+				g_pFuncUpdate14BnWPixels = g_pFuncUpdate14HuePixels = update14PixelsBnWMonitorDoubleScanline;
+			}
 			break;
 	}
 
@@ -2299,6 +2734,9 @@ void NTSC_Destroy(void)
 	g_pVideoAddress = 0;
 	g_kFrameBufferWidth = 0;
 	memset(g_pScanLines, 0, sizeof(g_pScanLines));
+
+	resetScanlineTracking();
+	invalidateScanlineCache();
 }
 
 void NTSC_VideoInit( uint8_t* pFramebuffer ) // wsVideoInit
@@ -2395,6 +2833,8 @@ void NTSC_VideoReinitialize( DWORD cyclesThisFrame, bool bInitVideoScannerAddres
 		cyclesThisFrame %= g_videoScanner6502Cycles;
 	}
 
+	resetScanlineTracking();
+
 	g_nVideoClockVert = (uint16_t) (cyclesThisFrame / VIDEO_SCANNER_MAX_HORZ);
 	g_nVideoClockHorz = cyclesThisFrame % VIDEO_SCANNER_MAX_HORZ;
 
@@ -2414,12 +2854,39 @@ void NTSC_VideoInitAppleType ()
 		g_pHorzClockOffset = APPLE_IIP_HORZ_CLOCK_OFFSET;
 
 	set_csbits();
+
+	NTSC_InvalidateScanlineCache();	// Charset may have changed
 }
 
 //===========================================================================
 void NTSC_VideoInitChroma()
 {
 	initChromaPhaseTables();
+
+	NTSC_InvalidateScanlineCache();
+}
+
+//===========================================================================
+
+// When enabled, visible cycles of scanlines whose video memory, video mode & video style are unchanged aren't re-rendered
+void NTSC_SetScanlineCache(bool enable)
+{
+	g_bScanlineCacheEnabled = enable;
+
+	resetScanlineTracking();
+	invalidateScanlineCache();
+}
+
+bool NTSC_IsScanlineCacheEnabled(void)
+{
+	return g_bScanlineCacheEnabled;
+}
+
+// Call when the framebuffer or anything else that affects rendering is changed outside of the video scanner
+void NTSC_InvalidateScanlineCache(void)
+{
+	scanlineVideoModeChanged();	// Render the rest of the current line
+	invalidateScanlineCache();
 }
 
 //===========================================================================
@@ -2444,12 +2911,12 @@ static void VideoUpdateCycles( int cyclesLeftToUpdate )
 	{
 		const int cyclesToLine160 = VIDEO_SCANNER_MAX_HORZ * (VIDEO_SCANNER_Y_MIXED - g_nVideoClockVert - 1) + cyclesToEndOfLine;
 		int cycles = cyclesLeftToUpdate < cyclesToLine160 ? cyclesLeftToUpdate : cyclesToLine160;
-		g_pFuncUpdateGraphicsScreen(cycles);						// lines [currV...159]
+		updateScreen(cycles);										// lines [currV...159]
 		cyclesLeftToUpdate -= cycles;
 
 		const int cyclesFromLine160ToLine261 = g_videoScanner6502Cycles - (VIDEO_SCANNER_MAX_HORZ * VIDEO_SCANNER_Y_MIXED);
 		cycles = cyclesLeftToUpdate < cyclesFromLine160ToLine261 ? cyclesLeftToUpdate : cyclesFromLine160ToLine261;
-		g_pFuncUpdateGraphicsScreen(cycles);						// lines [160..191..261]
+		updateScreen(cycles);										// lines [160..191..261]
 		cyclesLeftToUpdate -= cycles;
 
 		// Any remaining cyclesLeftToUpdate: lines [0...currV)
@@ -2458,19 +2925,19 @@ static void VideoUpdateCycles( int cyclesLeftToUpdate )
 	{
 		const int cyclesToLine262 = VIDEO_SCANNER_MAX_HORZ * (g_videoScannerMaxVert - g_nVideoClockVert - 1) + cyclesToEndOfLine;
 		int cycles = cyclesLeftToUpdate < cyclesToLine262 ? cyclesLeftToUpdate : cyclesToLine262;
-		g_pFuncUpdateGraphicsScreen(cycles);						// lines [currV...261]
+		updateScreen(cycles);										// lines [currV...261]
 		cyclesLeftToUpdate -= cycles;
 
 		const int cyclesFromLine0ToLine159 = VIDEO_SCANNER_MAX_HORZ * VIDEO_SCANNER_Y_MIXED;
 		cycles = cyclesLeftToUpdate < cyclesFromLine0ToLine159 ? cyclesLeftToUpdate : cyclesFromLine0ToLine159;
-		g_pFuncUpdateGraphicsScreen(cycles);					// lines [0..159]
+		updateScreen(cycles);									// lines [0..159]
 		cyclesLeftToUpdate -= cycles;
 
 		// Any remaining cyclesLeftToUpdate: lines [160...currV)
 	}
 
 	if (cyclesLeftToUpdate)
-		g_pFuncUpdateGraphicsScreen(cyclesLeftToUpdate);
+		updateScreen(cyclesLeftToUpdate);
 }
 
 //===========================================================================
@@ -2511,6 +2978,7 @@ void NTSC_VideoRedrawWholeScreen( void )
 	// . So the redraw must start at H-pos=0 & with the usual reinit for the start of a new line
 	const uint16_t horz = g_nVideoClockHorz;
 	g_nVideoClockHorz = 0;
+	resetScanlineTracking();
 	updateVideoScannerAddress();
 
 	VideoUpdateCycles(g_videoScanner6502Cycles);
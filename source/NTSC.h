@@ -19,6 +19,9 @@ void NTSC_VideoInit(uint8_t *pFramebuffer);
 void NTSC_VideoReinitialize(DWORD cyclesThisFrame, bool bInitVideoScannerAddress);
 void NTSC_VideoInitAppleType(void);
 void NTSC_VideoInitChroma(void);
+void NTSC_SetScanlineCache(bool enable);
+bool NTSC_IsScanlineCacheEnabled(void);
+void NTSC_InvalidateScanlineCache(void);
 void NTSC_VideoUpdateCycles(UINT cycles6502);
 void NTSC_VideoRedrawWholeScreen(void);
 
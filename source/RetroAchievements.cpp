@@ -70,7 +70,7 @@ static unsigned char MainRAMReader(size_t nOffs)
 static void MainRAMWriter(size_t nOffs, unsigned char nVal)
 {
     assert(nOffs <= 0xFFFF);
-    memdirty[nOffs >> 8] |= 1;
+    MemSetDirty((WORD)nOffs);
     *MemGetMainPtr((WORD)nOffs) = nVal;
 }
 
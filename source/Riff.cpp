@@ -29,19 +29,16 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "StdAfx.h"
 #include "Riff.h"
 
-static HANDLE g_hRiffFile = INVALID_HANDLE_VALUE;
-static DWORD dwTotalOffset;
-static DWORD dwDataOffset;
-static unsigned int g_NumChannels = 2;
-
-bool RiffInitWriteFile(const char* pszFile, unsigned int sample_rate, unsigned int NumChannels)
+bool RiffWriter::Open(const char* pszFile, unsigned int sample_rate, unsigned int NumChannels)
 {
-	g_hRiffFile = CreateFile(pszFile, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+	Close();
+
+	m_hFile = CreateFile(pszFile, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
 
-	if(g_hRiffFile == INVALID_HANDLE_VALUE)
+	if(m_hFile == INVALID_HANDLE_VALUE)
 		return false;
 
-	g_NumChannels = NumChannels;
+	m_numChannels = NumChannels;
 
 	//
 
@@ -50,53 +47,53 @@ bool RiffInitWriteFile(const char* pszFile, unsigned int sample_rate, unsigned i
 
 	DWORD dwNumberOfBytesWritten;
 
-	WriteFile(g_hRiffFile, "RIFF", 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, "RIFF", 4, &dwNumberOfBytesWritten, NULL);
 
 	temp32 = 0;				// total size
-	dwTotalOffset = SetFilePointer(g_hRiffFile, 0, NULL, FILE_CURRENT);
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	m_totalOffset = SetFilePointer(m_hFile, 0, NULL, FILE_CURRENT);
+	WriteFile(m_hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
-	WriteFile(g_hRiffFile, "WAVE", 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, "WAVE", 4, &dwNumberOfBytesWritten, NULL);
 
 	//
 
-	WriteFile(g_hRiffFile, "fmt ", 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, "fmt ", 4, &dwNumberOfBytesWritten, NULL);
 
 	temp32 = 16;			// format length
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
 	temp16 = 1;				// PCM format
-	WriteFile(g_hRiffFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
 
 	temp16 = NumChannels;		// channels
-	WriteFile(g_hRiffFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
 
 	temp32 = sample_rate;	// sample rate
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
 	temp32 = sample_rate * 2 * NumChannels;	// bytes/second
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
 	temp16 = 2 * NumChannels;	// block align
-	WriteFile(g_hRiffFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
 
 	temp16 = 16;			// bits/sample
-	WriteFile(g_hRiffFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, &temp16, 2, &dwNumberOfBytesWritten, NULL);
 
 	//
 
-	WriteFile(g_hRiffFile, "data", 4, &dwNumberOfBytesWritten, NULL);
+	WriteFile(m_hFile, "data", 4, &dwNumberOfBytesWritten, NULL);
 
 	temp32 = 0;				// data length
-	dwDataOffset = SetFilePointer(g_hRiffFile, 0, NULL, FILE_CURRENT);
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	m_dataOffset = SetFilePointer(m_hFile, 0, NULL, FILE_CURRENT);
+	WriteFile(m_hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
 	return true;
 }
 
-bool RiffFinishWriteFile()
+bool RiffWriter::Close(void)
 {
-	if(g_hRiffFile == INVALID_HANDLE_VALUE)
+	if(m_hFile == INVALID_HANDLE_VALUE)
 		return false;
 
 	//
@@ -105,22 +102,24 @@ bool RiffFinishWriteFile()
 
 	DWORD dwNumberOfBytesWritten;
 	
-	DWORD fileSize = SetFilePointer(g_hRiffFile, 0, NULL, FILE_END);
+	DWORD fileSize = SetFilePointer(m_hFile, 0, NULL, FILE_END);
 
-	temp32 = fileSize - (dwTotalOffset + 4);
-	SetFilePointer(g_hRiffFile, dwTotalOffset, NULL, FILE_BEGIN);
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	temp32 = fileSize - (m_totalOffset + 4);
+	SetFilePointer(m_hFile, m_totalOffset, NULL, FILE_BEGIN);
+	WriteFile(m_hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
-	temp32 = fileSize - (dwDataOffset + 4);
-	SetFilePointer(g_hRiffFile, dwDataOffset, NULL, FILE_BEGIN);
-	WriteFile(g_hRiffFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
+	temp32 = fileSize - (m_dataOffset + 4);
+	SetFilePointer(m_hFile, m_dataOffset, NULL, FILE_BEGIN);
+	WriteFile(m_hFile, &temp32, 4, &dwNumberOfBytesWritten, NULL);
 
-	return CloseHandle(g_hRiffFile) ? true : false;
+	const BOOL bRes = CloseHandle(m_hFile);
+	m_hFile = INVALID_HANDLE_VALUE;
+	return bRes ? true : false;
 }
 
-bool RiffPutSamples(const short* buf, unsigned int uSamples)
+bool RiffWriter::PutSamples(const short* buf, unsigned int uSamples)
 {
-	if(g_hRiffFile == INVALID_HANDLE_VALUE)
+	if(m_hFile == INVALID_HANDLE_VALUE)
 		return false;
 
 	//
@@ -128,9 +127,9 @@ bool RiffPutSamples(const short* buf, unsigned int uSamples)
 	DWORD dwNumberOfBytesWritten;
 
 	BOOL bRes = WriteFile(
-		g_hRiffFile,
+		m_hFile,
 		buf,
-		uSamples * sizeof(short) * g_NumChannels,
+		uSamples * sizeof(short) * m_numChannels,
 		&dwNumberOfBytesWritten,
 		NULL);
 
@@ -1,5 +1,27 @@
 #pragma once
 
-bool RiffInitWriteFile(const char* pszFile, unsigned int sample_rate, unsigned int NumChannels);
-bool RiffFinishWriteFile(void);
-bool RiffPutSamples(const short* buf, unsigned int uSamples);
+// Streaming WAV (RIFF) file writer: the header's size fields are patched up by Close()
+class RiffWriter
+{
+public:
+	RiffWriter(void)
+	{
+		m_hFile = INVALID_HANDLE_VALUE;
+		m_totalOffset = 0;
+		m_dataOffset = 0;
+		m_numChannels = 2;
+	}
+	~RiffWriter(void) { Close(); }
+
+	bool Open(const char* pszFile, unsigned int sample_rate, unsigned int NumChannels);
+	bool Close(void);
+	bool PutSamples(const short* buf, unsigned int uSamples);
+	bool IsOpen(void) { return m_hFile != INVALID_HANDLE_VALUE; }
+	unsigned int GetNumChannels(void) { return m_numChannels; }
+
+private:
+	HANDLE m_hFile;
+	DWORD m_totalOffset;
+	DWORD m_dataOffset;
+	unsigned int m_numChannels;
+};
@@ -65,7 +65,7 @@ BYTE __stdcall SAMCard::IOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG n
 	BYTE res = SpkrToggle(pc, addr, bWrite, d, nExecutedCycles);
 
 	// The DAC in the SAM uses unsigned 8 bit samples
-	// The WAV data that g_nSpeakerData is loaded into is a signed short
+	// The WAV data that the speaker level is loaded into is a signed short
 	//
 	// We convert unsigned 8 bit to signed by toggling the most significant bit
 	// 
@@ -78,7 +78,7 @@ BYTE __stdcall SAMCard::IOWrite(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG n
 	//                                                        
 	// SAM is 8 bit, PC WAV is 16 so shift audio to the MSB (<< 8)
 
-	g_nSpeakerData = (d ^ 0x80) << 8;
+	Spkr_SetDACLevel((d ^ 0x80) << 8);
 
 	// make speaker quieter so eg: a metronome click through the
 	// Apple speaker is softer vs. the analogue SAM output.
@@ -52,7 +52,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "CPU.h"
 #include "Log.h"
 #include "Memory.h"
-#include "SoundCore.h"
+#include "SoundMixer.h"
 #include "SSI263.h"
 #include "SSI263Phonemes.h"
 
@@ -330,17 +330,19 @@ void SSI263::Votrax_Write(BYTE value)
 
 void SSI263::Play(unsigned int nPhoneme)
 {
-	if (!SSI263SingleVoice.lpDSBvoice)
+	if (!m_source.GetSampleRate())	// DSInit() failed
 	{
 		return;
 	}
 
-	if (!SSI263SingleVoice.bActive)
+	if (!m_source.IsActive())
 	{
-		bool bRes = DSZeroVoiceBuffer(&SSI263SingleVoice, m_kDSBufferByteSize);
-		LogFileOutput("SSI263::Play: DSZeroVoiceBuffer(), res=%d\n", bRes ? 1 : 0);
+		bool bRes = GetSoundMixer().AddSource(&m_source);
+		LogFileOutput("SSI263::Play: AddSource(), res=%d\n", bRes ? 1 : 0);
 		if (!bRes)
 			return;
+
+		m_resync = true;
 	}
 
 	if (m_dbgFirst)
@@ -400,8 +402,7 @@ void SSI263::Play(unsigned int nPhoneme)
 
 void SSI263::Stop(void)
 {
-	if (SSI263SingleVoice.lpDSBvoice && SSI263SingleVoice.bActive)
-		DSVoiceStop(&SSI263SingleVoice);
+	GetSoundMixer().RemoveSource(&m_source);
 }
 
 //-----------------------------------------------------------------------------
@@ -414,7 +415,7 @@ void SSI263::Update(void)
 {
 	UpdateAccurateLength();
 
-	if (!SSI263SingleVoice.bActive)
+	if (!m_source.IsActive())
 		return;
 
 	if (g_bFullSpeed)	// ie. only true when IsPhonemeActive() is true
@@ -444,147 +445,60 @@ void SSI263::Update(void)
 
 	// NB. next call to this function: nowNormalSpeed = false
 	if (nowNormalSpeed)
-		m_byteOffset = (DWORD)-1;	// ...which resets m_numSamplesError below
-
-	//-------------
-
-	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
-	HRESULT hr = SSI263SingleVoice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
-	if (FAILED(hr))
-		return;
+		m_resync = true;
 
-	bool prefillBufferOnInit = false;
-
-	if (m_byteOffset == (DWORD)-1)
+	if (m_resync)
 	{
-		// First time in this func (or transitioned from full-speed to normal speed, or a ring-buffer reset)
+		// First time in this func (or transitioned from full-speed to normal speed)
+		// . discard anything still buffered, and restart timing from now
+		// . NB. no need to prefill with silence, as the mixer waits for a cushion of samples before consuming this source
 #ifdef DBG_SSI263_UPDATE
 		double fTicksSecs = (double)GetTickCount() / 1000.0;
-		LogOutput("%010.3f: [SSUpdtInit%1d]PC=%08X, WC=%08X, Diff=%08X, Off=%08X xxx\n", fTicksSecs, m_device, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor - dwCurrentPlayCursor, m_byteOffset);
-#endif
-		m_byteOffset = dwCurrentWriteCursor;
-		m_numSamplesError = 0;
-		prefillBufferOnInit = true;
-	}
-	else
-	{
-		// Check that our offset isn't between Play & Write positions
-
-		if (dwCurrentWriteCursor > dwCurrentPlayCursor)
-		{
-			// |-----PxxxxxW-----|
-			if ((m_byteOffset > dwCurrentPlayCursor) && (m_byteOffset < dwCurrentWriteCursor))
-			{
-#ifdef DBG_SSI263_UPDATE
-				double fTicksSecs = (double)GetTickCount() / 1000.0;
-				LogOutput("%010.3f: [SSUpdt%1d]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X xxx\n", fTicksSecs, m_device, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor - dwCurrentPlayCursor, m_byteOffset);
-#endif
-				m_byteOffset = dwCurrentWriteCursor;
-				m_numSamplesError = 0;
-			}
-		}
-		else
-		{
-			// |xxW----------Pxxx|
-			if ((m_byteOffset > dwCurrentPlayCursor) || (m_byteOffset < dwCurrentWriteCursor))
-			{
-#ifdef DBG_SSI263_UPDATE
-				double fTicksSecs = (double)GetTickCount() / 1000.0;
-				LogOutput("%010.3f: [SSUpdt%1d]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X XXX\n", fTicksSecs, m_device, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor - dwCurrentPlayCursor, m_byteOffset);
+		LogOutput("%010.3f: [SSUpdtInit%1d]\n", fTicksSecs, m_device);
 #endif
-				m_byteOffset = dwCurrentWriteCursor;
-				m_numSamplesError = 0;
-			}
-		}
-	}
-
-	//-------------
-
-	const UINT kMinBytesInBuffer = m_kDSBufferByteSize / 4;	// 25% full
-	int nNumSamples = 0;
-	double updateInterval = 0.0;
-
-	if (prefillBufferOnInit)
-	{
-		// Just prefill first 25% of buffer with zeros:
-		// . so we have a quarter buffer of silence/lag before the real sample data begins.
-		// . NB. this is fine, since it's the steady state; and it's likely that no actual data will ever occur during this initial time.
-		// This means that the '1st phoneme playback time' (in cycles) will be a bit longer for subsequent times.
-
+		m_resync = false;
+		m_source.Flush();
 		m_lastUpdateCycle = GetLastCumulativeCycles();
-
-		nNumSamples = kMinBytesInBuffer / sizeof(short);
-		memset(&m_mixBufferSSI263[0], 0, nNumSamples);
+		return;
 	}
-	else
-	{
-		// For small timer periods, wait for a period of 500cy before updating DirectSound ring-buffer.
-		// NB. A timer period of less than 24cy will yield nNumSamplesPerPeriod=0.
-		const double kMinimumUpdateInterval = 500.0;	// Arbitary (500 cycles = 21 samples)
-		const double kMaximumUpdateInterval = (double)(0xFFFF + 2);	// Max 6522 timer interval (1372 samples)
-
-		_ASSERT(GetLastCumulativeCycles() >= m_lastUpdateCycle);
-		updateInterval = (double)(GetLastCumulativeCycles() - m_lastUpdateCycle);
-		if (updateInterval < kMinimumUpdateInterval)
-			return;
-		if (updateInterval > kMaximumUpdateInterval)
-			updateInterval = kMaximumUpdateInterval;
-
-		m_lastUpdateCycle = GetLastCumulativeCycles();
 
-		const double nIrqFreq = g_fCurrentCLK6502 / updateInterval + 0.5;			// Round-up
-		const int nNumSamplesPerPeriod = (int)((double)(SAMPLE_RATE_SSI263) / nIrqFreq);	// Eg. For 60Hz this is 367
+	//-------------
 
-		nNumSamples = nNumSamplesPerPeriod + m_numSamplesError;						// Apply correction
-		if (nNumSamples <= 0)
-			nNumSamples = 0;
-		if (nNumSamples > 2 * nNumSamplesPerPeriod)
-			nNumSamples = 2 * nNumSamplesPerPeriod;
+	// For small timer periods, wait for a period of 500cy before updating the mixer's ring-buffer.
+	// NB. A timer period of less than 24cy will yield nNumSamplesPerPeriod=0.
+	const double kMinimumUpdateInterval = 500.0;	// Arbitary (500 cycles = 21 samples)
+	const double kMaximumUpdateInterval = (double)(0xFFFF + 2);	// Max 6522 timer interval (1372 samples)
 
-		if (nNumSamples > m_kDSBufferByteSize / sizeof(short))
-			nNumSamples = m_kDSBufferByteSize / sizeof(short);	// Clamp to prevent buffer overflow
+	_ASSERT(GetLastCumulativeCycles() >= m_lastUpdateCycle);
+	double updateInterval = (double)(GetLastCumulativeCycles() - m_lastUpdateCycle);
+	if (updateInterval < kMinimumUpdateInterval)
+		return;
+	if (updateInterval > kMaximumUpdateInterval)
+		updateInterval = kMaximumUpdateInterval;
 
-//		if (nNumSamples)
-//		{ /* Generate new sample data - ie. could merge from all the SSI263 sources */ }
+	m_lastUpdateCycle = GetLastCumulativeCycles();
 
-		//
+	const double nIrqFreq = g_fCurrentCLK6502 / updateInterval + 0.5;			// Round-up
+	const int nNumSamplesPerPeriod = (int)((double)(SAMPLE_RATE_SSI263) / nIrqFreq);	// Eg. For 60Hz this is 367
 
-		int nBytesRemaining = m_byteOffset - dwCurrentPlayCursor;
-		if (nBytesRemaining < 0)
-			nBytesRemaining += m_kDSBufferByteSize;
+	// NB. The mixer calcs the correction factor from this source's backlog, so that it doesn't under/overflow
+	const int numSamplesError = m_source.GetNumSamplesError();
+	int nNumSamples = nNumSamplesPerPeriod + numSamplesError;					// Apply correction
+	if (nNumSamples <= 0)
+		nNumSamples = 0;
+	if (nNumSamples > 2 * nNumSamplesPerPeriod)
+		nNumSamples = 2 * nNumSamplesPerPeriod;
 
-		// Calc correction factor so that play-buffer doesn't under/overflow
-		const int nErrorInc = SoundCore_GetErrorInc();
-		if (nBytesRemaining < kMinBytesInBuffer)
-			m_numSamplesError += nErrorInc;				// < 0.25 of buffer remaining
-		else if (nBytesRemaining > m_kDSBufferByteSize / 2)
-			m_numSamplesError -= nErrorInc;				// > 0.50 of buffer remaining
-		else
-			m_numSamplesError = 0;						// Acceptable amount of data in buffer
-	}
+	if (nNumSamples > m_kDSBufferByteSize / sizeof(short))
+		nNumSamples = m_kDSBufferByteSize / sizeof(short);	// Clamp to prevent buffer overflow
 
 #if defined(DBG_SSI263_UPDATE)
 	double fTicksSecs = (double)GetTickCount() / 1000.0;
-	LogOutput("%010.3f: [SSUpdt%1d]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X, NSE=%08X, Interval=%f\n", fTicksSecs, m_device, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor - dwCurrentPlayCursor, m_byteOffset, nNumSamples, m_numSamplesError, updateInterval);
+	LogOutput("%010.3f: [SSUpdt%1d]    NS=%08X, NSE=%08X, Interval=%f\n", fTicksSecs, m_device, nNumSamples, numSamplesError, updateInterval);
 #endif
 
 	if (nNumSamples == 0)
-	{
-		if (m_numSamplesError)
-		{
-			// Reset ring-buffer if we've had a major interruption, eg. F7 (enter debugger), F8 (configure), F11/12 (save-state), Pause, etc
-			// - this can cause Apple II SSI263 detection code to fail (when either timing one or a sequence of phonemes)
-			// When the AppleWin code restarts and reads the ring-buffer position it'll be at a random point, and maybe nearly full (>50% full)
-			// - so the code waits until it drains (nNumSamples=0 each time)
-			// - but it takes a large number of calls to this func to drain to an acceptable level
-			m_byteOffset = (DWORD)-1;
-#if defined(DBG_SSI263_UPDATE)
-			double fTicksSecs = (double)GetTickCount() / 1000.0;
-			LogOutput("%010.3f: [SSUpdt%1d]    Reset ring-buffer\n", fTicksSecs, m_device);
-#endif
-		}
 		return;
-	}
 
 	//-------------
 
@@ -605,7 +519,7 @@ void SSI263::Update(void)
 		short* pMixBuffer = &m_mixBufferSSI263[0];
 		UINT zeroSize = nNumSamples;
 
-		if (m_phonemeLengthRemaining && !prefillBufferOnInit)
+		if (m_phonemeLengthRemaining)
 		{
 			UINT samplesWritten = 0;
 			while (samplesWritten < (UINT)nNumSamples)
@@ -646,35 +560,13 @@ void SSI263::Update(void)
 		if (zeroSize)
 		{
 			memset(pMixBuffer, 0, zeroSize * sizeof(short));
-
-			if (!prefillBufferOnInit)
-				m_phonemeLeadoutLength -= (m_phonemeLeadoutLength > zeroSize) ? zeroSize : m_phonemeLeadoutLength;
+			m_phonemeLeadoutLength -= (m_phonemeLeadoutLength > zeroSize) ? zeroSize : m_phonemeLeadoutLength;
 		}
 	}
 
 	//
 
-	DWORD dwDSLockedBufferSize0, dwDSLockedBufferSize1;
-	short *pDSLockedBuffer0, *pDSLockedBuffer1;
-
-	hr = DSGetLock(SSI263SingleVoice.lpDSBvoice,
-		m_byteOffset, (DWORD)nNumSamples * sizeof(short) * m_kNumChannels,
-		&pDSLockedBuffer0, &dwDSLockedBufferSize0,
-		&pDSLockedBuffer1, &dwDSLockedBufferSize1);
-	if (FAILED(hr))
-		return;
-
-	memcpy(pDSLockedBuffer0, &m_mixBufferSSI263[0], dwDSLockedBufferSize0);
-	if(pDSLockedBuffer1)
-		memcpy(pDSLockedBuffer1, &m_mixBufferSSI263[dwDSLockedBufferSize0/sizeof(short)], dwDSLockedBufferSize1);
-
-	// Commit sound buffer
-	hr = SSI263SingleVoice.lpDSBvoice->Unlock((void*)pDSLockedBuffer0, dwDSLockedBufferSize0,
-											  (void*)pDSLockedBuffer1, dwDSLockedBufferSize1);
-	if (FAILED(hr))
-		return;
-
-	m_byteOffset = (m_byteOffset + (DWORD)nNumSamples*sizeof(short)*m_kNumChannels) % m_kDSBufferByteSize;
+	m_source.Write(&m_mixBufferSSI263[0], nNumSamples);
 
 	//
 
@@ -834,27 +726,21 @@ void SSI263::SetCardMode(PHASOR_MODE mode)
 bool SSI263::DSInit(void)
 {
 	//
-	// Create single SSI263 voice
+	// Create single SSI263 source
 	//
 
-	HRESULT hr = DSGetSoundBuffer(&SSI263SingleVoice, DSBCAPS_CTRLVOLUME, m_kDSBufferByteSize, SAMPLE_RATE_SSI263, m_kNumChannels, "SSI263");
-	LogFileOutput("SSI263::DSInit: DSGetSoundBuffer(), hr=0x%08X\n", hr);
-	if (FAILED(hr))
+	if (!GetSoundMixer().IsOutputAvailable())
 	{
-		LogFileOutput("SSI263::DSInit: DSGetSoundBuffer failed (%08X)\n", hr);
+		LogFileOutput("SSI263::DSInit: no sound output\n");
 		return false;
 	}
 
-	// Don't DirectSoundBuffer::Play() via DSZeroVoiceBuffer() - instead wait until this SSI263 is actually first used
-	// . different to Speaker & Mockingboard ring buffers
+	// Don't add to the mixer yet - instead wait until this SSI263 is actually first used (see Play())
+	// . different to Speaker & Mockingboard sources
 	// . NB. we have 2x SSI263 per MB card, and it's rare if 1 is used (and *extremely* rare if 2 are used!)
-
-	// Volume might've been setup from value in Registry
-	if (!SSI263SingleVoice.nVolume)
-		SSI263SingleVoice.nVolume = DSBVOLUME_MAX;
-
-	hr = SSI263SingleVoice.lpDSBvoice->SetVolume(SSI263SingleVoice.nVolume);
-	LogFileOutput("SSI263::DSInit: SetVolume(), hr=0x%08X\n", hr);
+	// . NB. Volume might've already been setup from value in Registry
+	m_source.Init("SSI263", SAMPLE_RATE_SSI263, m_kNumChannels);
+	m_source.SetCaptureName(StrFormat("Slot%u-SSI263-%u", m_slot, (UINT)m_device));	// Each SSI263 is captured separately
 
 	return true;
 }
@@ -862,7 +748,6 @@ bool SSI263::DSInit(void)
 void SSI263::DSUninit(void)
 {
 	Stop();
-	DSReleaseSoundBuffer(&SSI263SingleVoice);
 }
 
 //-----------------------------------------------------------------------------
@@ -895,30 +780,17 @@ void SSI263::Reset(const bool powerCycle, const bool isPhasorCard)
 
 void SSI263::Mute(void)
 {
-	if (SSI263SingleVoice.bActive && !SSI263SingleVoice.bMute)
-	{
-		SSI263SingleVoice.lpDSBvoice->SetVolume(DSBVOLUME_MIN);
-		SSI263SingleVoice.bMute = true;
-	}
+	m_source.SetMute(true);
 }
 
 void SSI263::Unmute(void)
 {
-	if (SSI263SingleVoice.bActive && SSI263SingleVoice.bMute)
-	{
-		SSI263SingleVoice.lpDSBvoice->SetVolume(SSI263SingleVoice.nVolume);
-		SSI263SingleVoice.bMute = false;
-	}
+	m_source.SetMute(false);
 }
 
 void SSI263::SetVolume(DWORD dwVolume, DWORD dwVolumeMax)
 {
-	SSI263SingleVoice.dwUserVolume = dwVolume;
-
-	SSI263SingleVoice.nVolume = NewVolume(dwVolume, dwVolumeMax);
-
-	if (SSI263SingleVoice.bActive && !SSI263SingleVoice.bMute)
-		SSI263SingleVoice.lpDSBvoice->SetVolume(SSI263SingleVoice.nVolume);
+	m_source.SetVolume(dwVolume, dwVolumeMax);
 }
 
 //-----------------------------------------------------------------------------
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MockingboardDefs.h"
+#include "SoundMixer.h"
 
 class SSI263
 {
@@ -39,8 +40,7 @@ public:
 
 		//
 
-		m_numSamplesError = 0;
-		m_byteOffset = (DWORD)-1;
+		m_resync = true;
 		m_currSampleSum = 0;
 		m_currNumSamples = 0;
 		m_currSampleMod4 = 0;
@@ -112,7 +112,7 @@ private:
 	static const unsigned short m_kNumChannels = 1;
 	static const DWORD m_kDSBufferByteSize = MAX_SAMPLES * sizeof(short) * m_kNumChannels;
 	short m_mixBufferSSI263[m_kDSBufferByteSize / sizeof(short)];
-	VOICE SSI263SingleVoice;
+	SoundSource m_source;
 
 	//
 
@@ -163,8 +163,7 @@ private:
 
 	//
 
-	int m_numSamplesError;
-	DWORD m_byteOffset;
+	bool m_resync;					// Flush the source & restart timing on next Update()
 	int m_currSampleSum;
 	int m_currNumSamples;
 	UINT m_currSampleMod4;
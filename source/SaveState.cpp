@@ -285,6 +285,15 @@ static void ParseUnitApple2(YamlLoadHelper& yamlLoadHelper, UINT version)
 
 //---
 
+// In-place load (eg. rewind): the cards with media are kept, so their images aren't ejected & re-inserted
+static bool g_loadInPlace = false;
+static bool g_slotLoaded[NUM_SLOTS];
+
+static bool IsCardWithMedia(const SS_CARDTYPE type)
+{
+	return type == CT_Disk2 || type == CT_GenericHDD;
+}
+
 static void ParseSlots(YamlLoadHelper& yamlLoadHelper, UINT unitVersion)
 {
 	if (unitVersion != UNIT_SLOTS_VER)
@@ -316,11 +325,13 @@ static void ParseSlots(YamlLoadHelper& yamlLoadHelper, UINT unitVersion)
 		{
 			SetExpansionMemType(type);	// calls GetCardMgr().Insert() & InsertAux()
 		}
-		else
+		else if (!g_loadInPlace || GetCardMgr().QuerySlot(slot) != type)
 		{
-			GetCardMgr().Insert(slot, type);
+			GetCardMgr().Insert(slot, type, !g_loadInPlace);
 		}
 
+		g_slotLoaded[slot] = true;
+
 		bRes = GetCardMgr().GetRef(slot).LoadSnapshot(yamlLoadHelper, cardVersion);
 
 		yamlLoadHelper.PopMap();
@@ -373,6 +384,58 @@ static void ParseUnit()
 	}
 }
 
+// Pre: yamlHelper has parsed the file header
+// . inPlace: for an in-memory save-state, keep the cards with media (they restore their state without ejecting the images)
+static void LoadState(const bool inPlace)
+{
+	//m_ConfigNew.m_bEnableTheFreezesF8Rom = ?;	// todo: when support saving config
+
+	g_loadInPlace = inPlace;
+
+	for (UINT slot = SLOT0; slot < NUM_SLOTS; slot++)
+	{
+		g_slotLoaded[slot] = false;
+		if (!inPlace || !IsCardWithMedia(GetCardMgr().QuerySlot(slot)))
+			GetCardMgr().Remove(slot, !inPlace);
+	}
+	GetCardMgr().RemoveAux();
+
+	SetCopyProtectionDongleType(DT_EMPTY);
+
+	MemReset();							// Also calls CpuInitialize()
+	GetPravets().Reset();
+
+	KeybReset();
+	GetVideo().SetVidHD(false);			// Set true later only if VidHDCard is instantiated
+	GetVideo().VideoResetState();
+	GetVideo().SetVideoRefreshRate(VR_60HZ);	// Default to 60Hz as older save-states won't contain refresh rate
+	GetCardMgr().GetMockingboardCardMgr().InitializeForLoadingSnapshot();	// GH#609
+#ifdef USE_SPEECH_API
+	g_Speech.Reset();
+#endif
+
+	std::string scalar;
+	while(yamlHelper.GetScalar(scalar))
+	{
+		if (scalar == SS_YAML_KEY_UNIT)
+			ParseUnit();
+		else
+			throw std::runtime_error("Unknown top-level scalar: " + scalar);
+	}
+
+	if (inPlace)
+	{
+		// Kept cards that aren't in the save-state
+		for (UINT slot = SLOT1; slot < NUM_SLOTS; slot++)
+		{
+			if (!g_slotLoaded[slot] && GetCardMgr().QuerySlot(slot) != CT_Empty)
+				GetCardMgr().Remove(slot, false);
+		}
+	}
+
+	GetCardMgr().GetMockingboardCardMgr().SetCumulativeCycles();
+}
+
 static void Snapshot_LoadState_v2(void)
 {
 	bool restart = false;	// Only need to restart if any VM state has change
@@ -403,36 +466,8 @@ static void Snapshot_LoadState_v2(void)
 
 		restart = true;
 
-		//m_ConfigNew.m_bEnableTheFreezesF8Rom = ?;	// todo: when support saving config
-
-		for (UINT slot = SLOT0; slot < NUM_SLOTS; slot++)
-			GetCardMgr().Remove(slot);
-		GetCardMgr().RemoveAux();
-
-		SetCopyProtectionDongleType(DT_EMPTY);
-
-		MemReset();							// Also calls CpuInitialize()
-		GetPravets().Reset();
-
-		KeybReset();
-		GetVideo().SetVidHD(false);			// Set true later only if VidHDCard is instantiated
-		GetVideo().VideoResetState();
-		GetVideo().SetVideoRefreshRate(VR_60HZ);	// Default to 60Hz as older save-states won't contain refresh rate
-		GetCardMgr().GetMockingboardCardMgr().InitializeForLoadingSnapshot();	// GH#609
-#ifdef USE_SPEECH_API
-		g_Speech.Reset();
-#endif
-
-		std::string scalar;
-		while(yamlHelper.GetScalar(scalar))
-		{
-			if (scalar == SS_YAML_KEY_UNIT)
-				ParseUnit();
-			else
-				throw std::runtime_error("Unknown top-level scalar: " + scalar);
-		}
+		LoadState(false);
 
-		GetCardMgr().GetMockingboardCardMgr().SetCumulativeCycles();
 		frame.SetLoadedSaveStateFlag(true);
 
 		// NB. The following disparity should be resolved:
@@ -495,56 +530,61 @@ void Snapshot_LoadState()
 
 //-----------------------------------------------------------------------------
 
-void Snapshot_SaveState(void)
+static void SaveState(YamlSaveHelper& yamlSaveHelper)
 {
-	LogFileOutput("Saving Save-State to %s\n", g_strSaveStatePathname.c_str());
-	try
+	yamlSaveHelper.FileHdr(SS_FILE_VER);
+
+	// Unit: Apple2
 	{
-		YamlSaveHelper yamlSaveHelper(g_strSaveStatePathname);
-		yamlSaveHelper.FileHdr(SS_FILE_VER);
+		yamlSaveHelper.UnitHdr(GetSnapshotUnitApple2Name(), UNIT_APPLE2_VER);
+		YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
+
+		yamlSaveHelper.Save("%s: %s\n", SS_YAML_KEY_MODEL, GetApple2TypeAsString().c_str());
+		CpuSaveSnapshot(yamlSaveHelper);
+		JoySaveSnapshot(yamlSaveHelper);
+		KeybSaveSnapshot(yamlSaveHelper);
+		SpkrSaveSnapshot(yamlSaveHelper);
+		GetVideo().VideoSaveSnapshot(yamlSaveHelper);
+		MemSaveSnapshot(yamlSaveHelper);
+	}
 
-		// Unit: Apple2
-		{
-			yamlSaveHelper.UnitHdr(GetSnapshotUnitApple2Name(), UNIT_APPLE2_VER);
-			YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
-
-			yamlSaveHelper.Save("%s: %s\n", SS_YAML_KEY_MODEL, GetApple2TypeAsString().c_str());
-			CpuSaveSnapshot(yamlSaveHelper);
-			JoySaveSnapshot(yamlSaveHelper);
-			KeybSaveSnapshot(yamlSaveHelper);
-			SpkrSaveSnapshot(yamlSaveHelper);
-			GetVideo().VideoSaveSnapshot(yamlSaveHelper);
-			MemSaveSnapshot(yamlSaveHelper);
-		}
+	// Unit: Aux slot
+	MemSaveSnapshotAux(yamlSaveHelper);
 
-		// Unit: Aux slot
-		MemSaveSnapshotAux(yamlSaveHelper);
+	// Unit: Slots
+	{
+		yamlSaveHelper.UnitHdr(GetSnapshotUnitSlotsName(), UNIT_SLOTS_VER);
+		YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
 
-		// Unit: Slots
-		{
-			yamlSaveHelper.UnitHdr(GetSnapshotUnitSlotsName(), UNIT_SLOTS_VER);
-			YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
+		GetCardMgr().SaveSnapshot(yamlSaveHelper);
+	}
 
-			GetCardMgr().SaveSnapshot(yamlSaveHelper);
-		}
+	// Unit: Game I/O Connector
+	if (GetCopyProtectionDongleType() != DT_EMPTY)
+	{
+		yamlSaveHelper.UnitHdr(GetSnapshotUnitGameIOConnectorName(), UNIT_GAME_IO_CONNECTOR_VER);
+		YamlSaveHelper::Label unit(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
 
-		// Unit: Game I/O Connector
-		if (GetCopyProtectionDongleType() != DT_EMPTY)
-		{
-			yamlSaveHelper.UnitHdr(GetSnapshotUnitGameIOConnectorName(), UNIT_GAME_IO_CONNECTOR_VER);
-			YamlSaveHelper::Label unit(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
+		CopyProtectionDongleSaveSnapshot(yamlSaveHelper);
+	}
 
-			CopyProtectionDongleSaveSnapshot(yamlSaveHelper);
-		}
+	// Miscellaneous
+	if (MemHasNoSlotClock())
+	{
+		yamlSaveHelper.UnitHdr(GetSnapshotUnitMiscName(), UNIT_MISC_VER);
+		YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
 
-		// Miscellaneous
-		if (MemHasNoSlotClock())
-		{
-			yamlSaveHelper.UnitHdr(GetSnapshotUnitMiscName(), UNIT_MISC_VER);
-			YamlSaveHelper::Label state(yamlSaveHelper, "%s:\n", SS_YAML_KEY_STATE);
+		NoSlotClockSaveSnapshot(yamlSaveHelper);
+	}
+}
 
-			NoSlotClockSaveSnapshot(yamlSaveHelper);
-		}
+void Snapshot_SaveState(void)
+{
+	LogFileOutput("Saving Save-State to %s\n", g_strSaveStatePathname.c_str());
+	try
+	{
+		YamlSaveHelper yamlSaveHelper(g_strSaveStatePathname, IsBinarySaveStatePathname(g_strSaveStatePathname));	// *.aws.bin: binary container, else YAML
+		SaveState(yamlSaveHelper);
 
 #if USE_RETROACHIEVEMENTS
         RA_OnSaveState(g_strSaveStatePathname.c_str());
@@ -561,6 +601,139 @@ void Snapshot_SaveState(void)
 
 //-----------------------------------------------------------------------------
 
+// In-memory save-state, eg. for rewind
+// . pPrevBuffer (optional): a previous snapshot, to share unchanged memory pages with (must be a different buffer)
+bool Snapshot_SaveStateToMemory(SaveStateBuffer& buffer, const SaveStateBuffer* pPrevBuffer/*=NULL*/)
+{
+	_ASSERT(pPrevBuffer != &buffer);
+	if (pPrevBuffer == &buffer)
+		pPrevBuffer = NULL;
+
+	try
+	{
+		YamlSaveHelper yamlSaveHelper(buffer, pPrevBuffer);
+		SaveState(yamlSaveHelper);
+	}
+	catch(const std::exception & szMessage)
+	{
+		LogFileOutput("Save-State to memory failed: %s\n", szMessage.what());
+		buffer.Clear();
+		return false;
+	}
+
+	return true;
+}
+
+// NB. Unlike Snapshot_LoadState(), this doesn't update the Registry, the debugger or the frame (eg. redraw the screen)
+// . and the Disk II & HDD cards are restored in place: an image that's still in the same drive isn't ejected & re-inserted
+bool Snapshot_LoadStateFromMemory(const SaveStateBuffer& buffer)
+{
+	bool restart = false;	// Only need to restart if any VM state has change
+	bool res = true;
+
+	try
+	{
+		if (!yamlHelper.InitParser(buffer))
+			throw std::runtime_error("Failed to initialize parser");
+
+		if (yamlHelper.ParseFileHdr(SS_YAML_VALUE_AWSS) != SS_FILE_VER)
+			throw std::runtime_error("Version mismatch");
+
+		restart = true;
+
+		LoadState(true);
+
+		MemInitializeFromSnapshot();
+	}
+	catch(const std::exception & szMessage)
+	{
+		LogFileOutput("Load-State from memory failed: %s\n", szMessage.what());
+		res = false;
+
+		if (restart)
+			GetFrame().Restart();		// Power-cycle VM (undoing all the new state just loaded)
+	}
+
+	yamlHelper.FinaliseParser();
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+
+// Rewind: a ring of in-memory save-states, one taken every g_rewindFramesPerSnapshot video frames
+// . Each snapshot shares its unchanged memory pages with the previous one
+
+static std::vector<SaveStateBuffer> g_rewindRing;
+static UINT g_rewindHead = 0;					// Slot for the next snapshot
+static UINT g_rewindCount = 0;					// Number of valid snapshots
+static UINT g_rewindFramesPerSnapshot = 1;
+static UINT g_rewindFrames = 0;
+
+// numSnapshots == 0 disables rewind
+void Snapshot_SetRewind(const UINT numSnapshots, const UINT framesPerSnapshot)
+{
+	g_rewindRing.clear();
+	g_rewindRing.resize(numSnapshots);
+	g_rewindHead = 0;
+	g_rewindCount = 0;
+	g_rewindFramesPerSnapshot = framesPerSnapshot ? framesPerSnapshot : 1;
+	g_rewindFrames = 0;
+}
+
+bool Snapshot_IsRewindEnabled(void)
+{
+	return !g_rewindRing.empty();
+}
+
+// Called once per video frame when running
+void Snapshot_RewindUpdate(void)
+{
+	if (g_rewindRing.empty())
+		return;
+
+	if (++g_rewindFrames < g_rewindFramesPerSnapshot)
+		return;
+
+	g_rewindFrames = 0;
+
+	const UINT numSlots = g_rewindRing.size();
+	const SaveStateBuffer* pPrevBuffer = (g_rewindCount && numSlots > 1) ? &g_rewindRing[(g_rewindHead + numSlots - 1) % numSlots]
+																			 : NULL;
+
+	if (!Snapshot_SaveStateToMemory(g_rewindRing[g_rewindHead], pPrevBuffer))
+		return;
+
+	g_rewindHead = (g_rewindHead + 1) % numSlots;
+	if (g_rewindCount < numSlots)
+		g_rewindCount++;
+}
+
+// Restore the most recent snapshot, and drop it from the ring (so that repeated rewinds go further back)
+bool Snapshot_Rewind(void)
+{
+	if (g_rewindCount == 0)
+		return false;
+
+	const UINT numSlots = g_rewindRing.size();
+	g_rewindHead = (g_rewindHead + numSlots - 1) % numSlots;
+	g_rewindCount--;
+	g_rewindFrames = 0;
+
+	const eApple2Type prevApple2Type = GetApple2Type();
+
+	if (!Snapshot_LoadStateFromMemory(g_rewindRing[g_rewindHead]))
+		return false;
+
+	if (GetApple2Type() != prevApple2Type)
+		GetFrame().FrameUpdateApple2Type();	// NB. Calls VideoRedrawScreen()
+	else
+		GetFrame().VideoRedrawScreen();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
 void Snapshot_Startup()
 {
 	static bool bDone = false;
@@ -1,5 +1,7 @@
 #pragma once
 
+class SaveStateBuffer;
+
 extern bool g_bSaveStateOnExit;
 
 void Snapshot_SetFilename(const std::string& filename, const std::string& path="");
@@ -10,6 +12,12 @@ void Snapshot_GetDefaultFilenameAndPath(std::string& defaultFilename, std::strin
 void Snapshot_UpdatePath(void);
 void Snapshot_LoadState();
 void Snapshot_SaveState();
+bool Snapshot_SaveStateToMemory(SaveStateBuffer& buffer, const SaveStateBuffer* pPrevBuffer=NULL);
+bool Snapshot_LoadStateFromMemory(const SaveStateBuffer& buffer);
+void Snapshot_SetRewind(const UINT numSnapshots, const UINT framesPerSnapshot);
+bool Snapshot_IsRewindEnabled(void);
+void Snapshot_RewindUpdate(void);
+bool Snapshot_Rewind(void);
 void Snapshot_Startup();
 void Snapshot_Shutdown();
 
@@ -0,0 +1,319 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2022, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Per-source audio capture to WAV files, written by a background thread
+ *
+ * Author: Various
+ *
+ * Producers (on the emulation thread) only copy frames into each stream's lock-free ring buffer.
+ * The writer thread wakes every kWriterPeriodMs (or sooner, if a ring buffer gets half full) and
+ * drains every stream to its file - so file I/O doesn't stall the emulation.
+ * If a ring buffer fills up (ie. the writer is seconds behind), then by default the producer drops the frames it can't write
+ * (and the count is logged). With -wav-lossless the producer waits for the writer instead, so no frames are lost, but the
+ * emulation can stall.
+ */
+
+#include "StdAfx.h"
+
+#include "SoundCapture.h"
+#include "Common.h"
+#include "Log.h"
+
+SoundCapture& GetSoundCapture(void)
+{
+	static SoundCapture sg_soundCapture;
+	return sg_soundCapture;
+}
+
+//=============================================================================
+
+bool SoundCaptureStream::Open(const std::string& name, const std::string& pathname, UINT sampleRate, UINT numChannels, HANDLE hWriterEvent, HANDLE hDrainedEvent, bool lossless)
+{
+	if (!m_riff.Open(pathname.c_str(), sampleRate, numChannels))
+		return false;
+
+	m_name = name;
+	m_ringBuffer.Init(kBufferFrames, numChannels);
+	m_hWriterEvent = hWriterEvent;
+	m_hDrainedEvent = hDrainedEvent;
+	m_lossless = lossless;
+	m_numWriterWaits = 0;
+	m_numDroppedFrames = 0;
+	return true;
+}
+
+void SoundCaptureStream::Close(void)
+{
+	if (m_numWriterWaits)
+		LogFileOutput("SoundCapture: %s: waited %u times for the writer thread\n", m_name.c_str(), m_numWriterWaits);
+	if (m_numDroppedFrames)
+		LogFileOutput("SoundCapture: %s: dropped %u frames (ring buffer full)\n", m_name.c_str(), m_numDroppedFrames);
+
+	m_riff.Close();
+}
+
+void SoundCaptureStream::Write(const short* pData, UINT numFrames)
+{
+	while (1)
+	{
+		const UINT numWritten = m_ringBuffer.Write(pData, numFrames);
+		pData += numWritten * GetNumChannels();
+		numFrames -= numWritten;
+		if (!numFrames)
+			break;
+
+		if (!m_lossless)
+		{
+			m_numDroppedFrames += numFrames;
+			break;
+		}
+
+		WaitForWriter();
+	}
+
+	WakeWriter();
+}
+
+void SoundCaptureStream::WriteSilence(UINT numFrames)
+{
+	while (1)
+	{
+		numFrames -= m_ringBuffer.WriteSilence(numFrames);
+		if (!numFrames)
+			break;
+
+		if (!m_lossless)
+		{
+			m_numDroppedFrames += numFrames;
+			break;
+		}
+
+		WaitForWriter();
+	}
+
+	WakeWriter();
+}
+
+// Lossless: the ring buffer is full, so wake the writer thread and wait for it to drain
+// . NB. timeout, as a drain may have completed (& signalled) just before the ring buffer filled up
+void SoundCaptureStream::WaitForWriter(void)
+{
+	m_numWriterWaits++;
+	SetEvent(m_hWriterEvent);
+	WaitForSingleObject(m_hDrainedEvent, SoundCapture::kWriterPeriodMs);
+}
+
+// Don't wait for the writer's next period if the ring buffer is filling up (eg. at full-speed)
+void SoundCaptureStream::WakeWriter(void)
+{
+	if (m_ringBuffer.GetNumFrames() >= kBufferFrames / 2)
+		SetEvent(m_hWriterEvent);
+}
+
+void SoundCaptureStream::Drain(std::vector<short>& buffer)
+{
+	const UINT bufferFrames = buffer.size() / m_riff.GetNumChannels();
+
+	while (1)
+	{
+		const UINT numFrames = m_ringBuffer.Peek(&buffer[0], bufferFrames);
+		if (!numFrames)
+			break;
+
+		m_riff.PutSamples(&buffer[0], numFrames);
+		m_ringBuffer.Skip(numFrames);
+	}
+}
+
+//=============================================================================
+
+SoundCapture::SoundCapture(void)
+	: m_enabled(false)
+	, m_lossless(false)
+	, m_quit(false)
+	, m_hThread(NULL)
+	, m_hWriterEvent(NULL)
+	, m_hDrainedEvent(NULL)
+{
+	InitializeCriticalSection(&m_criticalSection);
+}
+
+// Called before any source produces (ie. from the cmd line)
+void SoundCapture::SetFile(const std::string& name, const std::string& pathname)
+{
+	m_files[name] = pathname;
+	m_enabled = true;
+}
+
+void SoundCapture::SetDirectory(const std::string& dir)
+{
+	m_directory = dir;
+	if (!m_directory.empty() && m_directory[m_directory.size() - 1] != PATH_SEPARATOR)
+		m_directory += PATH_SEPARATOR;
+
+	m_enabled = true;
+}
+
+SoundCaptureStream* SoundCapture::GetStream(const std::string& name, UINT sampleRate, UINT numChannels)
+{
+	if (!m_enabled)
+		return NULL;
+
+	std::map<std::string, SoundCaptureStream*>::iterator it = m_streamMap.find(name);
+	if (it != m_streamMap.end())
+	{
+		_ASSERT(!it->second || it->second->GetNumChannels() == numChannels);
+		return it->second;
+	}
+
+	// First write to this stream, so try to open it (only once: a failure is also remembered)
+	m_streamMap[name] = NULL;
+
+	std::string pathname;
+	std::map<std::string, std::string>::iterator itFile = m_files.find(name);
+	if (itFile != m_files.end())
+		pathname = itFile->second;
+	else if (IsCapturingAll())
+		pathname = m_directory + name + ".wav";
+	else
+		return NULL;
+
+	if (!StartWriterThread())
+		return NULL;
+
+	SoundCaptureStream* pStream = new SoundCaptureStream;
+	if (!pStream->Open(name, pathname, sampleRate, numChannels, m_hWriterEvent, m_hDrainedEvent, m_lossless))
+	{
+		LogFileOutput("SoundCapture: failed to open: %s\n", pathname.c_str());
+		delete pStream;
+		return NULL;
+	}
+
+	LogFileOutput("SoundCapture: %s -> %s (%u Hz, %u ch)\n", name.c_str(), pathname.c_str(), sampleRate, numChannels);
+
+	EnterCriticalSection(&m_criticalSection);
+	m_streams.push_back(pStream);
+	LeaveCriticalSection(&m_criticalSection);
+
+	m_streamMap[name] = pStream;
+	return pStream;
+}
+
+bool SoundCapture::StartWriterThread(void)
+{
+	if (m_hThread)
+		return true;
+
+	m_writerBuffer.resize(SoundMixer::BUFFER_FRAMES * SoundMixer::NUM_CHANNELS);
+
+	m_hWriterEvent = CreateEvent(NULL,		// lpEventAttributes
+								FALSE,		// bManualReset (FALSE = auto-reset)
+								FALSE,		// bInitialState (FALSE = non-signaled)
+								NULL);		// lpName
+	m_hDrainedEvent = CreateEvent(NULL, FALSE, FALSE, NULL);	// auto-reset
+	if (!m_hWriterEvent || !m_hDrainedEvent)
+	{
+		if (m_hWriterEvent)
+			CloseHandle(m_hWriterEvent);
+		if (m_hDrainedEvent)
+			CloseHandle(m_hDrainedEvent);
+		m_hWriterEvent = m_hDrainedEvent = NULL;
+		return false;
+	}
+
+	DWORD dwThreadId;
+	m_hThread = CreateThread(NULL,			// lpThreadAttributes
+							0,				// dwStackSize
+							&SoundCapture::WriterThread,
+							this,			// lpParameter
+							0,				// dwCreationFlags : 0 = Run immediately
+							&dwThreadId);	// lpThreadId
+	if (!m_hThread)
+	{
+		LogFileOutput("SoundCapture: failed to create writer thread\n");
+		CloseHandle(m_hWriterEvent);
+		CloseHandle(m_hDrainedEvent);
+		m_hWriterEvent = m_hDrainedEvent = NULL;
+		m_enabled = false;
+		return false;
+	}
+
+	return true;
+}
+
+DWORD WINAPI SoundCapture::WriterThread(LPVOID lpParameter)
+{
+	SoundCapture* pCapture = (SoundCapture*) lpParameter;
+
+	while (1)
+	{
+		WaitForSingleObject(pCapture->m_hWriterEvent, kWriterPeriodMs);
+
+		// NB. Streams are only ever added (until Shutdown()), so it's safe to drain a copy of the list outside the lock
+		EnterCriticalSection(&pCapture->m_criticalSection);
+		std::vector<SoundCaptureStream*> streams = pCapture->m_streams;
+		const bool bQuit = pCapture->m_quit;
+		LeaveCriticalSection(&pCapture->m_criticalSection);
+
+		for (UINT i = 0; i < streams.size(); i++)
+			streams[i]->Drain(pCapture->m_writerBuffer);
+
+		SetEvent(pCapture->m_hDrainedEvent);	// Unblock any producer waiting for room
+
+		if (bQuit)	// NB. Only quit after a final drain
+			return 0;
+	}
+}
+
+// Called on exit (after the emulation has stopped producing)
+void SoundCapture::Shutdown(void)
+{
+	if (m_hThread)
+	{
+		EnterCriticalSection(&m_criticalSection);
+		m_quit = true;
+		LeaveCriticalSection(&m_criticalSection);
+
+		SetEvent(m_hWriterEvent);
+		WaitForSingleObject(m_hThread, INFINITE);
+
+		CloseHandle(m_hThread);
+		m_hThread = NULL;
+		CloseHandle(m_hWriterEvent);
+		m_hWriterEvent = NULL;
+		CloseHandle(m_hDrainedEvent);
+		m_hDrainedEvent = NULL;
+		m_quit = false;
+	}
+
+	for (UINT i = 0; i < m_streams.size(); i++)
+	{
+		m_streams[i]->Close();
+		delete m_streams[i];
+	}
+
+	m_streams.clear();
+	m_streamMap.clear();
+	m_directory.clear();	// NB. producers may have cached their streams (eg. the Mockingboard's AY voices), so stop all capture
+	m_enabled = false;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Riff.h"
+#include "SoundMixer.h"
+
+// A single captured stream (eg. the speaker, one AY voice or one SSI263), written to its own WAV file
+// . Write() is called from the emulation thread, and just copies into a large ring buffer
+// . the ring buffer is drained to the file by SoundCapture's writer thread
+// . if the ring buffer is full, then Write() drops the frames (so the emulation never stalls),
+//   or in lossless mode (-wav-lossless) it waits for the writer thread to drain it
+class SoundCaptureStream
+{
+public:
+	SoundCaptureStream(void)
+	{
+		m_hWriterEvent = NULL;
+		m_hDrainedEvent = NULL;
+		m_lossless = false;
+		m_numWriterWaits = 0;
+		m_numDroppedFrames = 0;
+	}
+	~SoundCaptureStream(void) {}
+
+	bool Open(const std::string& name, const std::string& pathname, UINT sampleRate, UINT numChannels, HANDLE hWriterEvent, HANDLE hDrainedEvent, bool lossless);
+	void Close(void);
+	const std::string& GetName(void) { return m_name; }
+	UINT GetNumChannels(void) { return m_riff.GetNumChannels(); }
+
+	// Emulation thread:
+	void Write(const short* pData, UINT numFrames);
+	void WriteSilence(UINT numFrames);
+
+private:
+	friend class SoundCapture;
+
+	static const UINT kBufferFrames = 1 << 18;	// ~6 secs at 44.1KHz, so the writer thread can fall behind (eg. on a slow disk) before frames are dropped (or, if lossless, the emulation waits)
+
+	void WakeWriter(void);
+	void WaitForWriter(void);
+	void Drain(std::vector<short>& buffer);	// Writer thread
+
+	std::string m_name;
+	RiffWriter m_riff;
+	SoundRingBuffer m_ringBuffer;
+	HANDLE m_hWriterEvent;
+	HANDLE m_hDrainedEvent;
+	bool m_lossless;
+	UINT m_numWriterWaits;		// Times Write() had to wait because the ring buffer was full (lossless only)
+	UINT m_numDroppedFrames;	// Frames Write() dropped because the ring buffer was full (not lossless)
+};
+
+//-------------------------------------
+
+// Per-source (& per-voice) audio capture, for offline analysis (eg. to diff per-voice dumps across builds)
+// . each stream is identified by name, eg. "Spkr", "MB", "Slot4-AY0-A", "Slot4-SSI263-0"
+// . a stream is only opened when its producer first writes to it, so only sources that actually play create a file
+// . all files are written by a single background thread
+class SoundCapture
+{
+public:
+	SoundCapture(void);
+	~SoundCapture(void) {}
+
+	void SetFile(const std::string& name, const std::string& pathname);	// Capture this stream to this file (eg. -wav-speaker)
+	void SetDirectory(const std::string& dir);								// Capture all streams to "<dir>\<name>.wav" (-wav-capture)
+	void SetLossless(bool lossless) { m_lossless = lossless; }				// Wait for the writer, rather than drop frames (-wav-lossless)
+	bool IsEnabled(void) { return m_enabled; }
+	bool IsCapturingAll(void) { return !m_directory.empty(); }
+
+	// Emulation thread: returns NULL if this stream isn't being captured
+	SoundCaptureStream* GetStream(const std::string& name, UINT sampleRate, UINT numChannels);
+
+	void Shutdown(void);	// Flush & close all files
+
+	static const UINT kWriterPeriodMs = 100;
+
+private:
+	static DWORD WINAPI WriterThread(LPVOID lpParameter);
+	bool StartWriterThread(void);
+
+	bool m_enabled;
+	bool m_lossless;
+	bool m_quit;
+	std::string m_directory;
+	std::map<std::string, std::string> m_files;					// Stream name -> pathname (for explicitly named files)
+	std::map<std::string, SoundCaptureStream*> m_streamMap;		// Emulation thread only (NULL if the file couldn't be opened)
+	std::vector<SoundCaptureStream*> m_streams;					// Shared with the writer thread
+	std::vector<short> m_writerBuffer;							// Writer thread only
+
+	HANDLE m_hThread;
+	HANDLE m_hWriterEvent;
+	HANDLE m_hDrainedEvent;		// Set by the writer thread after each drain
+	CRITICAL_SECTION m_criticalSection;	// To guard /m_streams/ & /m_quit/
+};
+
+SoundCapture& GetSoundCapture(void);
@@ -32,7 +32,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Core.h"
 #include "Interface.h"
 #include "Log.h"
-#include "Speaker.h"
 
 //-----------------------------------------------------------------------------
 
@@ -48,19 +47,17 @@ static LPDIRECTSOUND g_lpDS = NULL;
 
 // Used for muting & fading:
 
-static const UINT uMAX_VOICES = NUM_SLOTS * 2 + 1 + 1;	// 8x (2x SSI263) + spkr + MockingboardCardManager
+static const UINT uMAX_VOICES = 1;	// SoundMixer's output (all sound sources are mixed into this)
 static UINT g_uNumVoices = 0;
 static VOICE* g_pVoices[uMAX_VOICES] = {NULL};
 
-static VOICE* g_pSpeakerVoice = NULL;
-
 //-------------------------------------
 
 bool g_bDSAvailable = false;
 
 //-----------------------------------------------------------------------------
 
-// NB. Also similar is done by: MockingboardCardManager::Destroy()
+// NB. Also similar is done by: SoundOutputDirectSound::Close()
 // - which is called from WM_DESTROY (when both restarting VM & exiting the app)
 
 VOICE::~VOICE(void)
@@ -216,17 +213,11 @@ HRESULT DSGetSoundBuffer(VOICE* pVoice, DWORD dwFlags, DWORD dwBufferSize, DWORD
 	if(g_uNumVoices < uMAX_VOICES)
 		g_pVoices[g_uNumVoices++] = pVoice;
 
-	if(pVoice->bIsSpeaker)
-		g_pSpeakerVoice = pVoice;
-
 	return hr;
 }
 
 void DSReleaseSoundBuffer(VOICE* pVoice)
 {
-	if(pVoice->bIsSpeaker)
-		g_pSpeakerVoice = NULL;
-
 	for(UINT i=0; i<g_uNumVoices; i++)
 	{
 		if(g_pVoices[i] == pVoice)
@@ -338,163 +329,28 @@ bool DSZeroVoiceWritableBuffer(PVOICE Voice, DWORD dwBufferSize)
 
 //-----------------------------------------------------------------------------
 
-static bool g_bTimerActive = false;
-static eFADE g_FadeType = FADE_NONE;
-static UINT_PTR g_nTimerID = 0;
-
-//-------------------------------------
-
-static VOID CALLBACK SoundCore_TimerFunc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime);
-
-static bool SoundCore_StartTimer()
-{
-	if(g_bTimerActive)
-		return true;
-
-	g_nTimerID = SetTimer(NULL, 0, 1, SoundCore_TimerFunc);	// 1ms interval
-	if(g_nTimerID == 0)
-	{
-		fprintf(stderr, "Error creating timer\n");
-		_ASSERT(0);
-		return false;
-	}
-
-	g_bTimerActive = true;
-	return true;
-}
-
-static void SoundCore_StopTimer()
-{
-	if(!g_bTimerActive)
-		return;
-
-	if(KillTimer(NULL, g_nTimerID) == FALSE)
-	{
-		fprintf(stderr, "Error killing timer\n");
-		_ASSERT(0);
-		return;
-	}
-
-	g_bTimerActive = false;
-}
-
-bool SoundCore_GetTimerState()
-{
-	return g_bTimerActive;
-}
-
-//-------------------------------------
-
-// [OLD: Used to fade volume in/out]
-// FADE_OUT : Just keep filling speaker soundbuffer with same value
-// FADE_IN  : Switch to FADE_NONE & StopTimer()
-
-static VOID CALLBACK SoundCore_TimerFunc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime)
-{
-	if((g_pSpeakerVoice == NULL) || (g_pSpeakerVoice->bActive == false))
-		g_FadeType = FADE_NONE;
-
-	// Timer expired
-	if(g_FadeType == FADE_NONE)
-	{
-		SoundCore_StopTimer();
-		return;
-	}
-
-	//
-
-#if 1
-	if(g_FadeType == FADE_IN)
-		g_FadeType = FADE_NONE;
-	else
-		SpkrUpdate_Timer();
-#else
-	const LONG nFadeUnit_Fast = (DSBVOLUME_MAX - DSBVOLUME_MIN) / 10;
-	const LONG nFadeUnit_Slow = (DSBVOLUME_MAX - DSBVOLUME_MIN) / 1000;	// Less noisy for 'silence'
-
-	LONG nFadeUnit = g_pSpeakerVoice->bRecentlyActive ? nFadeUnit_Fast : nFadeUnit_Slow;
-	LONG nFadeVolume = g_pSpeakerVoice->nFadeVolume;
-
-	if(g_FadeType == FADE_IN)
-	{
-		if(nFadeVolume == g_pSpeakerVoice->nVolume)
-		{
-			g_FadeType = FADE_NONE;
-			SoundCore_StopTimer();
-			return;
-		}
-
-		nFadeVolume += nFadeUnit;
-
-		if(nFadeVolume > g_pSpeakerVoice->nVolume)
-			nFadeVolume = g_pSpeakerVoice->nVolume;
-	}
-	else // FADE_OUT
-	{
-		if(nFadeVolume == DSBVOLUME_MIN)
-		{
-			g_FadeType = FADE_NONE;
-			SoundCore_StopTimer();
-			return;
-		}
-
-		nFadeVolume -= nFadeUnit;
-
-		if(nFadeVolume < DSBVOLUME_MIN)
-			nFadeVolume = DSBVOLUME_MIN;
-	}
-
-	g_pSpeakerVoice->nFadeVolume = nFadeVolume;
-	g_pSpeakerVoice->lpDSBvoice->SetVolume(nFadeVolume);
-#endif
-}
-
-//-----------------------------------------------------------------------------
-
 void SoundCore_SetFade(eFADE FadeType)
 {
-	static AppMode_e nLastMode = MODE_UNDEFINED;
-
 	if(g_nAppMode == MODE_DEBUG)
 		return;
 
-	// Fade in/out for speaker, the others are unmuted/muted here
-	if(FadeType != FADE_NONE)
+	// NB. The speaker no longer needs fading: since it's mixed with everything else, all voices are just muted/unmuted here
+	if(FadeType == FADE_OUT)
 	{
 		for(UINT i=0; i<g_uNumVoices; i++)
 		{
-			// Note: Kludge for fading speaker if curr/last g_nAppMode is/was MODE_LOGO:
-			// . Bug in DirectSound? SpeakerVoice.lpDSBvoice->SetVolume() doesn't work without this!
-			// . See SoundCore_TweakVolumes() - could be this?
-			if((g_pVoices[i]->bIsSpeaker) && (g_nAppMode != MODE_LOGO) && (nLastMode != MODE_LOGO))
-			{
-				g_pVoices[i]->lpDSBvoice->GetVolume(&g_pVoices[i]->nFadeVolume);
-				g_FadeType = FadeType;
-				SoundCore_StartTimer();
-			}
-			else if(FadeType == FADE_OUT)
-			{
-				g_pVoices[i]->lpDSBvoice->SetVolume(DSBVOLUME_MIN);
-				g_pVoices[i]->bMute = true;
-			}
-			else // FADE_IN
-			{
-				g_pVoices[i]->lpDSBvoice->SetVolume(g_pVoices[i]->nVolume);
-				g_pVoices[i]->bMute = false;
-			}
+			g_pVoices[i]->lpDSBvoice->SetVolume(DSBVOLUME_MIN);
+			g_pVoices[i]->bMute = true;
 		}
 	}
-	else // FadeType == FADE_NONE
+	else if(FadeType == FADE_IN)
 	{
-		if( (g_FadeType != FADE_NONE) &&	// Currently fading-in/out
-			(g_pSpeakerVoice && g_pSpeakerVoice->bActive) )
+		for(UINT i=0; i<g_uNumVoices; i++)
 		{
-			g_FadeType = FADE_NONE;			// TimerFunc will call StopTimer()
-			g_pSpeakerVoice->lpDSBvoice->SetVolume(g_pSpeakerVoice->nVolume);
+			g_pVoices[i]->lpDSBvoice->SetVolume(g_pVoices[i]->nVolume);
+			g_pVoices[i]->bMute = false;
 		}
 	}
-
-	nLastMode = g_nAppMode;
 }
 
 //-----------------------------------------------------------------------------
@@ -604,8 +460,6 @@ void DSUninit()
 
 	SAFE_RELEASE(g_lpDS);
 	g_bDSAvailable = false;
-
-	SoundCore_StopTimer();
 }
 
 //-----------------------------------------------------------------------------
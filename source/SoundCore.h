@@ -13,8 +13,6 @@ struct VOICE
 	LONG nVolume;			// Current volume (as used by DirectSound)
 	LONG nFadeVolume;		// Current fade volume (as used by DirectSound)
 	DWORD dwUserVolume;		// Volume from slider on Property Sheet (0=Max)
-	bool bIsSpeaker;
-	bool bRecentlyActive;	// (Speaker only) false after 0.2s of speaker inactivity
 	std::string name;
 
 	VOICE(void)
@@ -26,8 +24,6 @@ struct VOICE
 		nVolume = 0;
 		nFadeVolume = 0;
 		dwUserVolume = 0;
-		bIsSpeaker = false;
-		bRecentlyActive = false;
 		name = "";
 	}
 
@@ -49,7 +45,6 @@ bool DSZeroVoiceWritableBuffer(PVOICE Voice, DWORD dwBufferSize);
 
 enum eFADE {FADE_NONE, FADE_IN, FADE_OUT};
 void SoundCore_SetFade(eFADE FadeType);
-bool SoundCore_GetTimerState();
 void SoundCore_TweakVolumes();
 
 int SoundCore_GetErrorInc();
@@ -0,0 +1,483 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2022, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Audio mixer - all sound sources are resampled & mixed to a single output
+ *
+ * Author: Various
+ *
+ * Each source (speaker, Mockingboard, SSI263) pushes frames into its own lock-free ring buffer.
+ * Once per execution period, Update() reads the output's position (the only clock), then resamples
+ * and mixes the same number of frames from every source, and writes them to the output in one go.
+ *
+ * Each source's backlog is kept between kSourceMinFrames and kSourceMaxFrames:
+ * . sources that generate on demand (eg. Mockingboard) apply GetNumSamplesError() to the number of frames they produce
+ * . the pacing source (the speaker) can't, so instead its error is fed back to the CPU via g_nCpuCyclesFeedback
+ */
+
+#include "StdAfx.h"
+
+#include "SoundMixer.h"
+#include "Core.h"
+#include "CPU.h"
+#include "Log.h"
+#include "SoundCapture.h"
+#include "SoundOutput.h"
+
+static SoundMixer g_soundMixer;
+
+SoundMixer& GetSoundMixer(void)
+{
+	return g_soundMixer;
+}
+
+//=============================================================================
+
+void SoundRingBuffer::Init(UINT numFrames, UINT numChannels)
+{
+	UINT size = 1;
+	while (size < numFrames)
+		size <<= 1;
+
+	delete [] m_pBuffer;
+	m_pBuffer = new short[size * numChannels];
+	memset(m_pBuffer, 0, size * numChannels * sizeof(short));
+
+	m_numChannels = numChannels;
+	m_sizeMask = size - 1;
+	m_readIdx = 0;
+	m_writeIdx = 0;
+}
+
+UINT SoundRingBuffer::GetNumFrames(void) const
+{
+	return m_writeIdx.load(std::memory_order_acquire) - m_readIdx.load(std::memory_order_acquire);
+}
+
+UINT SoundRingBuffer::Write(const short* pData, UINT numFrames)
+{
+	if (!m_pBuffer)
+		return 0;
+
+	const UINT writeIdx = m_writeIdx.load(std::memory_order_relaxed);
+	const UINT readIdx = m_readIdx.load(std::memory_order_acquire);
+
+	const UINT numFree = (m_sizeMask + 1) - (writeIdx - readIdx);
+	if (numFrames > numFree)
+		numFrames = numFree;
+
+	const UINT pos = writeIdx & m_sizeMask;
+	const UINT numFrames0 = std::min<UINT>(numFrames, m_sizeMask + 1 - pos);
+	memcpy(&m_pBuffer[pos * m_numChannels], pData, numFrames0 * m_numChannels * sizeof(short));
+	memcpy(&m_pBuffer[0], &pData[numFrames0 * m_numChannels], (numFrames - numFrames0) * m_numChannels * sizeof(short));
+
+	m_writeIdx.store(writeIdx + numFrames, std::memory_order_release);
+	return numFrames;
+}
+
+UINT SoundRingBuffer::WriteSilence(UINT numFrames)
+{
+	if (!m_pBuffer)
+		return 0;
+
+	const UINT writeIdx = m_writeIdx.load(std::memory_order_relaxed);
+	const UINT readIdx = m_readIdx.load(std::memory_order_acquire);
+
+	const UINT numFree = (m_sizeMask + 1) - (writeIdx - readIdx);
+	if (numFrames > numFree)
+		numFrames = numFree;
+
+	const UINT pos = writeIdx & m_sizeMask;
+	const UINT numFrames0 = std::min<UINT>(numFrames, m_sizeMask + 1 - pos);
+	memset(&m_pBuffer[pos * m_numChannels], 0, numFrames0 * m_numChannels * sizeof(short));
+	memset(&m_pBuffer[0], 0, (numFrames - numFrames0) * m_numChannels * sizeof(short));
+
+	m_writeIdx.store(writeIdx + numFrames, std::memory_order_release);
+	return numFrames;
+}
+
+UINT SoundRingBuffer::Peek(short* pData, UINT numFrames) const
+{
+	if (!m_pBuffer)
+		return 0;
+
+	const UINT readIdx = m_readIdx.load(std::memory_order_relaxed);
+	const UINT writeIdx = m_writeIdx.load(std::memory_order_acquire);
+
+	if (numFrames > writeIdx - readIdx)
+		numFrames = writeIdx - readIdx;
+
+	const UINT pos = readIdx & m_sizeMask;
+	const UINT numFrames0 = std::min<UINT>(numFrames, m_sizeMask + 1 - pos);
+	memcpy(pData, &m_pBuffer[pos * m_numChannels], numFrames0 * m_numChannels * sizeof(short));
+	memcpy(&pData[numFrames0 * m_numChannels], &m_pBuffer[0], (numFrames - numFrames0) * m_numChannels * sizeof(short));
+
+	return numFrames;
+}
+
+void SoundRingBuffer::Skip(UINT numFrames)
+{
+	const UINT readIdx = m_readIdx.load(std::memory_order_relaxed);
+	const UINT writeIdx = m_writeIdx.load(std::memory_order_acquire);
+
+	if (numFrames > writeIdx - readIdx)
+		numFrames = writeIdx - readIdx;
+
+	m_readIdx.store(readIdx + numFrames, std::memory_order_release);
+}
+
+//=============================================================================
+
+void SoundSource::Init(const char* pszName, UINT sampleRate, UINT numChannels)
+{
+	_ASSERT(sampleRate <= SoundMixer::SAMPLE_RATE);	// Only up-sampling is supported
+	_ASSERT(numChannels == 1 || numChannels == 2);
+
+	m_name = pszName;
+	m_captureName = pszName;
+	m_sampleRate = sampleRate;
+	m_numChannels = numChannels;
+	m_step = (UINT)(((UINT64)sampleRate << 16) / SoundMixer::SAMPLE_RATE);
+
+	m_ringBuffer.Init(SoundMixer::BUFFER_FRAMES, numChannels);
+}
+
+// Called by the device (on the emulation thread)
+void SoundSource::Write(const short* pData, UINT numFrames)
+{
+	SoundCaptureStream* pCapture = GetSoundCapture().GetStream(m_captureName, m_sampleRate, m_numChannels);
+	if (pCapture)
+		pCapture->Write(pData, numFrames);
+
+	m_ringBuffer.Write(pData, numFrames);
+}
+
+void SoundSource::WriteSilence(UINT numFrames)
+{
+	SoundCaptureStream* pCapture = GetSoundCapture().GetStream(m_captureName, m_sampleRate, m_numChannels);
+	if (pCapture)
+		pCapture->WriteSilence(numFrames);
+
+	m_ringBuffer.WriteSilence(numFrames);
+}
+
+void SoundSource::SetVolume(DWORD dwVolume, DWORD dwVolumeMax)
+{
+	m_userVolume = dwVolume;
+
+	// NewVolume() is in DirectSound units (1/100 dB)
+	const LONG nVolume = NewVolume(dwVolume, dwVolumeMax);
+	m_gain = (nVolume <= DSBVOLUME_MIN) ? 0
+		: (int)((double)kUnityGain * pow(10.0, (double)nVolume / 2000.0));
+}
+
+//=============================================================================
+
+bool SoundMixer::Initialize(void)
+{
+	_ASSERT(m_pOutput == NULL);
+
+	SoundCaptureStream* pWavStream = m_wavOutput ? GetSoundCapture().GetStream("Output", SAMPLE_RATE, NUM_CHANNELS) : NULL;
+
+	if (pWavStream)
+		m_pOutput = new SoundOutputWav(*pWavStream);
+	else if (!g_bDisableDirectSound)
+		m_pOutput = new SoundOutputDirectSound;
+
+	if (m_pOutput && !m_pOutput->Open(SAMPLE_RATE, NUM_CHANNELS, BUFFER_FRAMES))
+	{
+		delete m_pOutput;
+		m_pOutput = NULL;
+	}
+
+	const bool res = m_pOutput != NULL;
+	if (!m_pOutput)
+		m_pOutput = new SoundOutputNull;	// Keep mixing (so sources still drain)
+
+	LogFileOutput("SoundMixer: Initialize(), output=%s, res=%d\n", m_pOutput->GetName(), res ? 1 : 0);
+
+	m_outputAvailable = res;
+	m_mixBuffer.resize(BUFFER_FRAMES * NUM_CHANNELS);
+	m_outBuffer.resize(BUFFER_FRAMES * NUM_CHANNELS);
+	m_sourceBuffer.resize((BUFFER_FRAMES + 1) * NUM_CHANNELS);
+
+	m_lastCycle = g_nCumulativeCycles;
+	m_frameRemainder = 0.0;
+
+	return res;
+}
+
+void SoundMixer::Destroy(void)
+{
+	_ASSERT(m_sources.empty());
+
+	if (!m_pOutput)
+		return;
+
+	m_pOutput->Close();
+	delete m_pOutput;
+	m_pOutput = NULL;
+	m_outputAvailable = false;
+}
+
+bool SoundMixer::IsOutputAvailable(void)
+{
+	return m_outputAvailable;
+}
+
+bool SoundMixer::IsOutputRealTime(void)
+{
+	return m_pOutput && m_pOutput->IsRealTime();
+}
+
+//-----------------------------------------------------------------------------
+
+// Called before the mixer's Initialize()
+// . the mix is written as the capture stream "Output" (so by the capture's writer thread, and the file outlives a VM restart)
+void SoundMixer::SetWavOutput(const char* pszFile)
+{
+	GetSoundCapture().SetFile("Output", pszFile);
+	m_wavOutput = true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool SoundMixer::AddSource(SoundSource* pSource)
+{
+	if (!m_pOutput)
+		return false;
+
+	if (pSource->m_active)
+		return true;
+
+	pSource->m_active = true;
+	pSource->m_flush = true;
+	pSource->m_numSamplesError = 0;
+
+	m_sources.push_back(pSource);
+	return true;
+}
+
+void SoundMixer::RemoveSource(SoundSource* pSource)
+{
+	std::vector<SoundSource*>::iterator it = std::find(m_sources.begin(), m_sources.end(), pSource);
+	if (it == m_sources.end())
+		return;
+
+	m_sources.erase(it);
+	pSource->m_active = false;
+}
+
+//-----------------------------------------------------------------------------
+
+// Backlog in output frames
+UINT SoundMixer::GetBacklog(SoundSource& source)
+{
+	return (UINT)((UINT64)source.m_ringBuffer.GetNumFrames() * SAMPLE_RATE / source.m_sampleRate);
+}
+
+UINT SoundMixer::GetNumFramesToMix(void)
+{
+	UINT numFrames = 0;
+
+	if (m_pOutput->IsRealTime())
+	{
+		// Top-up the output to a fixed level
+		const UINT queued = m_pOutput->GetQueuedFrames();
+		numFrames = (queued < kOutputTargetFrames) ? kOutputTargetFrames - queued : 0;
+	}
+	else
+	{
+		// Emulated time is the clock: use the pacing source's backlog, or else the elapsed cycles
+		bool hasPacingSource = false;
+		for (UINT i = 0; i < m_sources.size(); i++)
+		{
+			if (m_sources[i]->m_pacing)
+			{
+				numFrames = GetBacklog(*m_sources[i]);
+				hasPacingSource = true;
+				break;
+			}
+		}
+
+		if (!hasPacingSource)
+		{
+			const double frames = (double)(g_nCumulativeCycles - m_lastCycle) * (double)SAMPLE_RATE / g_fCurrentCLK6502 + m_frameRemainder;
+			numFrames = (UINT)frames;
+			m_frameRemainder = frames - (double)numFrames;
+		}
+	}
+
+	m_lastCycle = g_nCumulativeCycles;
+
+	return std::min<UINT>(numFrames, BUFFER_FRAMES);
+}
+
+void SoundMixer::MixSource(SoundSource& source, UINT numFrames)
+{
+	SoundRingBuffer& ringBuffer = source.m_ringBuffer;
+	const UINT numChannels = source.m_numChannels;
+	const int gain = source.m_mute ? 0 : source.m_gain;	// NB. Muted sources are still consumed
+	int* pMix = &m_mixBuffer[0];
+
+	if (source.m_flush.exchange(false))
+	{
+		ringBuffer.Skip(ringBuffer.GetNumFrames());
+		source.m_priming = true;
+		source.m_phase = 0;
+	}
+
+	if (source.m_priming && GetBacklog(source) >= kSourceMinFrames)
+		source.m_priming = false;
+
+	if (source.m_priming)
+	{
+		// Wait for a cushion of frames: just hold the last frame
+		if (gain && (source.m_lastFrame[0] || source.m_lastFrame[1]))
+		{
+			for (UINT i = 0; i < numFrames; i++)
+			{
+				for (UINT c = 0; c < NUM_CHANNELS; c++)
+					pMix[i * NUM_CHANNELS + c] += (source.m_lastFrame[c % numChannels] * gain) >> 15;
+			}
+		}
+	}
+	else if (numFrames)
+	{
+		const bool unity = source.m_step == (1 << 16);
+		const UINT64 phaseEnd = (UINT64)source.m_phase + (UINT64)numFrames * source.m_step;
+		const UINT numNeeded = unity ? numFrames
+			: (UINT)(((UINT64)source.m_phase + (UINT64)(numFrames - 1) * source.m_step) >> 16) + 1;
+		const UINT numConsumed = unity ? numFrames : (UINT)(phaseEnd >> 16);
+
+		short* pSource = &m_sourceBuffer[0];
+		const UINT numRead = ringBuffer.Peek(pSource, numNeeded);
+		if (numRead < numNeeded)
+		{
+			// Underrun: pad with the last frame, and wait for a cushion again
+			for (UINT i = numRead; i < numNeeded; i++)
+			{
+				for (UINT c = 0; c < numChannels; c++)
+					pSource[i * numChannels + c] = i ? pSource[(i - 1) * numChannels + c] : (short)source.m_lastFrame[c];
+			}
+			source.m_priming = true;
+		}
+
+		// Interpolate across the sequence of frames: [m_lastFrame, pSource[0], pSource[1], ...]
+		#define SOURCE_FRAME(idx, c) ((idx) ? (int)pSource[((idx) - 1) * numChannels + ((c) % numChannels)] : source.m_lastFrame[(c) % numChannels])
+
+		if (!gain)
+		{
+			// Just consume
+		}
+		else if (unity)
+		{
+			for (UINT i = 0; i < numFrames; i++)
+			{
+				for (UINT c = 0; c < NUM_CHANNELS; c++)
+					pMix[i * NUM_CHANNELS + c] += ((int)pSource[i * numChannels + (c % numChannels)] * gain) >> 15;
+			}
+		}
+		else
+		{
+			UINT64 pos = source.m_phase;
+			for (UINT i = 0; i < numFrames; i++, pos += source.m_step)
+			{
+				const UINT idx = (UINT)(pos >> 16);
+				const INT64 frac = (INT64)(pos & 0xFFFF);
+
+				for (UINT c = 0; c < NUM_CHANNELS; c++)
+				{
+					const int s0 = SOURCE_FRAME(idx, c);
+					const int s1 = SOURCE_FRAME(idx + 1, c);
+					const int sample = s0 + (int)(((INT64)(s1 - s0) * frac) >> 16);
+					pMix[i * NUM_CHANNELS + c] += (sample * gain) >> 15;
+				}
+			}
+		}
+
+		for (UINT c = 0; c < numChannels; c++)
+			source.m_lastFrame[c] = unity ? (int)pSource[(numFrames - 1) * numChannels + c] : SOURCE_FRAME(numConsumed, c);
+
+		#undef SOURCE_FRAME
+
+		source.m_phase = unity ? 0 : (UINT)(phaseEnd & 0xFFFF);
+		ringBuffer.Skip(std::min<UINT>(numConsumed, numRead));
+	}
+
+	// Bound the latency, eg. after full-speed or when a source produces in large bursts
+	const UINT backlog = GetBacklog(source);
+	if (backlog > kSourceTrimFrames)
+		ringBuffer.Skip((UINT)((UINT64)(backlog - kSourceMaxFrames) * source.m_sampleRate / SAMPLE_RATE));
+
+	UpdateSourceError(source);
+}
+
+void SoundMixer::UpdateSourceError(SoundSource& source)
+{
+	const UINT backlog = GetBacklog(source);
+
+	// Calc correction factor so that the source's backlog doesn't under/overflow
+	const int nErrorInc = SoundCore_GetErrorInc();
+	if (backlog < kSourceMinFrames)
+		source.m_numSamplesError += nErrorInc;		// need *more* data
+	else if (backlog > kSourceMaxFrames)
+		source.m_numSamplesError -= nErrorInc;		// need *less* data
+	else
+		source.m_numSamplesError = 0;				// Acceptable amount of data in buffer
+
+	const int nErrorMax = SoundCore_GetErrorMax();	// Cap feedback to +/-nMaxError units
+	if (source.m_numSamplesError < -nErrorMax) source.m_numSamplesError = -nErrorMax;
+	if (source.m_numSamplesError >  nErrorMax) source.m_numSamplesError =  nErrorMax;
+
+	if (source.m_pacing && m_pOutput->IsRealTime() && !g_bFullSpeed)
+		g_nCpuCyclesFeedback = (int)((double)source.m_numSamplesError * g_fCurrentCLK6502 / (double)source.m_sampleRate);
+}
+
+//-----------------------------------------------------------------------------
+
+void SoundMixer::Update(void)
+{
+	if (!m_pOutput)
+		return;
+
+	const UINT numFrames = GetNumFramesToMix();
+
+	memset(&m_mixBuffer[0], 0, numFrames * NUM_CHANNELS * sizeof(int));
+
+	for (UINT i = 0; i < m_sources.size(); i++)
+		MixSource(*m_sources[i], numFrames);
+
+	if (!numFrames)
+		return;
+
+	// Cap the superpositioned output
+	const int* pMix = &m_mixBuffer[0];
+	short* pOut = &m_outBuffer[0];
+	for (UINT i = 0; i < numFrames * NUM_CHANNELS; i++)
+	{
+		const int sample = pMix[i];
+		pOut[i] = (sample < -32768) ? -32768 : (sample > 32767) ? 32767 : (short)sample;
+	}
+
+	m_pOutput->Write(pOut, numFrames);
+}
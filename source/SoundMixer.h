@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+
+#include "SoundCore.h"
+
+class SoundOutput;
+
+// Lock-free single-producer/single-consumer ring buffer of 16-bit interleaved frames
+// . producer: the emulated device (Write)
+// . consumer: the mixer (Peek, Skip)
+class SoundRingBuffer
+{
+public:
+	SoundRingBuffer(void)
+	{
+		m_pBuffer = NULL;
+		m_numChannels = 0;
+		m_sizeMask = 0;
+		m_readIdx = 0;
+		m_writeIdx = 0;
+	}
+	~SoundRingBuffer(void) { delete [] m_pBuffer; }
+
+	void Init(UINT numFrames, UINT numChannels);	// numFrames is rounded up to a power of 2
+	UINT GetNumFrames(void) const;					// Number of frames available to read
+	UINT Write(const short* pData, UINT numFrames);	// Returns number of frames written (ie. drops frames if full)
+	UINT WriteSilence(UINT numFrames);				// As Write(), but zero-fills (no source data needed)
+	UINT Peek(short* pData, UINT numFrames) const;	// Read without consuming
+	void Skip(UINT numFrames);
+
+private:
+	short* m_pBuffer;
+	UINT m_numChannels;
+	UINT m_sizeMask;
+	std::atomic<UINT> m_readIdx;	// Free-running frame counts (only the consumer writes m_readIdx, only the producer writes m_writeIdx)
+	std::atomic<UINT> m_writeIdx;
+};
+
+//-------------------------------------
+
+// A sample producer (speaker, Mockingboard, SSI263, ...) feeding the mixer at its own sample rate
+// . owned by the device, which registers it with GetSoundMixer().AddSource() when it starts producing
+class SoundSource
+{
+public:
+	SoundSource(void)
+	{
+		m_sampleRate = 0;
+		m_numChannels = 0;
+		m_userVolume = 0;
+		m_gain = kUnityGain;
+		m_mute = false;
+		m_pacing = false;
+		m_active = false;
+		m_flush = false;
+		m_priming = true;
+		m_numSamplesError = 0;
+		m_phase = 0;
+		m_step = 0;
+		m_lastFrame[0] = m_lastFrame[1] = 0;
+	}
+	~SoundSource(void) {}
+
+	void Init(const char* pszName, UINT sampleRate, UINT numChannels);
+	const std::string& GetName(void) { return m_name; }
+	void SetCaptureName(const std::string& name) { m_captureName = name; }	// Defaults to the name (see SoundCapture)
+	UINT GetSampleRate(void) { return m_sampleRate; }
+	UINT GetNumChannels(void) { return m_numChannels; }
+
+	// Producer:
+	void Write(const short* pData, UINT numFrames);
+	void WriteSilence(UINT numFrames);							// For a producer that knows it's silent, so has skipped generating any samples
+	void Flush(void) { m_flush = true; }						// Discard any buffered frames (done by the mixer)
+	int GetNumSamplesError(void) { return m_numSamplesError; }	// Correction to apply to the number of frames produced per period
+
+	// A pacing source can't vary the number of frames it produces (eg. the speaker's are tied to emulated cycles),
+	// so instead its backlog drives g_nCpuCyclesFeedback
+	void SetPacing(bool pacing) { m_pacing = pacing; }
+
+	bool IsActive(void) { return m_active; }					// ie. registered with the mixer
+	void SetMute(bool mute) { m_mute = mute; }
+	bool IsMute(void) { return m_mute; }
+	void SetVolume(DWORD dwVolume, DWORD dwVolumeMax);
+	DWORD GetVolume(void) { return m_userVolume; }
+
+private:
+	friend class SoundMixer;
+
+	static const int kUnityGain = 1 << 15;
+
+	std::string m_name;
+	std::string m_captureName;
+	UINT m_sampleRate;
+	UINT m_numChannels;
+	SoundRingBuffer m_ringBuffer;
+
+	DWORD m_userVolume;			// GUI's slider volume
+	int m_gain;					// Q15 (from m_userVolume)
+	bool m_mute;
+	bool m_pacing;
+	bool m_active;
+	std::atomic<bool> m_flush;
+	bool m_priming;				// Don't consume until the backlog reaches kSourceMinFrames (initially, or after an underrun)
+	int m_numSamplesError;
+
+	UINT m_phase;				// Resampler: 16.16 position between m_lastFrame and the next buffered frame
+	UINT m_step;				// Resampler: 16.16 source frames per output frame
+	int m_lastFrame[2];
+};
+
+//-------------------------------------
+
+// Mixes all registered SoundSources to a single SoundOutput, once per execution period
+// . the output's clock is the only one: each source's backlog is compared against it (no per-source cursors)
+class SoundMixer
+{
+public:
+	SoundMixer(void)
+	{
+		m_pOutput = NULL;
+		m_outputAvailable = false;
+		m_wavOutput = false;
+		m_lastCycle = 0;
+		m_frameRemainder = 0.0;
+	}
+	~SoundMixer(void) {}
+
+	static const UINT SAMPLE_RATE = 44100;
+	static const UINT NUM_CHANNELS = 2;
+	static const UINT BUFFER_FRAMES = MAX_SAMPLES;
+
+	bool Initialize(void);		// Open the output (needs DSInit() for DirectSound)
+	void Destroy(void);			// Close the output (all sources must have been removed)
+	bool IsOutputAvailable(void);
+	bool IsOutputRealTime(void);
+
+	void SetWavOutput(const char* pszFile);		// Mix to a WAV file instead of a sound device
+
+	bool AddSource(SoundSource* pSource);
+	void RemoveSource(SoundSource* pSource);
+
+	void Update(void);			// Called by ContinueExecution() at the end of every execution period
+
+private:
+	UINT GetNumFramesToMix(void);
+	void MixSource(SoundSource& source, UINT numFrames);
+	void UpdateSourceError(SoundSource& source);
+	UINT GetBacklog(SoundSource& source);
+
+	static const UINT kOutputTargetFrames = BUFFER_FRAMES / 4;	// The output is topped-up to this level
+	static const UINT kSourceMinFrames = BUFFER_FRAMES / 32;	// Each source's backlog is kept between these levels
+	static const UINT kSourceMaxFrames = BUFFER_FRAMES / 8;
+	static const UINT kSourceTrimFrames = BUFFER_FRAMES / 2;	// Discard any backlog above this (eg. after full-speed)
+
+	SoundOutput* m_pOutput;
+	bool m_outputAvailable;		// false if using SoundOutputNull
+	bool m_wavOutput;
+	std::vector<SoundSource*> m_sources;
+
+	std::vector<int> m_mixBuffer;
+	std::vector<short> m_outBuffer;
+	std::vector<short> m_sourceBuffer;
+
+	UINT64 m_lastCycle;			// For non real-time outputs
+	double m_frameRemainder;
+};
+
+SoundMixer& GetSoundMixer(void);
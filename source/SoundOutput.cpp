@@ -0,0 +1,176 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2022, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Sound output backends for the mixer (DirectSound, null & WAV file)
+ *
+ * Author: Various
+ */
+
+#include "StdAfx.h"
+
+#include "SoundOutput.h"
+#include "Log.h"
+#include "SoundCapture.h"
+
+//=============================================================================
+
+bool SoundOutputDirectSound::Open(UINT sampleRate, UINT numChannels, UINT bufferFrames)
+{
+	if (!g_bDSAvailable)
+	{
+		LogFileOutput("SoundOutputDirectSound: g_bDSAvailable=0\n");
+		return false;
+	}
+
+	m_bytesPerFrame = sizeof(short) * numChannels;
+	m_bufferSize = bufferFrames * m_bytesPerFrame;
+	m_byteOffset = (DWORD)-1;
+
+	HRESULT hr = DSGetSoundBuffer(&m_voice, DSBCAPS_CTRLVOLUME, m_bufferSize, sampleRate, numChannels, "Mixer");
+	if (FAILED(hr))
+	{
+		LogFileOutput("SoundOutputDirectSound: DSGetSoundBuffer failed (%08X)\n", hr);
+		return false;
+	}
+
+	if (!DSZeroVoiceBuffer(&m_voice, m_bufferSize))	// ... and Play()
+	{
+		LogFileOutput("SoundOutputDirectSound: DSZeroVoiceBuffer failed\n");
+		DSReleaseSoundBuffer(&m_voice);
+		return false;
+	}
+
+	// Per-source volumes are applied by the mixer, so the output always runs at max volume (except when faded out)
+	m_voice.nVolume = DSBVOLUME_MAX;
+	hr = m_voice.lpDSBvoice->SetVolume(m_voice.nVolume);
+	LogFileOutput("SoundOutputDirectSound: SetVolume(%d) res = %08X\n", m_voice.nVolume, hr);
+
+	//
+
+	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
+	hr = m_voice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
+	if (FAILED(hr))
+		LogFileOutput("SoundOutputDirectSound: GetCurrentPosition failed (%08X)\n", hr);
+	if (SUCCEEDED(hr) && (dwCurrentPlayCursor == dwCurrentWriteCursor))
+	{
+		// KLUDGE: For my WinXP PC with "VIA AC'97 Enhanced Audio Controller"
+		// . Not required for my Win98SE/WinXP PC with PCI "Soundblaster Live!"
+		Sleep(200);
+
+		hr = m_voice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
+		LogFileOutput("SoundOutputDirectSound: GetCurrentPosition kludge (%08X)\n", hr);
+	}
+
+	return true;
+}
+
+void SoundOutputDirectSound::Close(void)
+{
+	if (m_voice.lpDSBvoice && m_voice.bActive)
+		DSVoiceStop(&m_voice);
+
+	if (m_voice.lpDSBvoice)
+		DSReleaseSoundBuffer(&m_voice);
+}
+
+// NB. This is the only place that reads the DirectSound cursors (once per execution period)
+UINT SoundOutputDirectSound::GetQueuedFrames(void)
+{
+	if (!m_voice.bActive)
+		return 0;
+
+	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
+	HRESULT hr = m_voice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
+	if (FAILED(hr))
+		return 0;
+
+	if (m_byteOffset == (DWORD)-1)
+	{
+		// First time in this func
+		m_byteOffset = dwCurrentWriteCursor;
+	}
+	else
+	{
+		// Check that our offset isn't between Play & Write positions (eg. after a pause, or the window was being dragged)
+
+		if (dwCurrentWriteCursor > dwCurrentPlayCursor)
+		{
+			// |-----PxxxxxW-----|
+			if ((m_byteOffset > dwCurrentPlayCursor) && (m_byteOffset < dwCurrentWriteCursor))
+				m_byteOffset = dwCurrentWriteCursor;
+		}
+		else
+		{
+			// |xxW----------Pxxx|
+			if ((m_byteOffset > dwCurrentPlayCursor) || (m_byteOffset < dwCurrentWriteCursor))
+				m_byteOffset = dwCurrentWriteCursor;
+		}
+	}
+
+	int nBytesRemaining = m_byteOffset - dwCurrentPlayCursor;
+	if (nBytesRemaining < 0)
+		nBytesRemaining += m_bufferSize;
+
+	return nBytesRemaining / m_bytesPerFrame;
+}
+
+void SoundOutputDirectSound::Write(const short* pData, UINT numFrames)
+{
+	if (!m_voice.bActive || !numFrames || m_byteOffset == (DWORD)-1)
+		return;
+
+	DWORD dwDSLockedBufferSize0, dwDSLockedBufferSize1;
+	SHORT *pDSLockedBuffer0, *pDSLockedBuffer1;
+
+	HRESULT hr = DSGetLock(m_voice.lpDSBvoice,
+		m_byteOffset, (DWORD)numFrames * m_bytesPerFrame,
+		&pDSLockedBuffer0, &dwDSLockedBufferSize0,
+		&pDSLockedBuffer1, &dwDSLockedBufferSize1);
+	if (FAILED(hr))
+		return;
+
+	memcpy(pDSLockedBuffer0, &pData[0], dwDSLockedBufferSize0);
+	if (pDSLockedBuffer1)
+		memcpy(pDSLockedBuffer1, &pData[dwDSLockedBufferSize0 / sizeof(short)], dwDSLockedBufferSize1);
+
+	// Commit sound buffer
+	hr = m_voice.lpDSBvoice->Unlock((void*)pDSLockedBuffer0, dwDSLockedBufferSize0,
+									(void*)pDSLockedBuffer1, dwDSLockedBufferSize1);
+	if (FAILED(hr))
+		return;
+
+	m_byteOffset = (m_byteOffset + (DWORD)numFrames * m_bytesPerFrame) % m_bufferSize;
+}
+
+//=============================================================================
+
+bool SoundOutputWav::Open(UINT sampleRate, UINT numChannels, UINT bufferFrames)
+{
+	_ASSERT(m_stream.GetNumChannels() == numChannels);
+	return true;
+}
+
+void SoundOutputWav::Write(const short* pData, UINT numFrames)
+{
+	m_stream.Write(pData, numFrames);
+}
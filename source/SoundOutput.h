@@ -0,0 +1,92 @@
+#pragma once
+
+#include "SoundCore.h"
+
+class SoundCaptureStream;
+
+// Output backend for SoundMixer: the final mix (16-bit interleaved PCM) is written here once per execution period.
+// NB. All methods are called from the emulation thread.
+class SoundOutput
+{
+public:
+	SoundOutput(void) {}
+	virtual ~SoundOutput(void) {}
+
+	virtual bool Open(UINT sampleRate, UINT numChannels, UINT bufferFrames) = 0;
+	virtual void Close(void) = 0;
+	virtual const char* GetName(void) = 0;
+
+	// true : consumes samples at the rate of its own clock (ie. a sound device), so it paces the emulation
+	// false: consumes whatever the mixer produces (eg. a file or a null sink), so emulated time is the clock
+	virtual bool IsRealTime(void) = 0;
+
+	// Number of frames written but not yet played (only called if IsRealTime())
+	virtual UINT GetQueuedFrames(void) = 0;
+	virtual void Write(const short* pData, UINT numFrames) = 0;
+};
+
+//-------------------------------------
+
+// Single looping DirectSound buffer
+class SoundOutputDirectSound : public SoundOutput
+{
+public:
+	SoundOutputDirectSound(void)
+	{
+		m_bufferSize = 0;
+		m_bytesPerFrame = 0;
+		m_byteOffset = (DWORD)-1;
+	}
+	virtual ~SoundOutputDirectSound(void) { Close(); }
+
+	virtual bool Open(UINT sampleRate, UINT numChannels, UINT bufferFrames);
+	virtual void Close(void);
+	virtual const char* GetName(void) { return "DirectSound"; }
+	virtual bool IsRealTime(void) { return true; }
+	virtual UINT GetQueuedFrames(void);
+	virtual void Write(const short* pData, UINT numFrames);
+
+private:
+	VOICE m_voice;
+	DWORD m_bufferSize;
+	DWORD m_bytesPerFrame;
+	DWORD m_byteOffset;
+};
+
+//-------------------------------------
+
+// Discards all samples (eg. when no sound device could be opened)
+class SoundOutputNull : public SoundOutput
+{
+public:
+	SoundOutputNull(void) {}
+	virtual ~SoundOutputNull(void) {}
+
+	virtual bool Open(UINT sampleRate, UINT numChannels, UINT bufferFrames) { return true; }
+	virtual void Close(void) {}
+	virtual const char* GetName(void) { return "Null"; }
+	virtual bool IsRealTime(void) { return false; }
+	virtual UINT GetQueuedFrames(void) { return 0; }
+	virtual void Write(const short* pData, UINT numFrames) {}
+};
+
+//-------------------------------------
+
+// Streams the mix to a WAV file instead of a sound device
+// . the stream is owned by SoundCapture, so the file can outlive a VM restart
+class SoundOutputWav : public SoundOutput
+{
+public:
+	SoundOutputWav(SoundCaptureStream& stream) : m_stream(stream) {}
+	virtual ~SoundOutputWav(void) {}
+
+	virtual bool Open(UINT sampleRate, UINT numChannels, UINT bufferFrames);
+	virtual void Close(void) {}
+	virtual const char* GetName(void) { return "WAV"; }
+	virtual bool IsRealTime(void) { return false; }
+	virtual UINT GetQueuedFrames(void) { return 0; }
+	virtual void Write(const short* pData, UINT numFrames);
+
+private:
+	SoundCaptureStream& m_stream;
+};
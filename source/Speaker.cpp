@@ -35,8 +35,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Log.h"
 #include "Memory.h"
 #include "SoundCore.h"
+#include "SoundMixer.h"
 #include "YamlHelper.h"
-#include "Riff.h"
 
 #include "Debugger/Debug.h"	// For DWORD extbench
 
@@ -56,7 +56,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 // NB. Setting g_nSPKR_NumChannels=1 still works (ie. mono).
 // . Retain it for a while in case there are regressions with the new 2-channel code, then remove it.
 static const unsigned short g_nSPKR_NumChannels = 2;
-static const DWORD g_dwDSSpkrBufferSize = MAX_SAMPLES * sizeof(short) * g_nSPKR_NumChannels;
 
 //-------------------------------------
 
@@ -65,44 +64,52 @@ static short*	g_pSpeakerBuffer = NULL;
 // Globals (SOUND_WAVE)
 const short		SPKR_DATA_INIT = (short)0x8000;
 
-short		g_nSpeakerData	= SPKR_DATA_INIT;
+static short	g_nSpeakerData	= SPKR_DATA_INIT;
 static UINT		g_nBufferIdx	= 0;		// Sample index
 
-static short*	g_pRemainderBuffer = NULL;
-static UINT		g_nRemainderBufferSize;		// Setup in SpkrInitialize()
-static UINT		g_nRemainderBufferIdx;		// Setup in SpkrInitialize()
-
 // Application-wide globals:
 SoundType_e		soundtype		= SOUND_WAVE;
-double		    g_fClksPerSpkrSample;		// Setup in SetClksPerSpkrSample()
 
 // Allow temporary quietening of speaker (8 bit DAC)
 bool			g_bQuieterSpeaker = false;
 
 // Globals
 static unsigned __int64	g_nSpkrQuietCycleCount = 0;
-static unsigned __int64 g_nSpkrLastCycle = 0;
+static unsigned __int64 g_nSpkrLastCycle = 0;		// Cycle at the start of the next sample to be rendered
 static bool g_bSpkrToggleFlag = false;
-static VOICE SpeakerVoice;
+static SoundSource g_speakerSource;
 static bool g_bSpkrAvailable = false;
 
+// Band-limited step (BLEP) synthesis:
+// . SpkrToggle() just records a (cycle, level) event
+// . RenderSpkr() (once per execution period) adds a band-limited step for each event, then integrates to get the samples
+static const UINT kBlepTaps = 16;			// Kernel length (in samples), so output is delayed by kBlepTaps/2 samples
+static const int kBlepShift = 14;			// Kernel taps are Q14: each phase sums to exactly 1<<kBlepShift
+static const UINT kMaxSpkrEvents = 4096;	// Plenty for one execution period (a toggle takes at least 4 cycles)
+
+struct SpkrEvent
+{
+	unsigned __int64 cycle;
+	short level;
+};
+
+static SpkrEvent g_spkrEvents[kMaxSpkrEvents];
+static UINT		g_nSpkrNumEvents = 0;
+
+static UINT		g_nClksPerSpkrSample;		// Setup in SetClksPerSpkrSample()
+static int*		g_pBlepKernel = NULL;		// [g_nClksPerSpkrSample][kBlepTaps]: a band-limited impulse for each cycle within a sample
+static int*		g_pBlepBuffer = NULL;		// Deltas (Q14) still to be integrated: [0] is the sample at g_nSpkrLastCycle
+static int		g_nBlepLevel = (int)SPKR_DATA_INIT * (1 << kBlepShift);	// Integrator (Q14)
+static short	g_nBlepLastLevel = SPKR_DATA_INIT;						// Level of the last event added to g_pBlepBuffer
+
 //-----------------------------------------------------------------------------
 
 // Forward refs:
-static ULONG   Spkr_SubmitWaveBuffer_FullSpeed(short* pSpeakerBuffer, ULONG nNumSamples);
-static ULONG   Spkr_SubmitWaveBuffer(short* pSpeakerBuffer, ULONG nNumSamples);
 static void    Spkr_SetActive(bool bActive);
 static void    Spkr_DSUninit();
 
 //-----------------------------------------------------------------------------
 
-static bool g_bSpkrOutputToRiff = false;
-
-void Spkr_OutputToRiff(void)
-{
-	g_bSpkrOutputToRiff = true;
-}
-
 UINT Spkr_GetNumChannels(void)
 {
 	return g_nSPKR_NumChannels;
@@ -134,7 +141,7 @@ static void DisplayBenchmarkResults ()
 //
 // The approach works as follows:
 // - SpkrToggle() is called when the speaker state is flipped by accessing $C030
-// - This brings audio up to date then calls ResetDCFilter()
+// - This records an event, which RenderSpkr() processes by calling ResetDCFilter()
 // - ResetDCFilter() sets a counter to a high value
 // - every audio sample is processed by DCFilter() as follows:
 //   - if the counter is >= 32768, the speaker has been recently toggled
@@ -189,25 +196,65 @@ static void SetClksPerSpkrSample()
 
 	// Use integer value: Better for MJ Mahon's RT.SYNTH.DSK (integer multiples of 1.023MHz Clk)
 	// . 23 clks @ 1.023MHz
-	g_fClksPerSpkrSample = (double) (UINT) (g_fCurrentCLK6502 / (double)SPKR_SAMPLE_RATE);
+	// . also means that cycle to sample conversion is exact integer arithmetic (sample = cycles / clks, phase = cycles % clks)
+	g_nClksPerSpkrSample = (UINT) (g_fCurrentCLK6502 / (double)SPKR_SAMPLE_RATE);
+	if (g_nClksPerSpkrSample == 0)
+		g_nClksPerSpkrSample = 1;	// Slowest speed setting
 }
 
 //=============================================================================
 
-static void InitRemainderBuffer()
+// Build a windowed-sinc kernel for each cycle position (phase) within a sample, so toggles are placed with 1-cycle resolution
+static void InitBlepKernel()
 {
-	delete [] g_pRemainderBuffer;
+	delete [] g_pBlepKernel;
 
 	SetClksPerSpkrSample();
 
-	g_nRemainderBufferSize = (UINT) g_fClksPerSpkrSample;
-	if ((double)g_nRemainderBufferSize < g_fClksPerSpkrSample)
-		g_nRemainderBufferSize++;
+	g_pBlepKernel = new int [g_nClksPerSpkrSample * kBlepTaps];
+
+	const double kPi = 3.14159265358979323846;
+	const double kCutoff = 0.9;		// Fraction of Nyquist (ie. roll-off just below 20KHz)
+
+	for (UINT phase = 0; phase < g_nClksPerSpkrSample; phase++)
+	{
+		const double frac = (double)phase / (double)g_nClksPerSpkrSample;
+
+		double kernel[kBlepTaps];
+		double sum = 0.0;
+		for (UINT k = 0; k < kBlepTaps; k++)
+		{
+			const double x = (double)k - (double)(kBlepTaps / 2 - 1) - frac;	// Impulse is centred on the middle of the kernel
+			const double sinc = (x == 0.0) ? 1.0 : sin(kPi * kCutoff * x) / (kPi * kCutoff * x);
+			const double window = 0.42 + 0.5 * cos(2.0 * kPi * x / kBlepTaps) + 0.08 * cos(4.0 * kPi * x / kBlepTaps);	// Blackman
+			kernel[k] = sinc * window;
+			sum += kernel[k];
+		}
 
-	g_pRemainderBuffer = new short [g_nRemainderBufferSize];
-	memset(g_pRemainderBuffer, 0, g_nRemainderBufferSize);
+		// Normalise so each phase sums to exactly 1<<kBlepShift, so the integrator always settles on the new level (no DC drift)
+		int* pKernel = &g_pBlepKernel[phase * kBlepTaps];
+		int total = 0;
+		UINT peak = 0;
+		for (UINT k = 0; k < kBlepTaps; k++)
+		{
+			pKernel[k] = (int)floor(kernel[k] / sum * (double)(1 << kBlepShift) + 0.5);
+			total += pKernel[k];
+			if (pKernel[k] > pKernel[peak])
+				peak = k;
+		}
+		pKernel[peak] += (1 << kBlepShift) - total;
+	}
+}
 
-	g_nRemainderBufferIdx = 0;
+// Drop any pending events & band-limited residual: the output just steps to the current level
+static void DiscardSpkrEvents()
+{
+	if (g_pBlepBuffer)
+		memset(g_pBlepBuffer, 0, kBlepTaps * sizeof(int));	// NB. Only the residual (ie. 1st kBlepTaps entries) is ever non-zero between renders
+
+	g_nSpkrNumEvents = 0;
+	g_nBlepLastLevel = g_nSpeakerData;
+	g_nBlepLevel = (int)g_nSpeakerData * (1 << kBlepShift);
 }
 
 //
@@ -225,10 +272,12 @@ void SpkrDestroy ()
 	if(soundtype == SOUND_WAVE)
 	{
 		delete [] g_pSpeakerBuffer;
-		delete [] g_pRemainderBuffer;
+		delete [] g_pBlepBuffer;
+		delete [] g_pBlepKernel;
 		
 		g_pSpeakerBuffer = NULL;
-		g_pRemainderBuffer = NULL;
+		g_pBlepBuffer = NULL;
+		g_pBlepKernel = NULL;
 	}
 }
 
@@ -249,8 +298,8 @@ void SpkrInitialize ()
 
 	if(g_bDisableDirectSound)
 	{
-		SpeakerVoice.bMute = true;
-		LogFileOutput("SpkrInitialize: g_bDisableDirectSound=1... SpeakerVoice.bMute=true\n");
+		g_speakerSource.SetMute(true);
+		LogFileOutput("SpkrInitialize: g_bDisableDirectSound=1... speaker muted\n");
 	}
 	else
 	{
@@ -274,9 +323,12 @@ void SpkrInitialize ()
 
 	if (soundtype == SOUND_WAVE)
 	{
-		InitRemainderBuffer();
+		InitBlepKernel();
 
 		g_pSpeakerBuffer = new short [SPKR_SAMPLE_RATE * g_nSPKR_NumChannels];	// Buffer can hold a max of 1 seconds worth of samples
+		g_pBlepBuffer = new int [SPKR_SAMPLE_RATE + kBlepTaps];					// ... plus the residual of a step in the last (partial) sample
+		memset(g_pBlepBuffer, 0, (SPKR_SAMPLE_RATE + kBlepTaps) * sizeof(int));
+		DiscardSpkrEvents();
 	}
 }
 
@@ -287,7 +339,7 @@ void SpkrReinitialize ()
 {
 	if (soundtype == SOUND_WAVE)
 	{
-		InitRemainderBuffer();
+		InitBlepKernel();
 	}
 }
 
@@ -299,8 +351,8 @@ void SpkrReset()
 	g_nSpkrQuietCycleCount = 0;
 	g_bSpkrToggleFlag = false;
 
-	InitRemainderBuffer();
-	Spkr_SubmitWaveBuffer(NULL, 0);
+	DiscardSpkrEvents();
+	g_speakerSource.Flush();
 	Spkr_SetActive(false);
 	Spkr_Unmute();
 }
@@ -318,85 +370,106 @@ void SpkrSetEmulationType (SoundType_e newtype)
 
 //=============================================================================
 
-static void ReinitRemainderBuffer(UINT nCyclesRemaining)
+// Integrate the band-limited deltas to get samples [from, to) of this render
+static void IntegrateSpkr(UINT from, UINT to)
 {
-	if(nCyclesRemaining == 0)
-		return;
-
-	for(g_nRemainderBufferIdx=0; g_nRemainderBufferIdx<nCyclesRemaining; g_nRemainderBufferIdx++)
-		g_pRemainderBuffer[g_nRemainderBufferIdx] = g_nSpeakerData;
+	for (UINT n = from; n < to; n++)
+	{
+		g_nBlepLevel += g_pBlepBuffer[n];
+		g_pBlepBuffer[n] = 0;
 
-	_ASSERT(g_nRemainderBufferIdx < g_nRemainderBufferSize);
-}
+		int level = g_nBlepLevel / (1 << kBlepShift);	// NB. Don't ">>" as -ve number
+		if (level < -32768)			// Clip the step's overshoot
+			level = -32768;
+		else if (level > 32767)
+			level = 32767;
 
-static void UpdateRemainderBuffer(ULONG* pnCycleDiff)
-{
-	if(g_nRemainderBufferIdx)
-	{
-		while((g_nRemainderBufferIdx < g_nRemainderBufferSize) && *pnCycleDiff)
+		const short sample = DCFilter((short)level);
+		if (g_nSPKR_NumChannels == 1)
 		{
-			g_pRemainderBuffer[g_nRemainderBufferIdx] = g_nSpeakerData;
-			g_nRemainderBufferIdx++;
-			(*pnCycleDiff)--;
+			g_pSpeakerBuffer[g_nBufferIdx] = sample;
 		}
-
-		if(g_nRemainderBufferIdx == g_nRemainderBufferSize)
+		else
 		{
-			g_nRemainderBufferIdx = 0;
-			signed long nSampleMean = 0;
-			for(UINT i=0; i<g_nRemainderBufferSize; i++)
-				nSampleMean += (signed long) g_pRemainderBuffer[i];
-			nSampleMean /= (signed long) g_nRemainderBufferSize;
-
-			if (g_nBufferIdx < SPKR_SAMPLE_RATE - 1)
-			{
-				if (g_nSPKR_NumChannels == 1)
-				{
-					g_pSpeakerBuffer[g_nBufferIdx] = DCFilter((short)nSampleMean);
-				}
-				else
-				{
-					const short sample = DCFilter((short)nSampleMean);
-					g_pSpeakerBuffer[g_nBufferIdx * 2 + 0] = sample;
-					g_pSpeakerBuffer[g_nBufferIdx * 2 + 1] = sample;
-				}
-				g_nBufferIdx++;
-			}
+			g_pSpeakerBuffer[g_nBufferIdx * 2 + 0] = sample;
+			g_pSpeakerBuffer[g_nBufferIdx * 2 + 1] = sample;
 		}
+		g_nBufferIdx++;
 	}
 }
 
-static void UpdateSpkr()
+// Add a band-limited step at (sample, phase) of this render
+static void AddSpkrStep(UINT sample, UINT phase, int delta)
 {
-  if(!g_bFullSpeed || SoundCore_GetTimerState())
-  {
-	  ULONG nCycleDiff = (ULONG) (g_nCumulativeCycles - g_nSpkrLastCycle);
+	const int* pKernel = &g_pBlepKernel[phase * kBlepTaps];
+	int* pBuffer = &g_pBlepBuffer[sample];
 
-	  UpdateRemainderBuffer(&nCycleDiff);
+	for (UINT k = 0; k < kBlepTaps; k++)
+		pBuffer[k] += delta * pKernel[k];
+}
 
-	  ULONG nNumSamples = (ULONG) ((double)nCycleDiff / g_fClksPerSpkrSample);
+// Render all complete samples up to the current cycle
+static void RenderSpkr()
+{
+	if (g_bFullSpeed)
+	{
+		// No samples when full-speed (the mixer just holds the last level)
+		DiscardSpkrEvents();
+		g_nSpkrLastCycle = g_nCumulativeCycles;
+		return;
+	}
 
-	  ULONG nCyclesRemaining = (ULONG) ((double)nCycleDiff - (double)nNumSamples * g_fClksPerSpkrSample);
+	const UINT clks = g_nClksPerSpkrSample;
+	const unsigned __int64 numSamples = (g_nCumulativeCycles - g_nSpkrLastCycle) / clks;
 
-	  while ((nNumSamples--) && (g_nBufferIdx < SPKR_SAMPLE_RATE - 1))
-	  {
-		  if (g_nSPKR_NumChannels == 1)
-		  {
-			  g_pSpeakerBuffer[g_nBufferIdx] = DCFilter(g_nSpeakerData);
-		  }
-		  else
-		  {
-			  const short sample = DCFilter(g_nSpeakerData);
-			  g_pSpeakerBuffer[g_nBufferIdx * 2 + 0] = sample;
-			  g_pSpeakerBuffer[g_nBufferIdx * 2 + 1] = sample;
-		  }
-		  g_nBufferIdx++;
-	  }
+	if (numSamples > SPKR_SAMPLE_RATE - g_nBufferIdx)
+	{
+		// Too long since the last render (the speaker buffer holds a max of 1 second)
+		DiscardSpkrEvents();
+		g_nSpkrLastCycle = g_nCumulativeCycles;
+		return;
+	}
 
-	  ReinitRemainderBuffer(nCyclesRemaining);	// Partially fill 1Mhz sample buffer
-  }
+	UINT sample = 0;
+	for (UINT i = 0; i < g_nSpkrNumEvents; i++)
+	{
+		const SpkrEvent& event = g_spkrEvents[i];
+		_ASSERT(event.cycle >= g_nSpkrLastCycle);
+		const UINT offset = (UINT)(event.cycle - g_nSpkrLastCycle);
 
-  g_nSpkrLastCycle = g_nCumulativeCycles;
+		// Samples before this event are now final
+		IntegrateSpkr(sample, offset / clks);
+		sample = offset / clks;		// NB. <= numSamples (ie. may be in the partial sample at the end)
+
+		if (event.level != g_nBlepLastLevel)
+			AddSpkrStep(sample, offset % clks, (int)event.level - (int)g_nBlepLastLevel);
+
+		g_nBlepLastLevel = event.level;
+		ResetDCFilter();
+	}
+
+	IntegrateSpkr(sample, (UINT)numSamples);
+	g_nSpkrNumEvents = 0;
+
+	// Move the residual (the tails of the most recent steps) to the start for the next render
+	for (UINT k = 0; k < kBlepTaps; k++)
+	{
+		const int delta = g_pBlepBuffer[numSamples + k];
+		g_pBlepBuffer[numSamples + k] = 0;
+		g_pBlepBuffer[k] = delta;
+	}
+
+	g_nSpkrLastCycle += numSamples * clks;	// NB. The cycles of a partial sample are carried to the next render
+}
+
+static void AddSpkrEvent()
+{
+	if (g_nSpkrNumEvents == kMaxSpkrEvents)
+		RenderSpkr();	// eg. a long execution period: render early to free up the event list
+
+	g_spkrEvents[g_nSpkrNumEvents].cycle = g_nCumulativeCycles;
+	g_spkrEvents[g_nSpkrNumEvents].level = g_nSpeakerData;
+	g_nSpkrNumEvents++;
 }
 
 //=============================================================================
@@ -424,20 +497,18 @@ BYTE __stdcall SpkrToggle (WORD, WORD, BYTE, BYTE, ULONG nExecutedCycles)
   {
 	  CpuCalcCycles(nExecutedCycles);
 
-	  UpdateSpkr();
-
       short speakerDriveLevel = SPKR_DATA_INIT;
       if (g_bQuieterSpeaker)	// quieten the speaker if 8 bit DAC in use
         speakerDriveLevel /= 4;	// NB. Don't shift -ve number right: undefined behaviour (MSDN says: implementation-dependent)
 
-      // When full-speed: Don't ResetDCFilter(), otherwise get occasional clicks when speaker toggled
-      if (!g_bFullSpeed)
-        ResetDCFilter();
-
       if (g_nSpeakerData == speakerDriveLevel)
         g_nSpeakerData = ~speakerDriveLevel;
       else
         g_nSpeakerData = speakerDriveLevel;
+
+      // When full-speed: Don't add an event (so no ResetDCFilter()), otherwise get occasional clicks when speaker toggled
+      if (!g_bFullSpeed)
+        AddSpkrEvent();
   }
 
   return MemReadFloatingBus(nExecutedCycles);
@@ -476,399 +547,21 @@ void SpkrUpdate (DWORD totalcycles)
 
   if (soundtype == SOUND_WAVE)
   {
-	  UpdateSpkr();
-	  ULONG nSamplesUsed;
-
-	  if(g_bFullSpeed)
-		  nSamplesUsed = Spkr_SubmitWaveBuffer_FullSpeed(g_pSpeakerBuffer, g_nBufferIdx);
-	  else
-		  nSamplesUsed = Spkr_SubmitWaveBuffer(g_pSpeakerBuffer, g_nBufferIdx);
+	  RenderSpkr();
 
-	  _ASSERT(nSamplesUsed <= g_nBufferIdx);
-	  memmove(g_pSpeakerBuffer, &g_pSpeakerBuffer[nSamplesUsed], (g_nBufferIdx - nSamplesUsed) * sizeof(short) * g_nSPKR_NumChannels);
-	  g_nBufferIdx -= nSamplesUsed;
+	  // Hand everything to the mixer (during full-speed it just holds the last level)
+	  g_speakerSource.Write(g_pSpeakerBuffer, g_nBufferIdx);
+	  g_nBufferIdx = 0;
   }
 }
 
-// Called from SoundCore_TimerFunc() for FADE_OUT
-void SpkrUpdate_Timer()
+// Called by SAM card, just after SpkrToggle(): replace the toggled level with the 8 bit DAC's level (for the same cycle)
+void Spkr_SetDACLevel(short level)
 {
-	if (soundtype == SOUND_WAVE)
-	{
-		UpdateSpkr();
-		ULONG nSamplesUsed;
-
-		nSamplesUsed = Spkr_SubmitWaveBuffer_FullSpeed(g_pSpeakerBuffer, g_nBufferIdx);
+	g_nSpeakerData = level;
 
-		_ASSERT(nSamplesUsed <=	g_nBufferIdx);
-		memmove(g_pSpeakerBuffer, &g_pSpeakerBuffer[nSamplesUsed], (g_nBufferIdx - nSamplesUsed) * sizeof(short) * g_nSPKR_NumChannels);
-		g_nBufferIdx -=	nSamplesUsed;
-	}
-}
-
-//=============================================================================
-
-static DWORD dwByteOffset = (DWORD)-1;
-static int nNumSamplesError = 0;
-static int nDbgSpkrCnt = 0;
-
-// FullSpeed g_nAppMode, 2 cases:
-// i) Short burst of full-speed, so PlayCursor doesn't complete sound from previous fixed-speed session.
-// ii) Long burst of full-speed, so PlayCursor completes sound from previous fixed-speed session.
-
-// Try to:
-// 1) Output remaining samples from SpeakerBuffer (from previous fixed-speed session)
-// 2) Output pad samples to keep the VoiceBuffer topped-up
-
-// If nNumSamples>0 then these are from previous fixed-speed session.
-// - Output these before outputting zero-pad samples.
-
-static ULONG Spkr_SubmitWaveBuffer_FullSpeed(short* pSpeakerBuffer, ULONG nNumSamples)
-{
-	nDbgSpkrCnt++;
-
-	if(!SpeakerVoice.bActive)
-		return nNumSamples;
-
-	// pSpeakerBuffer can't be NULL, as reset clears g_bFullSpeed, so 1st SpkrUpdate() never calls here
-	_ASSERT(pSpeakerBuffer != NULL);
-
-	//
-
-	DWORD dwDSLockedBufferSize0, dwDSLockedBufferSize1;
-	SHORT *pDSLockedBuffer0, *pDSLockedBuffer1;
-	//bool bBufferError = false;
-
-	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
-	HRESULT hr = SpeakerVoice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
-	if(FAILED(hr))
-		return nNumSamples;
-
-	if(dwByteOffset == (DWORD)-1)
-	{
-		// First time in this func (probably after re-init (Spkr_SubmitWaveBuffer()))
-
-		dwByteOffset = dwCurrentPlayCursor + (g_dwDSSpkrBufferSize/8)*3;	// Ideal: 0.375 is between 0.25 & 0.50 full
-		dwByteOffset %= g_dwDSSpkrBufferSize;
-		//LogOutput("[Submit_FS] PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X [REINIT]\n", dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-	}
-	else
-	{
-		// Check that our offset isn't between Play & Write positions
-
-		if(dwCurrentWriteCursor > dwCurrentPlayCursor)
-		{
-			// |-----PxxxxxW-----|
-			if((dwByteOffset > dwCurrentPlayCursor) && (dwByteOffset < dwCurrentWriteCursor))
-			{
-				//LogOutput("[Submit_FS] PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X xxx\n", dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-				dwByteOffset = dwCurrentWriteCursor;
-			}
-		}
-		else
-		{
-			// |xxW----------Pxxx|
-			if((dwByteOffset > dwCurrentPlayCursor) || (dwByteOffset < dwCurrentWriteCursor))
-			{
-				//LogOutput("[Submit_FS] PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X XXX\n", dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-				dwByteOffset = dwCurrentWriteCursor;
-			}
-		}
-	}
-
-	// Calc bytes remaining to be played
-	int nBytesRemaining = dwByteOffset - dwCurrentPlayCursor;
-	if(nBytesRemaining < 0)
-		nBytesRemaining += g_dwDSSpkrBufferSize;
-	if((nBytesRemaining == 0) && (dwCurrentPlayCursor != dwCurrentWriteCursor))
-		nBytesRemaining = g_dwDSSpkrBufferSize;		// Case when complete buffer is to be played
-
-	//
-
-	UINT nNumPadSamples = 0;
-
-	if(nBytesRemaining < g_dwDSSpkrBufferSize / 4)
-	{
-		// < 1/4 of play-buffer remaining (need *more* data)
-		nNumPadSamples = ((g_dwDSSpkrBufferSize / 4) - nBytesRemaining) / (sizeof(short) * g_nSPKR_NumChannels);
-
-		if(nNumPadSamples > nNumSamples)
-			nNumPadSamples -= nNumSamples;
-		else
-			nNumPadSamples = 0;
-
-		// NB. If nNumPadSamples>0 then all nNumSamples are to be used
-	}
-
-	//
-
-	UINT nBytesFree = g_dwDSSpkrBufferSize - nBytesRemaining;	// Calc free buffer space
-	ULONG nNumSamplesToUse = nNumSamples + nNumPadSamples;
-
-	if (nNumSamplesToUse * sizeof(short) * g_nSPKR_NumChannels > nBytesFree)
-		nNumSamplesToUse = nBytesFree / (sizeof(short) * g_nSPKR_NumChannels);
-
-	//
-
-	if(nNumSamplesToUse >= 128)	// Limit the buffer unlock/locking to a minimum
-	{
-		hr = DSGetLock(SpeakerVoice.lpDSBvoice,
-			dwByteOffset, (DWORD)nNumSamplesToUse * sizeof(short) * g_nSPKR_NumChannels,
-			&pDSLockedBuffer0, &dwDSLockedBufferSize0,
-			&pDSLockedBuffer1, &dwDSLockedBufferSize1);
-		if (FAILED(hr))
-			return nNumSamples;
-
-		//
-
-		DWORD dwBufferSize0 = 0;
-		DWORD dwBufferSize1 = 0;
-
-		if(nNumSamples)
-		{
-			//LogOutput("[Submit_FS] C=%08X, PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X ***\n", nDbgSpkrCnt, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-
-			if (nNumSamples * sizeof(short) * g_nSPKR_NumChannels <= dwDSLockedBufferSize0)
-			{
-				dwBufferSize0 = nNumSamples * sizeof(short) * g_nSPKR_NumChannels;
-				dwBufferSize1 = 0;
-			}
-			else
-			{
-				dwBufferSize0 = dwDSLockedBufferSize0;
-				dwBufferSize1 = nNumSamples * sizeof(short) * g_nSPKR_NumChannels - dwDSLockedBufferSize0;
-
-				if(dwBufferSize1 > dwDSLockedBufferSize1)
-					dwBufferSize1 = dwDSLockedBufferSize1;
-			}
-			
-			memcpy(pDSLockedBuffer0, &pSpeakerBuffer[0], dwBufferSize0);
-			if (g_bSpkrOutputToRiff)
-				RiffPutSamples(pDSLockedBuffer0, dwBufferSize0 / (sizeof(short) * g_nSPKR_NumChannels));
-			nNumSamples = dwBufferSize0 / (sizeof(short) * g_nSPKR_NumChannels);
-
-			if(pDSLockedBuffer1 && dwBufferSize1)
-			{
-				memcpy(pDSLockedBuffer1, &pSpeakerBuffer[dwDSLockedBufferSize0/sizeof(short)], dwBufferSize1);
-				if (g_bSpkrOutputToRiff)
-					RiffPutSamples(pDSLockedBuffer1, dwBufferSize1 / (sizeof(short) * g_nSPKR_NumChannels));
-				nNumSamples += dwBufferSize1 / (sizeof(short) * g_nSPKR_NumChannels);
-			}
-		}
-
-		if(nNumPadSamples)
-		{
-			//LogOutput("[Submit_FS] C=%08X, PC=%08X, WC=%08X, Diff=%08X, Off=%08X, PS=%08X, Data=%04X\n", nDbgSpkrCnt, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumPadSamples, g_nSpeakerData);
-
-			dwBufferSize0 = dwDSLockedBufferSize0 - dwBufferSize0;
-			dwBufferSize1 = dwDSLockedBufferSize1 - dwBufferSize1;
-
-			if(dwBufferSize0)
-			{
-				const UINT numSamples = dwBufferSize0 / (sizeof(short) * g_nSPKR_NumChannels);
-				if (g_nSPKR_NumChannels == 1)
-				{
-					std::fill_n(pDSLockedBuffer0, numSamples, DCFilter(g_nSpeakerData));
-				}
-				else
-				{
-					for (UINT i = 0; i < numSamples; i++)
-					{
-						const short sample = DCFilter(g_nSpeakerData);
-						pDSLockedBuffer0[i * 2 + 0] = sample;
-						pDSLockedBuffer0[i * 2 + 1] = sample;
-					}
-				}
-
-				if (g_bSpkrOutputToRiff)
-					RiffPutSamples(pDSLockedBuffer0, numSamples);
-			}
-
-			if(pDSLockedBuffer1)
-			{
-				const UINT numSamples = dwBufferSize0 / (sizeof(short) * g_nSPKR_NumChannels);
-				if (g_nSPKR_NumChannels == 1)
-				{
-					std::fill_n(pDSLockedBuffer1, numSamples, DCFilter(g_nSpeakerData));
-				}
-				else
-				{
-					for (UINT i = 0; i < numSamples; i++)
-					{
-						const short sample = DCFilter(g_nSpeakerData);
-						pDSLockedBuffer1[i * 2 + 0] = sample;
-						pDSLockedBuffer1[i * 2 + 1] = sample;
-					}
-				}
-
-				if (g_bSpkrOutputToRiff)
-					RiffPutSamples(pDSLockedBuffer1, numSamples);
-			}
-		}
-
-		// Commit sound buffer
-		hr = SpeakerVoice.lpDSBvoice->Unlock((void*)pDSLockedBuffer0, dwDSLockedBufferSize0,
-											(void*)pDSLockedBuffer1, dwDSLockedBufferSize1);
-		if(FAILED(hr))
-			return nNumSamples;
-
-		dwByteOffset = (dwByteOffset + (DWORD)nNumSamplesToUse*sizeof(short)*g_nSPKR_NumChannels) % g_dwDSSpkrBufferSize;
-	}
-
-	return nNumSamples;
-}
-
-//-----------------------------------------------------------------------------
-
-static ULONG Spkr_SubmitWaveBuffer(short* pSpeakerBuffer, ULONG nNumSamples)
-{
-	nDbgSpkrCnt++;
-
-	if(!SpeakerVoice.bActive)
-		return nNumSamples;
-
-	if(pSpeakerBuffer == NULL)
-	{
-		// Re-init from SpkrReset()
-		dwByteOffset = (DWORD)-1;
-		nNumSamplesError = 0;
-
-		// Don't call DSZeroVoiceBuffer() - get noise with "VIA AC'97 Enhanced Audio Controller"
-		// . I guess SpeakerVoice.Stop() isn't really working and the new zero buffer causes noise corruption when submitted.
-		bool res = DSZeroVoiceWritableBuffer(&SpeakerVoice, g_dwDSSpkrBufferSize);
-		LogFileOutput("Spkr_SubmitWaveBuffer: DSZeroVoiceWritableBuffer, res=%d\n", res ? 1 : 0);
-
-		return 0;
-	}
-
-	//
-
-	DWORD dwDSLockedBufferSize0, dwDSLockedBufferSize1;
-	SHORT *pDSLockedBuffer0, *pDSLockedBuffer1;
-	bool bBufferError = false;
-
-	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
-	HRESULT hr = SpeakerVoice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
-	if (FAILED(hr))
-	{
-		LogFileOutput("Spkr_SubmitWaveBuffer: GetCurrentPosition failed (%08X)\n", hr);
-		return nNumSamples;
-	}
-
-	if(dwByteOffset == (DWORD)-1)
-	{
-		// First time in this func (probably after re-init (above))
-
-		dwByteOffset = dwCurrentPlayCursor + (g_dwDSSpkrBufferSize/8)*3;	// Ideal: 0.375 is between 0.25 & 0.50 full
-		dwByteOffset %= g_dwDSSpkrBufferSize;
-		//LogOutput("[Submit]   PC=%08X, WC=%08X, Diff=%08X, Off=%08X [REINIT]\n", dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset);
-	}
-	else
-	{
-		// Check that our offset isn't between Play & Write positions
-
-		if(dwCurrentWriteCursor > dwCurrentPlayCursor)
-		{
-			// |-----PxxxxxW-----|
-			if((dwByteOffset > dwCurrentPlayCursor) && (dwByteOffset < dwCurrentWriteCursor))
-			{
-				double fTicksSecs = (double)GetTickCount() / 1000.0;
-				//LogOutput("%010.3f: [Submit]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X xxx\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-				//LogFileOutput("%010.3f: [Submit]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X xxx\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-
-				dwByteOffset = dwCurrentWriteCursor;
-				nNumSamplesError = 0;
-				bBufferError = true;
-			}
-		}
-		else
-		{
-			// |xxW----------Pxxx|
-			if((dwByteOffset > dwCurrentPlayCursor) || (dwByteOffset < dwCurrentWriteCursor))
-			{
-				double fTicksSecs = (double)GetTickCount() / 1000.0;
-				//LogOutput("%010.3f: [Submit]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X XXX\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-				//LogFileOutput("%010.3f: [Submit]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X XXX\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-
-				dwByteOffset = dwCurrentWriteCursor;
-				nNumSamplesError = 0;
-				bBufferError = true;
-			}
-		}
-	}
-
-	// Calc bytes remaining to be played
-	int nBytesRemaining = dwByteOffset - dwCurrentPlayCursor;
-	if(nBytesRemaining < 0)
-		nBytesRemaining += g_dwDSSpkrBufferSize;
-	if((nBytesRemaining == 0) && (dwCurrentPlayCursor != dwCurrentWriteCursor))
-		nBytesRemaining = g_dwDSSpkrBufferSize;		// Case when complete buffer is to be played
-
-	// Calc correction factor so that play-buffer doesn't under/overflow
-	const int nErrorInc = SoundCore_GetErrorInc();
-	if(nBytesRemaining < g_dwDSSpkrBufferSize / 4)
-		nNumSamplesError += nErrorInc;				// < 1/4 of play-buffer remaining (need *more* data)
-	else if(nBytesRemaining > g_dwDSSpkrBufferSize / 2)
-		nNumSamplesError -= nErrorInc;				// > 1/2 of play-buffer remaining (need *less* data)
-	else
-		nNumSamplesError = 0;						// Acceptable amount of data in buffer
-
-	const int nErrorMax = SoundCore_GetErrorMax();				// Cap feedback to +/-nMaxError units
-	if(nNumSamplesError < -nErrorMax) nNumSamplesError = -nErrorMax;
-	if(nNumSamplesError >  nErrorMax) nNumSamplesError =  nErrorMax;
-	g_nCpuCyclesFeedback = (int) ((double)nNumSamplesError * g_fClksPerSpkrSample);
-
-	//
-
-	UINT nBytesFree = g_dwDSSpkrBufferSize - nBytesRemaining;	// Calc free buffer space
-	ULONG nNumSamplesToUse = nNumSamples;
-
-	if(nNumSamplesToUse * sizeof(short) > nBytesFree)
-		nNumSamplesToUse = nBytesFree / sizeof(short);
-
-	if(bBufferError)
-		pSpeakerBuffer = &pSpeakerBuffer[nNumSamples - nNumSamplesToUse];
-
-	//
-
-	if(nNumSamplesToUse)
-	{
-		//LogOutput("[Submit]    C=%08X, PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X +++\n", nDbgSpkrCnt, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamplesToUse);
-
-		hr = DSGetLock(SpeakerVoice.lpDSBvoice,
-			dwByteOffset, (DWORD)nNumSamplesToUse * sizeof(short) * g_nSPKR_NumChannels,
-			&pDSLockedBuffer0, &dwDSLockedBufferSize0,
-			&pDSLockedBuffer1, &dwDSLockedBufferSize1);
-		if (FAILED(hr))
-		{
-			LogFileOutput("Spkr_SubmitWaveBuffer: DSGetLock failed\n");
-			return nNumSamples;
-		}
-
-		memcpy(pDSLockedBuffer0, &pSpeakerBuffer[0], dwDSLockedBufferSize0);
-		if (g_bSpkrOutputToRiff)
-			RiffPutSamples(pDSLockedBuffer0, dwDSLockedBufferSize0 / (sizeof(short) * g_nSPKR_NumChannels));
-
-		if(pDSLockedBuffer1)
-		{
-			memcpy(pDSLockedBuffer1, &pSpeakerBuffer[dwDSLockedBufferSize0/sizeof(short)], dwDSLockedBufferSize1);
-			if (g_bSpkrOutputToRiff)
-				RiffPutSamples(pDSLockedBuffer1, dwDSLockedBufferSize1 / (sizeof(short) * g_nSPKR_NumChannels));
-		}
-
-		// Commit sound buffer
-		hr = SpeakerVoice.lpDSBvoice->Unlock((void*)pDSLockedBuffer0, dwDSLockedBufferSize0,
-											(void*)pDSLockedBuffer1, dwDSLockedBufferSize1);
-		if (FAILED(hr))
-		{
-			LogFileOutput("Spkr_SubmitWaveBuffer: Unlock failed (%08X)\n", hr);
-			return nNumSamples;
-		}
-
-		dwByteOffset = (dwByteOffset + (DWORD)nNumSamplesToUse*sizeof(short)*g_nSPKR_NumChannels) % g_dwDSSpkrBufferSize;
-	}
-
-	return bBufferError ? nNumSamples : nNumSamplesToUse;
+	if (g_nSpkrNumEvents && g_spkrEvents[g_nSpkrNumEvents - 1].cycle == g_nCumulativeCycles)
+		g_spkrEvents[g_nSpkrNumEvents - 1].level = level;
 }
 
 //-----------------------------------------------------------------------------
@@ -876,23 +569,13 @@ static ULONG Spkr_SubmitWaveBuffer(short* pSpeakerBuffer, ULONG nNumSamples)
 // NB. Not currently used
 void Spkr_Mute()
 {
-	if(SpeakerVoice.bActive && !SpeakerVoice.bMute)
-	{
-		HRESULT hr = SpeakerVoice.lpDSBvoice->SetVolume(DSBVOLUME_MIN);
-		LogFileOutput("Spkr_Mute: SetVolume(%d) res = %08X\n", DSBVOLUME_MIN, hr);
-		SpeakerVoice.bMute = true;
-	}
+	g_speakerSource.SetMute(true);
 }
 
 // NB. Only called by SpkrReset()
 void Spkr_Unmute()
 {
-	if(SpeakerVoice.bActive && SpeakerVoice.bMute)
-	{
-		HRESULT hr = SpeakerVoice.lpDSBvoice->SetVolume(SpeakerVoice.nVolume);
-		LogFileOutput("Spkr_Unmute: SetVolume(%d) res = %08X\n", SpeakerVoice.nVolume, hr);
-		SpeakerVoice.bMute = false;
-	}
+	g_speakerSource.SetMute(false);
 }
 
 //-----------------------------------------------------------------------------
@@ -901,20 +584,18 @@ static bool g_bSpkrRecentlyActive = false;
 
 static void Spkr_SetActive(bool bActive)
 {
-	if(!SpeakerVoice.bActive)
+	if(!g_speakerSource.IsActive())
 		return;
 
 	if(bActive)
 	{
 		// Called by SpkrToggle() or SpkrReset()
 		g_bSpkrRecentlyActive = true;
-		SpeakerVoice.bRecentlyActive = true;
 	}
 	else
 	{
 		// Called by SpkrUpdate() after 0.2s of speaker inactivity
 		g_bSpkrRecentlyActive = false;
-		SpeakerVoice.bRecentlyActive = false;
 		g_bQuieterSpeaker = 0;	// undo any muting (for 8 bit DAC)
 	}
 }
@@ -928,20 +609,12 @@ bool Spkr_IsActive()
 
 DWORD SpkrGetVolume()
 {
-	return SpeakerVoice.dwUserVolume;
+	return g_speakerSource.GetVolume();
 }
 
 void SpkrSetVolume(DWORD dwVolume, DWORD dwVolumeMax)
 {
-	SpeakerVoice.dwUserVolume = dwVolume;
-
-	SpeakerVoice.nVolume = NewVolume(dwVolume, dwVolumeMax);
-
-	if (SpeakerVoice.bActive && !SpeakerVoice.bMute)
-	{
-		HRESULT hr = SpeakerVoice.lpDSBvoice->SetVolume(SpeakerVoice.nVolume);
-		LogFileOutput("SpkrSetVolume: SetVolume(%d) res = %08X\n", SpeakerVoice.nVolume, hr);
-	}
+	g_speakerSource.SetVolume(dwVolume, dwVolumeMax);
 }
 
 //=============================================================================
@@ -949,65 +622,24 @@ void SpkrSetVolume(DWORD dwVolume, DWORD dwVolumeMax)
 bool Spkr_DSInit()
 {
 	//
-	// Create single Apple speaker voice
+	// Add the single Apple speaker source to the mixer
 	//
 
-	if (!g_bDSAvailable)
+	if (!GetSoundMixer().IsOutputAvailable())
 	{
-		LogFileOutput("Spkr_DSInit: g_bDSAvailable=0\n");
+		LogFileOutput("Spkr_DSInit: no sound output\n");
 		return false;
 	}
 
-	SpeakerVoice.bIsSpeaker = true;
+	g_speakerSource.Init("Spkr", SPKR_SAMPLE_RATE, g_nSPKR_NumChannels);
+	g_speakerSource.SetPacing(true);	// Samples are tied to emulated cycles, so the speaker's backlog paces the emulation
 
-	HRESULT hr = DSGetSoundBuffer(&SpeakerVoice, DSBCAPS_CTRLVOLUME, g_dwDSSpkrBufferSize, SPKR_SAMPLE_RATE, g_nSPKR_NumChannels, "Spkr");
-	if (FAILED(hr))
-	{
-		LogFileOutput("Spkr_DSInit: DSGetSoundBuffer failed (%08X)\n", hr);
-		return false;
-	}
-
-	if (!DSZeroVoiceBuffer(&SpeakerVoice, g_dwDSSpkrBufferSize))
-	{
-		LogFileOutput("Spkr_DSInit: DSZeroVoiceBuffer failed\n");
-		return false;
-	}
-
-	SpeakerVoice.bActive = true;
-
-	// Volume might've been setup from value in Registry
-	if(!SpeakerVoice.nVolume)
-		SpeakerVoice.nVolume = DSBVOLUME_MAX;
-
-	hr = SpeakerVoice.lpDSBvoice->SetVolume(SpeakerVoice.nVolume);
-	LogFileOutput("Spkr_DSInit: SetVolume(%d) res = %08X\n", SpeakerVoice.nVolume, hr);
-
-	//
-
-	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
-	hr = SpeakerVoice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
-	if (FAILED(hr))
-		LogFileOutput("Spkr_DSInit: GetCurrentPosition failed (%08X)\n", hr);
-	if (SUCCEEDED(hr) && (dwCurrentPlayCursor == dwCurrentWriteCursor))
-	{
-		// KLUDGE: For my WinXP PC with "VIA AC'97 Enhanced Audio Controller"
-		// . Not required for my Win98SE/WinXP PC with PCI "Soundblaster Live!"
-		Sleep(200);
-
-		hr = SpeakerVoice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
-		LogFileOutput("Spkr_DSInit: GetCurrentPosition kludge (%08X)\n", hr);
-		LogOutput("[DSInit] PC=%08X, WC=%08X, Diff=%08X\n", dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor);
-	}
-
-	return true;
+	return GetSoundMixer().AddSource(&g_speakerSource);
 }
 
 static void Spkr_DSUninit()
 {
-	if(SpeakerVoice.lpDSBvoice && SpeakerVoice.bActive)
-		DSVoiceStop(&SpeakerVoice);
-
-	DSReleaseSoundBuffer(&SpeakerVoice);
+	GetSoundMixer().RemoveSource(&g_speakerSource);
 }
 
 //=============================================================================
@@ -1032,6 +664,7 @@ void SpkrLoadSnapshot(YamlLoadHelper& yamlLoadHelper)
 		return;
 
 	g_nSpkrLastCycle = yamlLoadHelper.LoadUint64(SS_YAML_KEY_LASTCYCLE);
+	DiscardSpkrEvents();
 
 	yamlLoadHelper.PopMap();
 }
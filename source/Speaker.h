@@ -13,9 +13,7 @@ enum SoundType_e
 };
 
 extern SoundType_e soundtype;
-extern double     g_fClksPerSpkrSample;
 extern bool       g_bQuieterSpeaker;
-extern short      g_nSpeakerData;
 
 void    SpkrDestroy ();
 void    SpkrInitialize ();
@@ -23,14 +21,13 @@ void    SpkrReinitialize ();
 void    SpkrReset();
 void    SpkrSetEmulationType (SoundType_e newSoundType);
 void    SpkrUpdate (DWORD);
-void    SpkrUpdate_Timer();
+void    Spkr_SetDACLevel(short level);
 DWORD   SpkrGetVolume();
 void    SpkrSetVolume(DWORD dwVolume, DWORD dwVolumeMax);
 void    Spkr_Mute();
 void    Spkr_Unmute();
 bool    Spkr_IsActive();
 bool    Spkr_DSInit();
-void	Spkr_OutputToRiff(void);
 UINT    Spkr_GetNumChannels(void);
 void    SpkrSaveSnapshot(class YamlSaveHelper& yamlSaveHelper);
 void    SpkrLoadSnapshot(class YamlLoadHelper& yamlLoadHelper);
@@ -34,16 +34,18 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Utilities.h"
 #include "CmdLine.h"
 #include "Debug.h"
+#include "DiskImage.h"
 #include "Log.h"
 #include "Memory.h"
 #include "Mockingboard.h"
 #include "MouseInterface.h"
 #include "ParallelPrinter.h"
 #include "Registry.h"
-#include "Riff.h"
 #include "SaveState.h"
 #include "SerialComms.h"
 #include "SoundCore.h"
+#include "SoundCapture.h"
+#include "SoundMixer.h"
 #include "Speaker.h"
 #include "LanguageCard.h"
 #include "CardManager.h"
@@ -146,6 +148,8 @@ static void ContinueExecution(void)
 
 	_ASSERT(g_nAppMode == MODE_RUNNING || g_nAppMode == MODE_STEPPING);
 
+	VideoCatchUp();	// In case RunCycles() ran without the video scanner
+
 	const double fUsecPerSec        = 1.e6;
 #if 1
 	const UINT nExecutionPeriodUsec = 1000;		// 1.0ms
@@ -259,10 +263,10 @@ static void ContinueExecution(void)
 		}
 	}
 
-	// For MODE_STEPPING: do this speaker update periodically
+	// For MODE_STEPPING: do this speaker update (and the mix to the sound output) periodically
 	// - Otherwise kills performance due to sound-buffer lock/unlock for every 6502 opcode!
 	if (g_nAppMode == MODE_RUNNING || bModeStepping_WaitTimer)
-		SpkrUpdate(uSpkrActualCyclesExecuted);
+		ExecutionPeriodUpdate(uSpkrActualCyclesExecuted);
 
 	//
 
@@ -279,16 +283,7 @@ static void ContinueExecution(void)
 		else
 			GetFrame().VideoPresentScreen(); // Just copy the output of our Apple framebuffer to the system Back Buffer
 
-#ifdef USE_RETROACHIEVEMENTS
-		if (g_nAppMode == MODE_RUNNING || g_nAppMode == MODE_STEPPING)
-			RA_DoAchievementsFrame();
-#endif
-
-		if (g_bFrameAdvance)
-		{
-			g_nAppMode = MODE_PAUSED;
-			g_bFrameAdvance = false;
-		}
+		ExecutionFrameUpdate();
 	}
 
 #ifdef LOG_PERF_TIMINGS
@@ -600,13 +595,13 @@ int APIENTRY WinMain(HINSTANCE passinstance, HINSTANCE, LPSTR lpCmdLine, int)
 				CMouseInterface* pMouseCard = GetCardMgr().GetMouseCard();
 				if (pMouseCard)
 				{
-					// dtor removes event from g_SynchronousEventMgr - do before g_SynchronousEventMgr.Reset()
+					// dtor removes event from GetSynchronousEventMgr() - do before its Reset()
 					GetCardMgr().Remove( pMouseCard->GetSlot(), false );
 					LogFileOutput("Main: CMouseInterface::dtor\n");
 				}
 
-				_ASSERT(g_SynchronousEventMgr.GetHead() == NULL);
-				g_SynchronousEventMgr.Reset();
+				_ASSERT(GetSynchronousEventMgr().GetHead() == NULL);
+				GetSynchronousEventMgr().Reset();
 			}
 
 			DSUninit();
@@ -671,17 +666,25 @@ static void GetAppleWinVersion(void)
 // DO ONE-TIME INITIALIZATION
 static void OneTimeInitialization(HINSTANCE passinstance)
 {
-	// Currently only support one RIFF file
+	// Per-source WAV captures (taken before the mix, so any combination can be used together)
+	GetSoundCapture().SetLossless(g_cmdLine.wavCaptureLossless);
+
 	if (!g_cmdLine.wavFileSpeaker.empty())
-	{
-		if (RiffInitWriteFile(g_cmdLine.wavFileSpeaker.c_str(), SPKR_SAMPLE_RATE, Spkr_GetNumChannels()))
-			Spkr_OutputToRiff();
-	}
-	else if (!g_cmdLine.wavFileMockingboard.empty())
-	{
-		if (RiffInitWriteFile(g_cmdLine.wavFileMockingboard.c_str(), MockingboardCard::SAMPLE_RATE, MockingboardCard::NUM_MB_CHANNELS))
-			GetCardMgr().GetMockingboardCardMgr().OutputToRiff();
-	}
+		GetSoundCapture().SetFile("Spkr", g_cmdLine.wavFileSpeaker);
+
+	if (!g_cmdLine.wavFileMockingboard.empty())
+		GetSoundCapture().SetFile("MB", g_cmdLine.wavFileMockingboard);
+
+	if (!g_cmdLine.wavCaptureDir.empty())
+		GetSoundCapture().SetDirectory(g_cmdLine.wavCaptureDir);
+
+	// Mix to a WAV file instead of the sound device
+	if (!g_cmdLine.wavFileOutput.empty())
+		GetSoundMixer().SetWavOutput(g_cmdLine.wavFileOutput.c_str());
+
+	// Before any disk images are opened (from the cmd-line or the saved config)
+	if (!g_cmdLine.strDiskOverlayDir.empty())
+		ImageSetOverlay(g_cmdLine.strDiskOverlayDir, g_cmdLine.diskOverlayOpenAction);
 
 	// Initialize COM - so we can use CoCreateInstance
 	// . DSInit() & DIMouse::DirectInputInit are done when g_hFrameWindow is created (WM_CREATE)
@@ -949,6 +952,27 @@ static void RepeatInitialization(void)
 		if (g_cmdLine.noDisk2StepperDefer)
 			GetCardMgr().GetDisk2CardMgr().SetStepperDefer(false);
 
+		if (g_cmdLine.diskTrackPrefetch)
+			GetCardMgr().GetDisk2CardMgr().SetTrackPrefetch(true);
+
+		if (g_cmdLine.diskAccelerated)
+			CpuSetDiskAccelerated(true);
+
+		if (g_cmdLine.memPagingByPointer)
+			MemSetPagingByPointer(true);
+
+		if (g_cmdLine.videoScanlineCache)
+			NTSC_SetScanlineCache(true);
+
+		if (g_cmdLine.uDiskWriteBackIdleMs)
+			ImageSetWriteBackIdleTimeout(g_cmdLine.uDiskWriteBackIdleMs);
+
+		if (g_cmdLine.uRewindSnapshots)
+		{
+			const UINT kDefaultFramesPerSnapshot = 15;	// 4 snapshots per second (at 60Hz)
+			Snapshot_SetRewind(g_cmdLine.uRewindSnapshots, g_cmdLine.uRewindFramesPerSnapshot ? g_cmdLine.uRewindFramesPerSnapshot : kDefaultFramesPerSnapshot);
+		}
+
 		// Call DebugInitialize() after SetCurrentImageDir()
 		DebugInitialize();
 		LogFileOutput("Main: DebugInitialize()\n");
@@ -1066,6 +1090,14 @@ static void Shutdown(void)
 	LogFileOutput("Exit: RA_Shutdown()\n");
 #endif
 
+	// NB. Ejecting the disks (in WM_DESTROY) has queued any dirty gzip/zip images for write-back
+	ImageWriteBackShutdown();
+	LogFileOutput("Exit: ImageWriteBackShutdown()\n");
+
+	// Flush & close any WAV files
+	GetSoundCapture().Shutdown();
+	LogFileOutput("Exit: SoundCapture Shutdown()\n");
+
 	// Release COM
 	SysClk_UninitTimer();
 	LogFileOutput("Exit: SysClk_UninitTimer()\n");
@@ -1075,8 +1107,6 @@ static void Shutdown(void)
 
 	LogDone();
 
-	RiffFinishWriteFile();
-
 	if (g_hCustomRomF8 != INVALID_HANDLE_VALUE)
 		CloseHandle(g_hCustomRomF8);
 
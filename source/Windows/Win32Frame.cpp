@@ -163,6 +163,7 @@ void Win32Frame::Destroy(void)
 void Win32Frame::Benchmark(void)
 {
 	_ASSERT(g_nAppMode == MODE_BENCHMARK);
+	MemUpdatePagingByPointer();	// Benchmark writes directly to 'mem'
 	Sleep(500);
 	Video& video = GetVideo();
 
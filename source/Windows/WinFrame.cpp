@@ -45,6 +45,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "SaveState.h"
 #include "SerialComms.h"
 #include "SoundCore.h"
+#include "SoundMixer.h"
 #include "Uthernet1.h"
 #include "Uthernet2.h"
 #include "Speaker.h"
@@ -634,16 +635,16 @@ void Win32Frame::GetTrackSector(UINT slot, int& drive1Track, int& drive2Track, i
 	drive2Track = disk2Card.GetTrack(DRIVE_2);
 
 	// Probe known OS's for default Slot/Track/Sector
-	const bool isProDOS = mem[0xBF00] == 0x4C;
+	const bool isProDOS = *MemGetReadPtr(0xBF00) == 0x4C;
 	bool isSectorValid = false;
 	int drive1Sector = -1, drive2Sector = -1;
 
 	// Try DOS3.3 Sector
 	if (!isProDOS)
 	{
-		const int nDOS33slot = mem[0xB7E9] / 16;
-		const int nDOS33track = mem[0xB7EC];
-		const int nDOS33sector = mem[0xB7ED];
+		const int nDOS33slot = *MemGetReadPtr(0xB7E9) / 16;
+		const int nDOS33track = *MemGetReadPtr(0xB7EC);
+		const int nDOS33sector = *MemGetReadPtr(0xB7ED);
 
 		if ((nDOS33slot == slot)
 			&& (nDOS33track >= 0 && nDOS33track < 40)
@@ -1075,6 +1076,7 @@ LRESULT Win32Frame::WndProc(
       CpuDestroy();
       MemDestroy();
       SpkrDestroy();
+      GetSoundMixer().Destroy();
       Destroy();
       DeleteGdiObjects();
       DIMouse::DirectInputUninit(window);	// NB. do before window is destroyed
@@ -1096,6 +1098,9 @@ LRESULT Win32Frame::WndProc(
 	  DIMouse::DirectInputInit(window);
       LogFileOutput("WM_CREATE: DIMouse::DirectInputInit()\n");
 
+	  GetSoundMixer().Initialize();	// NB. Need DSInit() for the DirectSound output
+      LogFileOutput("WM_CREATE: GetSoundMixer().Initialize()\n");
+
 	  SpkrInitialize();
       LogFileOutput("WM_CREATE: SpkrInitialize()\n");
 
@@ -1276,6 +1281,10 @@ LRESULT Win32Frame::WndProc(
 			}
 			SoundCore_SetFade(FADE_IN);
 		}
+		else if (wparam == VK_F12 && KeybGetShiftStatus() && Snapshot_IsRewindEnabled())	// Rewind (Shift+F12)
+		{
+			Snapshot_Rewind();
+		}
 		else if (wparam == VK_F12)					// Load state (F12 or Ctrl+F12)
 		{
 			SoundCore_SetFade(FADE_OUT);
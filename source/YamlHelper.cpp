@@ -26,27 +26,106 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "YamlHelper.h"
 #include "Log.h"
 
+#include "zlib.h"
+
 #include <sstream>
 
+bool IsBinarySaveStatePathname(const std::string& pathname)
+{
+	const std::string ext(SS_BINARY_FILE_EXT);
+	if (pathname.size() <= ext.size())
+		return false;
+
+	return _stricmp(pathname.c_str() + pathname.size() - ext.size(), ext.c_str()) == 0;
+}
+
+//-------------------------------------
+
 int YamlHelper::InitParser(const char* pPathname)
 {
-	m_hFile = fopen(pPathname, "r");
+	// The container type is determined by the file's contents, not its extension
+	m_hFile = fopen(pPathname, "rb");
 	if (m_hFile == NULL)
 	{
 		return 0;
 	}
 
+	bool isBinary = false;
+	char magic[sizeof(SaveStateBinaryHdr::magic)];
+	if (fread(magic, sizeof(magic), 1, m_hFile) == 1 && memcmp(magic, SS_BINARY_MAGIC, sizeof(magic)) == 0)
+		isBinary = true;
+
+	if (isBinary)
+	{
+		if (!InitBinaryContainer())
+			return 0;
+	}
+	else
+	{
+		fclose(m_hFile);
+		m_hFile = fopen(pPathname, "r");
+		if (m_hFile == NULL)
+		{
+			return 0;
+		}
+	}
+
 	if (!yaml_parser_initialize(&m_parser))
 	{
 		return 0;
 	}
 
 	// Note: C/C++ > Pre-Processor: YAML_DECLARE_STATIC;
-	yaml_parser_set_input_file(&m_parser, m_hFile);
+	if (isBinary)
+		yaml_parser_set_input_string(&m_parser, (const unsigned char*)m_binaryYaml.data(), m_binaryYaml.size());
+	else
+		yaml_parser_set_input_file(&m_parser, m_hFile);
+
+	return 1;
+}
+
+int YamlHelper::InitParser(const SaveStateBuffer& buffer)
+{
+	m_pBuffer = &buffer;
+
+	if (!yaml_parser_initialize(&m_parser))
+	{
+		return 0;
+	}
+
+	yaml_parser_set_input_string(&m_parser, (const unsigned char*)buffer.m_yaml.data(), buffer.m_yaml.size());
 
 	return 1;
 }
 
+// Read the binary container's header, YAML text & block table
+// . The memory blocks are read later by LoadMemory(), directly into the emulator's memory
+bool YamlHelper::InitBinaryContainer(void)
+{
+	SaveStateBinaryHdr hdr;
+	if (fseek(m_hFile, 0, SEEK_SET) != 0 || fread(&hdr, sizeof(hdr), 1, m_hFile) != 1)
+		return false;
+
+	if (hdr.version != SS_BINARY_VER)
+		throw std::runtime_error("Binary save-state: Version mismatch");
+
+	m_binaryYaml.resize(hdr.yamlSize);
+	if (hdr.yamlSize)
+	{
+		if (fseek(m_hFile, hdr.yamlOffset, SEEK_SET) != 0 || fread(&m_binaryYaml[0], hdr.yamlSize, 1, m_hFile) != 1)
+			return false;
+	}
+
+	m_binaryBlocks.resize(hdr.numBlocks);
+	if (hdr.numBlocks)
+	{
+		if (fseek(m_hFile, hdr.blockTableOffset, SEEK_SET) != 0 || fread(&m_binaryBlocks[0], sizeof(SaveStateBinaryBlock), hdr.numBlocks, m_hFile) != hdr.numBlocks)
+			return false;
+	}
+
+	return true;
+}
+
 void YamlHelper::FinaliseParser(void)
 {
 	if (m_hFile)
@@ -56,6 +135,10 @@ void YamlHelper::FinaliseParser(void)
 
 	yaml_event_delete(&m_newEvent);
 	yaml_parser_delete(&m_parser);
+
+	m_binaryYaml.clear();
+	m_binaryBlocks.clear();
+	m_pBuffer = NULL;
 }
 
 UINT YamlHelper::ParseFileHdr(const char* tag)
@@ -274,6 +357,14 @@ void YamlHelper::MakeAsciiToHexTable(void)
 
 UINT YamlHelper::LoadMemory(MapYaml& mapYaml, const LPBYTE pMemBase, const size_t kAddrSpaceSize, const UINT offset)
 {
+	MapYaml::iterator itBlock = mapYaml.find(SS_YAML_KEY_BINARY_BLOCK);
+	if (itBlock != mapYaml.end())
+	{
+		const std::string value = itBlock->second.value;
+		mapYaml.clear();
+		return LoadMemoryBlock(value, pMemBase, kAddrSpaceSize, offset);
+	}
+
 	UINT bytes = 0;
 
 	for (MapYaml::iterator it = mapYaml.begin(); it != mapYaml.end(); ++it)
@@ -314,6 +405,60 @@ UINT YamlHelper::LoadMemory(MapYaml& mapYaml, const LPBYTE pMemBase, const size_
 	return bytes;
 }
 
+UINT YamlHelper::LoadMemoryBlock(const std::string& value, const LPBYTE pMemBase, const size_t kAddrSpaceSize, const UINT offset)
+{
+	const UINT idx = strtoul(value.c_str(), NULL, 0);
+
+	if (m_pBuffer)
+	{
+		if (idx >= m_pBuffer->m_numBlocks)
+			throw std::runtime_error("Memory: binary block number too big: " + value);
+
+		const SaveStateMemoryBlock& block = m_pBuffer->m_blocks[idx];
+		if ((size_t)block.addr + block.size > kAddrSpaceSize + offset)
+			throw std::runtime_error("Memory: binary block overflowed address space: " + value);
+
+		LPBYTE pDst = pMemBase + block.addr;
+		for (UINT addr = 0; addr < block.size; addr += sizeof(SaveStateMemoryPage))
+		{
+			const UINT size = std::min<UINT>((UINT)sizeof(SaveStateMemoryPage), block.size - addr);
+			memcpy(pDst + addr, block.pages[addr / sizeof(SaveStateMemoryPage)]->data, size);
+		}
+
+		return block.size;
+	}
+
+	if (idx >= m_binaryBlocks.size())
+		throw std::runtime_error("Memory: binary block number too big: " + value);
+
+	const SaveStateBinaryBlock& block = m_binaryBlocks[idx];
+	if ((size_t)block.addr + block.size > kAddrSpaceSize + offset)
+		throw std::runtime_error("Memory: binary block overflowed address space: " + value);
+
+	if (fseek(m_hFile, block.fileOffset, SEEK_SET) != 0)
+		throw std::runtime_error("Memory: binary block seek failed: " + value);
+
+	LPBYTE pDst = pMemBase + block.addr;
+
+	if (block.storedSize == block.size)
+	{
+		if (block.size && fread(pDst, block.size, 1, m_hFile) != 1)
+			throw std::runtime_error("Memory: binary block read failed: " + value);
+	}
+	else
+	{
+		std::vector<BYTE> compressed(block.storedSize);
+		if (block.storedSize && fread(&compressed[0], block.storedSize, 1, m_hFile) != 1)
+			throw std::runtime_error("Memory: binary block read failed: " + value);
+
+		uLongf size = block.size;
+		if (uncompress(pDst, &size, compressed.data(), block.storedSize) != Z_OK || size != block.size)
+			throw std::runtime_error("Memory: binary block decompression failed: " + value);
+	}
+
+	return block.size;
+}
+
 //-------------------------------------
 
 INT YamlLoadHelper::LoadInt(const std::string key)
@@ -424,13 +569,29 @@ void YamlLoadHelper::LoadMemory(std::vector<BYTE>& memory, const size_t size, co
 
 //-------------------------------------
 
+void YamlSaveHelper::Write(const char* pData, const size_t size)
+{
+	if (m_pBuffer)
+		m_pBuffer->m_yaml.append(pData, size);
+	else
+		fwrite(pData, 1, size, m_hFile);
+}
+
+void YamlSaveHelper::WriteV(const char* format, va_list vl)
+{
+	if (m_pBuffer)
+		m_pBuffer->m_yaml += StrFormatV(format, vl);
+	else
+		vfprintf(m_hFile, format, vl);
+}
+
 void YamlSaveHelper::Save(const char* format, ...)
 {
-	fwrite(m_szIndent, 1, m_indent, m_hFile);
+	Write(m_szIndent, m_indent);
 
 	va_list vl;
 	va_start(vl, format);
-	vfprintf(m_hFile, format, vl);
+	WriteV(format, vl);
 	va_end(vl);
 }
 
@@ -552,6 +713,18 @@ void YamlSaveHelper::SaveMemory(const LPBYTE pMemBase, const UINT uMemSize, cons
 	if (uMemSize & 7)
 		throw std::runtime_error("Memory: size must be multiple of 8");
 
+	if (m_pBuffer)
+	{
+		SaveMemoryPages(pMemBase, uMemSize, offset);
+		return;
+	}
+
+	if (m_binary)
+	{
+		SaveMemoryBlock(pMemBase, uMemSize, offset);
+		return;
+	}
+
 	const UINT kIndent = m_indent;
 
 	const UINT kStride = 64;
@@ -597,15 +770,110 @@ void YamlSaveHelper::SaveMemory(const LPBYTE pMemBase, const UINT uMemSize, cons
 		*pDst++ = '\n';
 		*pDst = 0;	// For debugger
 
-		fwrite(pLine, 1, lineSize-1, m_hFile);	// -1 so don't write null terminator
+		Write(pLine, lineSize-1);	// -1 so don't write null terminator
 	}
 
 	delete [] pLine;
 }
 
+// Binary container: save the memory as a (compressed if smaller) block, and just reference it from the YAML
+void YamlSaveHelper::SaveMemoryBlock(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset)
+{
+	SaveStateBinaryBlock block = {};
+	block.addr = offset;
+	block.size = uMemSize;
+
+	std::vector<BYTE> data(compressBound(uMemSize));
+	uLongf compressedSize = (uLongf)data.size();
+	if (compress2(&data[0], &compressedSize, pMemBase + offset, uMemSize, Z_BEST_SPEED) == Z_OK && compressedSize < uMemSize)
+	{
+		data.resize(compressedSize);
+	}
+	else
+	{
+		data.assign(pMemBase + offset, pMemBase + offset + uMemSize);	// store raw
+	}
+	block.storedSize = (UINT32)data.size();
+
+	Save("%s: %u\n", SS_YAML_KEY_BINARY_BLOCK, (UINT)m_blocks.size());
+
+	m_blocks.push_back(block);
+	m_blockData.push_back(std::vector<BYTE>());
+	m_blockData.back().swap(data);
+}
+
+// In-memory save-state: save the memory as pages, sharing each page that's unchanged from the previous snapshot's
+// . The previous snapshot's block is only used if it's for the same memory (ie. same block #, address & size)
+void YamlSaveHelper::SaveMemoryPages(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset)
+{
+	const UINT idx = m_pBuffer->m_numBlocks++;
+	if (idx == m_pBuffer->m_blocks.size())
+		m_pBuffer->m_blocks.push_back(SaveStateMemoryBlock());
+
+	SaveStateMemoryBlock& block = m_pBuffer->m_blocks[idx];
+	block.addr = offset;
+	block.size = uMemSize;
+
+	const UINT kPageSize = sizeof(SaveStateMemoryPage);
+	const UINT numPages = (uMemSize + kPageSize - 1) / kPageSize;
+	block.pages.resize(numPages);
+
+	const SaveStateMemoryBlock* pPrevBlock = NULL;
+	if (m_pPrevBuffer && idx < m_pPrevBuffer->m_numBlocks)
+	{
+		pPrevBlock = &m_pPrevBuffer->m_blocks[idx];
+		if (pPrevBlock->addr != block.addr || pPrevBlock->size != block.size)
+			pPrevBlock = NULL;
+	}
+
+	const LPBYTE pSrc = pMemBase + offset;
+	for (UINT i = 0; i < numPages; i++)
+	{
+		const UINT size = std::min<UINT>(kPageSize, uMemSize - i * kPageSize);
+
+		if (pPrevBlock && memcmp(pPrevBlock->pages[i]->data, pSrc + i * kPageSize, size) == 0)
+		{
+			block.pages[i] = pPrevBlock->pages[i];	// unchanged, so share it
+			continue;
+		}
+
+		std::shared_ptr<SaveStateMemoryPage> page = std::make_shared<SaveStateMemoryPage>();
+		memcpy(page->data, pSrc + i * kPageSize, size);
+		block.pages[i] = page;
+	}
+
+	Save("%s: %u\n", SS_YAML_KEY_BINARY_BLOCK, idx);
+}
+
+// Binary container: append the memory blocks & block table after the YAML text, then write the real header
+void YamlSaveHelper::FinaliseBinaryContainer(void)
+{
+	SaveStateBinaryHdr hdr = {};
+	memcpy(hdr.magic, SS_BINARY_MAGIC, sizeof(hdr.magic));
+	hdr.version = SS_BINARY_VER;
+	hdr.yamlOffset = sizeof(hdr);
+	hdr.yamlSize = (UINT32)ftell(m_hFile) - hdr.yamlOffset;
+
+	for (size_t i = 0; i < m_blocks.size(); i++)
+	{
+		m_blocks[i].fileOffset = (UINT32)ftell(m_hFile);
+		if (m_blocks[i].storedSize)
+			fwrite(&m_blockData[i][0], m_blocks[i].storedSize, 1, m_hFile);
+	}
+
+	hdr.blockTableOffset = (UINT32)ftell(m_hFile);
+	hdr.numBlocks = (UINT32)m_blocks.size();
+	if (hdr.numBlocks)
+		fwrite(&m_blocks[0], sizeof(SaveStateBinaryBlock), hdr.numBlocks, m_hFile);
+
+	fseek(m_hFile, 0, SEEK_SET);
+	fwrite(&hdr, sizeof(hdr), 1, m_hFile);
+}
+
 void YamlSaveHelper::FileHdr(UINT version)
 {
-	fprintf(m_hFile, "%s:\n", SS_YAML_KEY_FILEHDR);
+	m_indent = 0;
+	Save("%s:\n", SS_YAML_KEY_FILEHDR);
 	m_indent = 2;
 	SaveString(SS_YAML_KEY_TAG, SS_YAML_VALUE_AWSS);
 	SaveInt(SS_YAML_KEY_VERSION, version);
@@ -613,7 +881,8 @@ void YamlSaveHelper::FileHdr(UINT version)
 
 void YamlSaveHelper::UnitHdr(const std::string& type, UINT version)
 {
-	fprintf(m_hFile, "\n%s:\n", SS_YAML_KEY_UNIT);
+	m_indent = 0;
+	Save("\n%s:\n", SS_YAML_KEY_UNIT);
 	m_indent = 2;
 	SaveString(SS_YAML_KEY_TYPE, type.c_str());
 	SaveInt(SS_YAML_KEY_VERSION, version);
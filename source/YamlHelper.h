@@ -15,6 +15,76 @@
 
 #define SS_YAML_VALUE_AWSS "AppleWin Save State"
 
+#define SS_YAML_KEY_BINARY_BLOCK "Binary Block"
+
+// Binary save-state container (*.aws.bin):
+// . SaveStateBinaryHdr
+// . YAML text, as for a *.aws.yaml file, except that memory is saved as "Binary Block: <n>" instead of hex lines
+// . Memory blocks: each is raw or zlib-compressed
+// . Block table: SaveStateBinaryBlock[numBlocks]
+// NB. All fields are little-endian
+
+#define SS_BINARY_FILE_EXT ".aws.bin"
+#define SS_BINARY_MAGIC "AWSSBIN\x1A"
+#define SS_BINARY_VER 1
+
+struct SaveStateBinaryHdr
+{
+	char magic[8];				// SS_BINARY_MAGIC (not null terminated)
+	UINT32 version;
+	UINT32 yamlOffset;
+	UINT32 yamlSize;
+	UINT32 blockTableOffset;
+	UINT32 numBlocks;
+	UINT32 reserved;
+};
+
+struct SaveStateBinaryBlock
+{
+	UINT32 fileOffset;
+	UINT32 addr;				// Address of 1st byte (relative to the memory base)
+	UINT32 size;				// Uncompressed size
+	UINT32 storedSize;			// Compressed size, or == size if stored raw
+};
+
+bool IsBinarySaveStatePathname(const std::string& pathname);
+
+// In-memory save-state (eg. for rewind):
+// . Same as the binary container, except that each memory block is held as 256-byte pages
+// . When saving, a page that's unchanged from the previous snapshot's is shared (not copied)
+// . A buffer can be re-used (as an arena) for a new snapshot, to avoid reallocating its YAML text & block tables
+
+struct SaveStateMemoryPage
+{
+	BYTE data[256];
+};
+
+struct SaveStateMemoryBlock
+{
+	UINT32 addr;				// Address of 1st byte (relative to the memory base)
+	UINT32 size;
+	std::vector< std::shared_ptr<const SaveStateMemoryPage> > pages;
+};
+
+class SaveStateBuffer
+{
+public:
+	SaveStateBuffer(void) : m_numBlocks(0) {}
+	~SaveStateBuffer(void) {}
+
+	void Clear(void)
+	{
+		m_yaml.clear();
+		m_numBlocks = 0;
+	}
+
+	bool IsEmpty(void) const { return m_yaml.empty(); }
+
+	std::string m_yaml;
+	std::vector<SaveStateMemoryBlock> m_blocks;	// NB. Only the first m_numBlocks are valid
+	UINT m_numBlocks;
+};
+
 struct MapValue;
 typedef std::map<std::string, MapValue> MapYaml;
 
@@ -30,7 +100,8 @@ friend class YamlLoadHelper;	// YamlLoadHelper can access YamlHelper's private m
 
 public:
 	YamlHelper(void) :
-		m_hFile(NULL)
+		m_hFile(NULL),
+		m_pBuffer(NULL)
 	{
 		memset(&m_parser, 0, sizeof(m_parser));
 		memset(&m_newEvent, 0, sizeof(m_newEvent));
@@ -43,6 +114,7 @@ public:
 	}
 
 	int InitParser(const char* pPathname);
+	int InitParser(const SaveStateBuffer& buffer);
 	void FinaliseParser(void);
 
 	UINT ParseFileHdr(const char* tag);
@@ -60,6 +132,9 @@ private:
 
 	void MakeAsciiToHexTable(void);
 
+	bool InitBinaryContainer(void);
+	UINT LoadMemoryBlock(const std::string& value, const LPBYTE pMemBase, const size_t kAddrSpaceSize, const UINT offset);
+
 	yaml_parser_t m_parser;
 	yaml_event_t m_newEvent;
 
@@ -69,6 +144,13 @@ private:
 	char m_AsciiToHex[256];
 
 	MapYaml m_mapYaml;
+
+	// Binary container only
+	std::string m_binaryYaml;
+	std::vector<SaveStateBinaryBlock> m_binaryBlocks;
+
+	// In-memory save-state only
+	const SaveStateBuffer* m_pBuffer;
 };
 
 // -----
@@ -108,6 +190,8 @@ public:
 	void LoadMemory(const LPBYTE pMemBase, const size_t size, const UINT offset=0);
 	void LoadMemory(std::vector<BYTE>& memory, const size_t size, const UINT offset=0);
 
+	bool IsLoadingFromMemory(void) { return m_yamlHelper.m_pBuffer != NULL; }	// eg. a rewind snapshot: restore in place (don't eject & re-insert media)
+
 	bool GetSubMap(const std::string & key, const bool canBeNull=false)
 	{
 		YamlStackItem item = {m_pMapYaml, m_currentMapName};
@@ -175,15 +259,18 @@ private:
 class YamlSaveHelper
 {
 public:
-	YamlSaveHelper(const std::string & pathname) :
+	YamlSaveHelper(const std::string & pathname, const bool binary=false) :
 		m_hFile(NULL),
 		m_indent(0),
 		m_pWcStr(NULL),
 		m_wcStrSize(0),
 		m_pMbStr(NULL),
-		m_mbStrSize(0)
+		m_mbStrSize(0),
+		m_binary(binary),
+		m_pBuffer(NULL),
+		m_pPrevBuffer(NULL)
 	{
-		m_hFile = fopen(pathname.c_str(), "wt");
+		m_hFile = fopen(pathname.c_str(), binary ? "wb" : "wt");
 
 		// todo: handle ERROR_ALREADY_EXISTS - ask if user wants to replace existing file
 		// - at this point any old file will have been truncated to zero
@@ -191,6 +278,12 @@ public:
 		if(m_hFile == NULL)
 			throw std::runtime_error("Save error");
 
+		if (m_binary)
+		{
+			SaveStateBinaryHdr hdr = {};	// Placeholder: written for real by FinaliseBinaryContainer()
+			fwrite(&hdr, sizeof(hdr), 1, m_hFile);
+		}
+
 		_tzset();
 		time_t ltime;
 		time(&ltime);
@@ -205,13 +298,37 @@ public:
 		memset(m_szIndent, ' ', kMaxIndent);
 	}
 
+	// In-memory save-state: pPrevBuffer (optional) is the previous snapshot, to share unchanged memory pages with
+	YamlSaveHelper(SaveStateBuffer& buffer, const SaveStateBuffer* pPrevBuffer=NULL) :
+		m_hFile(NULL),
+		m_indent(0),
+		m_pWcStr(NULL),
+		m_wcStrSize(0),
+		m_pMbStr(NULL),
+		m_mbStrSize(0),
+		m_binary(true),
+		m_pBuffer(&buffer),
+		m_pPrevBuffer(pPrevBuffer)
+	{
+		m_pBuffer->Clear();
+		m_pBuffer->m_yaml += "---\n";
+
+		memset(m_szIndent, ' ', kMaxIndent);
+	}
+
 	~YamlSaveHelper()
 	{
 		if (m_hFile)
 		{
 			fprintf(m_hFile, "...\n");
+			if (m_binary)
+				FinaliseBinaryContainer();
 			fclose(m_hFile);
 		}
+		else if (m_pBuffer)
+		{
+			m_pBuffer->m_yaml += "...\n";
+		}
 
 		delete[] m_pWcStr;
 		delete[] m_pMbStr;
@@ -241,11 +358,11 @@ public:
 		Label(YamlSaveHelper& rYamlSaveHelper, const char* format, ...)  ATTRIBUTE_FORMAT_PRINTF(3, 4) :  // 1 is "this"
 			yamlSaveHelper(rYamlSaveHelper)
 		{
-			fwrite(yamlSaveHelper.m_szIndent, 1, yamlSaveHelper.m_indent, yamlSaveHelper.m_hFile);
+			yamlSaveHelper.Write(yamlSaveHelper.m_szIndent, yamlSaveHelper.m_indent);
 
 			va_list vl;
 			va_start(vl, format);
-			vfprintf(yamlSaveHelper.m_hFile, format, vl);
+			yamlSaveHelper.WriteV(format, vl);
 			va_end(vl);
 
 			yamlSaveHelper.m_indent += 2;
@@ -277,7 +394,15 @@ public:
 	void FileHdr(UINT version);
 	void UnitHdr(const std::string & type, UINT version);
 
+	bool IsSavingToMemory(void) { return m_pBuffer != NULL; }	// eg. a rewind snapshot
+
 private:
+	void Write(const char* pData, const size_t size);
+	void WriteV(const char* format, va_list vl);
+	void SaveMemoryBlock(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset);
+	void SaveMemoryPages(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset);
+	void FinaliseBinaryContainer(void);
+
 	FILE* m_hFile;
 
 	int m_indent;
@@ -288,4 +413,13 @@ private:
 	int m_wcStrSize;
 	LPSTR m_pMbStr;
 	int m_mbStrSize;
+
+	// Binary container only: memory blocks are held until the YAML text is complete
+	bool m_binary;
+	std::vector<SaveStateBinaryBlock> m_blocks;
+	std::vector< std::vector<BYTE> > m_blockData;
+
+	// In-memory save-state only
+	SaveStateBuffer* m_pBuffer;
+	const SaveStateBuffer* m_pPrevBuffer;
 };
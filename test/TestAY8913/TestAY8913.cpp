@@ -0,0 +1,202 @@
+#include "stdafx.h"
+
+#include "../../source/StdAfx.h"
+#include "../../source/Common.h"
+#include "../../source/AY8910.h"
+#include "../../source/YamlHelper.h"
+
+// From Core.cpp
+double g_fCurrentCLK6502 = CLK_6502_NTSC;
+
+// From StrFormat.cpp
+std::string StrFormat(const char* format, ...) { return ""; }
+
+// From YamlHelper.cpp (save-states aren't tested)
+bool YamlHelper::GetSubMap(MapYaml** mapYaml, const std::string &key, const bool canBeNull) { return false; }
+std::string YamlLoadHelper::LoadString_NoThrow(const std::string& key, bool& bFound) { bFound = false; return ""; }
+UINT YamlLoadHelper::LoadUint(const std::string key) { return 0; }
+void YamlSaveHelper::Save(const char* format, ...) {}
+void YamlSaveHelper::SaveUint(const char* key, UINT value) {}
+void YamlSaveHelper::SaveHexUint4(const char* key, UINT value) {}
+void YamlSaveHelper::SaveHexUint8(const char* key, UINT value) {}
+void YamlSaveHelper::SaveHexUint12(const char* key, UINT value) {}
+void YamlSaveHelper::SaveHexUint16(const char* key, UINT value) {}
+void YamlSaveHelper::Write(const char* pData, const size_t size) {}
+void YamlSaveHelper::WriteV(const char* format, va_list vl) {}
+
+//-------------------------------------
+
+// NB. Not rand(), as the register writes (and so the rendered output) must be the same for every C runtime
+static uint32_t g_rand = 1;
+
+static uint32_t Rand32(void)
+{
+	g_rand ^= g_rand << 13;
+	g_rand ^= g_rand >> 17;
+	g_rand ^= g_rand << 5;
+	return g_rand;
+}
+
+static uint32_t HashSamples(uint32_t hash, const INT16* pSamples, const UINT num)
+{
+	for (UINT i = 0; i < num; i++)
+	{
+		hash = (hash ^ (BYTE)pSamples[i]) * 16777619;			// FNV-1a
+		hash = (hash ^ (BYTE)(pSamples[i] >> 8)) * 16777619;
+	}
+	return hash;
+}
+
+static const UINT kMaxFrameSize = 1600;
+static INT16 g_soundBuffer[3][kMaxFrameSize];
+
+// A frame of random AY register writes at increasing cycle offsets, biased towards:
+// . volumes of 0 and envelope mode (eg. silent channels & envelope sample playback)
+// . tone & noise disabled in the mixer (ie. the volume is output directly)
+static void WriteRandomRegs(AY8913& ay, const UINT frameCycles)
+{
+	const UINT numWrites = Rand32() % 12;
+	UINT cycle = 0;
+
+	for (UINT i = 0; i < numWrites; i++)
+	{
+		cycle += Rand32() % (frameCycles / (numWrites + 1));
+
+		const int reg = Rand32() % 14;
+		int val = Rand32() & 0xff;
+		if (reg >= 8 && reg <= 10 && (Rand32() & 3) == 0)
+			val &= 0x10;
+		else if (reg == 7 && (Rand32() & 3) == 0)
+			val = 0x3f;
+
+		ay.sound_ay_write(reg, val, cycle);
+	}
+}
+
+// Render frames of random register writes into 3 channels, and return a hash of all the samples
+static uint32_t RenderFrames(AY8913& ay, const UINT numFrames)
+{
+	INT16* pSoundBuffers[3] = { g_soundBuffer[0], g_soundBuffer[1], g_soundBuffer[2] };
+	uint32_t hash = 2166136261;
+
+	for (UINT frame = 0; frame < numFrames; frame++)
+	{
+		const UINT frameSize = 100 + Rand32() % (kMaxFrameSize - 100);
+		const UINT frameCycles = (UINT)(frameSize * CLK_6502_NTSC / SPKR_SAMPLE_RATE);
+
+		WriteRandomRegs(ay, frameCycles);
+
+		ay.SetFramesize(frameSize);
+		ay.SetSoundBuffers(pSoundBuffers);
+		ay.sound_frame();
+
+		for (UINT ch = 0; ch < 3; ch++)
+			hash = HashSamples(hash, g_soundBuffer[ch], frameSize);
+	}
+
+	return hash;
+}
+
+//-------------------------------------
+
+// sound_frame() renders in blocks between register writes (rather than per sample), and this must not change the output:
+// . the hash is of the output of the original per sample sound_ay_overlay() for the same register writes
+
+int RenderBlocks_test(void)
+{
+	const UINT kNumFrames = 3000;
+	const uint32_t kExpectedHash = 0xF928B2E0;
+
+	g_rand = 1;
+
+	AY8913 ay;
+	AY8913::SetCLK(CLK_6502_NTSC);
+	ay.sound_init(NULL);
+	ay.sound_ay_reset();
+
+	if (RenderFrames(ay, kNumFrames) != kExpectedHash)
+		return 1;
+
+	return 0;
+}
+
+//-------------------------------------
+
+// If IsSilent() then the next sound_frame() must only output 0's (as the Mockingboard skips it)
+// . frames are silenced with a volume of 0, or an envelope that decays to 0 and holds
+
+int IsSilent_test(void)
+{
+	const UINT kNumFrames = 20000;
+	INT16* pSoundBuffers[3] = { g_soundBuffer[0], g_soundBuffer[1], g_soundBuffer[2] };
+	UINT numSilentFrames = 0;
+
+	g_rand = 1;
+
+	AY8913 ay;
+	AY8913::SetCLK(CLK_6502_NTSC);
+	ay.sound_init(NULL);
+	ay.sound_ay_reset();
+
+	for (UINT frame = 0; frame < kNumFrames; frame++)
+	{
+		const UINT frameSize = 100 + Rand32() % (kMaxFrameSize - 100);
+		const UINT frameCycles = (UINT)(frameSize * CLK_6502_NTSC / SPKR_SAMPLE_RATE);
+
+		if ((Rand32() & 7) == 0)
+		{
+			const bool useEnvelope = (Rand32() & 1) != 0;
+			if (useEnvelope)
+			{
+				ay.sound_ay_write(11, Rand32() & 0xff, 0);
+				ay.sound_ay_write(12, 0, 0);
+				ay.sound_ay_write(13, Rand32() & 3, 0);	// decay, then hold at 0
+			}
+			for (int reg = 8; reg <= 10; reg++)
+				ay.sound_ay_write(reg, useEnvelope ? 0x10 : 0, 0);
+		}
+		else if ((Rand32() & 3) == 0)
+		{
+			WriteRandomRegs(ay, frameCycles);
+		}
+
+		const bool isSilent = ay.IsSilent();
+
+		ay.SetFramesize(frameSize);
+		ay.SetSoundBuffers(pSoundBuffers);
+		ay.sound_frame();
+
+		if (!isSilent)
+			continue;
+
+		numSilentFrames++;
+		for (UINT ch = 0; ch < 3; ch++)
+		{
+			for (UINT i = 0; i < frameSize; i++)
+			{
+				if (g_soundBuffer[ch][i])
+					return 1;
+			}
+		}
+	}
+
+	if (numSilentFrames == 0)
+		return 1;
+
+	return 0;
+}
+
+//-------------------------------------
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	int res = 1;
+
+	res = RenderBlocks_test();
+	if (res) return res;
+
+	res = IsSilent_test();
+	if (res) return res;
+
+	return 0;
+}
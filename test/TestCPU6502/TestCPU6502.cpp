@@ -11,9 +11,10 @@ enum AppMode_e g_nAppMode = MODE_RUNNING;
 SynchronousEventManager g_SynchronousEventMgr;
 
 // From Memory.cpp
+LPBYTE         memread[0x100];		// TODO: Init
 LPBYTE         memwrite[0x100];		// TODO: Init
+BYTE           memWriteSink[0x100];
 LPBYTE         mem          = NULL;	// TODO: Init
-LPBYTE         memdirty     = NULL;	// TODO: Init
 LPBYTE         memVidHD     = NULL;	// TODO: Init
 iofunction		IORead[256] = {0};	// TODO: Init
 iofunction		IOWrite[256] = {0};	// TODO: Init
@@ -23,6 +24,11 @@ BYTE __stdcall IO_F8xx(WORD programcounter, WORD address, BYTE write, BYTE value
 	return 0;
 }
 
+LPBYTE MemWriteTrap(const WORD addr)
+{
+	return NULL;
+}
+
 regsrec regs;
 
 bool g_irqOnLastOpcodeCycle = false;
@@ -69,6 +75,11 @@ static __forceinline bool IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 	return false;
 }
 
+static __forceinline bool IsInterruptOrZ80Pending(void)
+{
+	return GetActiveCpu() == CPU_Z80;
+}
+
 // From z80.cpp
 DWORD z80_mainloop(ULONG uTotalCycles, ULONG uExecutedCycles)
 {
@@ -113,9 +124,10 @@ void init(void)
 	mem = (LPBYTE)calloc(64, 1024);
 
 	for (UINT i=0; i<256; i++)
+	{
+		memread[i] = mem+i*256;
 		memwrite[i] = mem+i*256;
-
-	memdirty = new BYTE[256];
+	}
 }
 
 void reset(void)
@@ -41,7 +41,10 @@ eCpuType GetMainCpu(void)
 
 // From Memory.cpp
 LPBYTE         mem          = NULL;	// TODO: Init
-LPBYTE         memdirty     = NULL;	// TODO: Init
+
+void MemSetDirty(const WORD addr)
+{
+}
 
 //-------------------------------------
 
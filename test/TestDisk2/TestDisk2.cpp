@@ -0,0 +1,332 @@
+#include "stdafx.h"
+
+// Disk.cpp is included (rather than linked) so that the card's private LSS read functions & state can be tested directly
+#define private public
+#include "../../source/Disk.cpp"
+#undef private
+
+// From Card.cpp
+void Card::ThrowErrorInvalidSlot() { throw std::runtime_error("invalid slot"); }
+void Card::ThrowErrorInvalidVersion(UINT version) { throw std::runtime_error("invalid version"); }
+
+// From Core.cpp
+std::string g_pAppTitle;
+AppMode_e g_nAppMode = MODE_RUNNING;
+
+CardManager& GetCardMgr(void)
+{
+	_ASSERT(0);	// Not used by these tests (only by disk image I/O & the sync event callback)
+	return *(CardManager*)NULL;
+}
+
+SynchronousEventManager& GetSynchronousEventMgr(void)
+{
+	static SynchronousEventManager syncEventMgr;
+	return syncEventMgr;
+}
+
+// From CPU.cpp
+regsrec regs;
+unsigned __int64 g_nCumulativeCycles = 0;
+
+void CpuCalcCycles(ULONG nExecutedCycles) {}
+void SetIrqOnLastOpcodeCycle(void) {}
+
+// From DiskFormatTrack.cpp
+static std::vector<BYTE> g_nibblesRead;
+
+void FormatTrack::Reset(void) {}
+void FormatTrack::DriveNotWritingTrack(void) {}
+void FormatTrack::DriveSwitchedToReadMode(class FloppyDisk* const pFloppy) {}
+void FormatTrack::DriveSwitchedToWriteMode(UINT uTrackIndex) {}
+void FormatTrack::DecodeLatchNibbleRead(BYTE floppylatch) { g_nibblesRead.push_back(floppylatch); }
+void FormatTrack::DecodeLatchNibbleWrite(BYTE floppylatch, UINT uSpinNibbleCount, const class FloppyDisk* const pFloppy, bool bIsSyncFF) {}
+void FormatTrack::SaveSnapshot(class YamlSaveHelper& yamlSaveHelper) {}
+void FormatTrack::LoadSnapshot(class YamlLoadHelper& yamlLoadHelper) {}
+
+// From DiskImage.cpp (no disk images are opened by these tests)
+static BYTE g_optimalBitTiming = 32;
+
+ImageError_e ImageOpen(const std::string & pszImageFilename, ImageInfo** ppImageInfo, bool* pWriteProtected, const bool bCreateIfNecessary, std::string& strFilenameInZip, const bool bExpectFloppy) { return eIMAGE_ERROR_UNABLE_TO_OPEN; }
+void ImageClose(ImageInfo* const pImageInfo) {}
+BOOL ImageBoot(ImageInfo* const pImageInfo) { return FALSE; }
+void ImageReadTrack(ImageInfo* const pImageInfo, float phase, LPBYTE pTrackImageBuffer, int* pNibbles, UINT* pBitCount, bool enhanceDisk) {}
+void ImageWriteTrack(ImageInfo* const pImageInfo, float phase, LPBYTE pTrackImageBuffer, int nNibbles) {}
+bool ImageReadSector(ImageInfo* const pImageInfo, const UINT track, const UINT physicalSector, LPBYTE pSectorBuffer) { return false; }
+BYTE ImageGetVolumeNumber(ImageInfo* const pImageInfo) { return 0; }
+bool ImageFlush(ImageInfo* const pImageInfo, const bool bIdleOnly) { return true; }
+bool ImageIsOverlayEnabled(void) { return false; }
+UINT ImageGetNumTracks(ImageInfo* const pImageInfo) { return 0; }
+bool ImageIsMultiFileZip(ImageInfo* const pImageInfo) { return false; }
+const std::string & ImageGetPathname(ImageInfo* const pImageInfo) { static const std::string pathname; return pathname; }
+bool ImageIsWOZ(ImageInfo* const pImageInfo) { return true; }
+BYTE ImageGetOptimalBitTiming(ImageInfo* const pImageInfo) { return g_optimalBitTiming; }
+UINT ImagePhaseToTrack(ImageInfo* const pImageInfo, const float phase, const bool limit) { return 0; }
+UINT ImageGetMaxNibblesPerTrack(ImageInfo* const pImageInfo) { return NIBBLES_PER_TRACK; }
+bool ImageIsBootSectorFormatSector13(ImageInfo* const pImageInfo) { return false; }
+void GetImageTitle(LPCTSTR pPathname, std::string & pImageName, std::string & pFullName) {}
+
+// From FrameBase.cpp
+void FrameBase::Video_ResetScreenshotCounter(const std::string& pDiskImageFileName) {}
+
+// From AppleWin.cpp
+FrameBase& GetFrame(void)
+{
+	_ASSERT(0);	// Not used by these tests (only by the disk status & image dialogs)
+	return *(FrameBase*)NULL;
+}
+
+// From Log.cpp
+void LogOutput(const char* format, ...) {}
+void LogFileOutput(const char* format, ...) {}
+
+// From Memory.cpp
+void RegisterIoHandler(UINT uSlot, iofunction IOReadC0, iofunction IOWriteC0, iofunction IOReadCx, iofunction IOWriteCx, LPVOID lpSlotParameter, BYTE* pExpansionRom) {}
+LPBYTE GetCxRomPeripheral(void) { return NULL; }
+BYTE MemReadFloatingBus(const ULONG uExecutedCycles) { return 0; }
+LPVOID MemGetSlotParameters(UINT uSlot) { return NULL; }
+
+// From Registry.cpp
+BOOL RegLoadString(LPCTSTR section, LPCTSTR key, BOOL peruser, LPTSTR buffer, DWORD chars, LPCTSTR defaultValue) { return FALSE; }
+void RegSaveString(LPCTSTR section, LPCTSTR key, BOOL peruser, const std::string & buffer) {}
+void RegSaveValue(LPCTSTR section, LPCTSTR key, BOOL peruser, DWORD value) {}
+std::string RegGetConfigSlotSection(UINT slot) { return ""; }
+
+// From SaveState.cpp
+void Snapshot_UpdatePath(void) {}
+
+// From StrFormat.cpp
+std::string StrFormat(const char* format, ...) { return ""; }
+
+// From YamlHelper.cpp (save-states aren't tested)
+bool YamlHelper::GetSubMap(MapYaml** mapYaml, const std::string &key, const bool canBeNull) { return false; }
+INT YamlLoadHelper::LoadInt(const std::string key) { return 0; }
+UINT YamlLoadHelper::LoadUint(const std::string key) { return 0; }
+UINT64 YamlLoadHelper::LoadUint64(const std::string key) { return 0; }
+bool YamlLoadHelper::LoadBool(const std::string key) { return false; }
+std::string YamlLoadHelper::LoadString(const std::string& key) { return ""; }
+float YamlLoadHelper::LoadFloat(const std::string & key) { return 0; }
+double YamlLoadHelper::LoadDouble(const std::string & key) { return 0; }
+void YamlLoadHelper::LoadMemory(std::vector<BYTE>& memory, const size_t size, const UINT offset) {}
+void YamlSaveHelper::Save(const char* format, ...) {}
+void YamlSaveHelper::SaveInt(const char* key, int value) {}
+void YamlSaveHelper::SaveUint(const char* key, UINT value) {}
+void YamlSaveHelper::SaveHexUint4(const char* key, UINT value) {}
+void YamlSaveHelper::SaveHexUint8(const char* key, UINT value) {}
+void YamlSaveHelper::SaveHexUint16(const char* key, UINT value) {}
+void YamlSaveHelper::SaveHexUint32(const char* key, UINT value) {}
+void YamlSaveHelper::SaveHexUint64(const char* key, UINT64 value) {}
+void YamlSaveHelper::SaveBool(const char* key, bool value) {}
+void YamlSaveHelper::SaveString(const char* key, const std::string & value) {}
+void YamlSaveHelper::SaveFloat(const char* key, float value) {}
+void YamlSaveHelper::SaveDouble(const char* key, double value) {}
+void YamlSaveHelper::SaveMemory(const LPBYTE pMemBase, const UINT uMemSize, const UINT offset) {}
+void YamlSaveHelper::Write(const char* pData, const size_t size) {}
+void YamlSaveHelper::WriteV(const char* format, va_list vl) {}
+
+//-------------------------------------
+
+static uint32_t Rand32(void)
+{
+	return ((uint32_t)rand() << 16) ^ ((uint32_t)rand() << 8) ^ (uint32_t)rand();
+}
+
+//-------------------------------------
+
+struct WOZReadState
+{
+	UINT bitCount;
+	UINT bitOffset;
+	UINT initialBitOffset;
+	UINT longestSyncFFRunLength;
+	int longestSyncFFBitOffsetStart;
+	float phasePrecise;
+	BYTE headWindow;
+	UINT32 weakBitRand;
+	BYTE shiftReg;
+	int latchDelay;
+	BYTE floppyLatch;
+};
+
+static void SetupCardWOZ(Disk2InterfaceCard& card, const std::vector<BYTE>& track, const WOZReadState& state)
+{
+	FloppyDrive& drive = card.m_floppyDrive[DRIVE_1];
+	FloppyDisk& floppy = drive.m_disk;
+
+	card.m_currDrive = DRIVE_1;
+
+	floppy.m_trackimage = new BYTE[track.size()];	// deleted by ~Disk2InterfaceCard()
+	memcpy(floppy.m_trackimage, &track[0], track.size());
+	floppy.m_trackimagedata = true;
+	floppy.m_bitCount = state.bitCount;
+	floppy.m_bitOffset = state.bitOffset;
+	floppy.m_initialBitOffset = state.initialBitOffset;
+	floppy.m_longestSyncFFRunLength = state.longestSyncFFRunLength;
+	floppy.m_longestSyncFFBitOffsetStart = state.longestSyncFFBitOffsetStart;
+	card.UpdateBitStreamOffsets(floppy);
+
+	drive.m_phasePrecise = state.phasePrecise;
+	drive.m_headWindow = state.headWindow;
+	drive.m_weakBitRand = state.weakBitRand;
+
+	card.m_shiftReg = state.shiftReg;
+	card.m_latchDelay = state.latchDelay;
+	card.m_floppyLatch = state.floppyLatch;
+	card.m_dbgLatchDelayedCnt = 0;
+}
+
+static bool IsSameStateWOZ(Disk2InterfaceCard& card1, Disk2InterfaceCard& card2)
+{
+	const FloppyDrive& drive1 = card1.m_floppyDrive[DRIVE_1];
+	const FloppyDrive& drive2 = card2.m_floppyDrive[DRIVE_1];
+	const FloppyDisk& floppy1 = drive1.m_disk;
+	const FloppyDisk& floppy2 = drive2.m_disk;
+
+	return card1.m_floppyLatch == card2.m_floppyLatch
+		&& card1.m_shiftReg == card2.m_shiftReg
+		&& card1.m_latchDelay == card2.m_latchDelay
+		&& card1.m_dbgLatchDelayedCnt == card2.m_dbgLatchDelayedCnt
+		&& drive1.m_headWindow == drive2.m_headWindow
+		&& drive1.m_weakBitRand == drive2.m_weakBitRand
+		&& floppy1.m_bitOffset == floppy2.m_bitOffset
+		&& floppy1.m_byte == floppy2.m_byte
+		&& floppy1.m_bitMask == floppy2.m_bitMask
+		&& floppy1.m_revs == floppy2.m_revs;
+}
+
+// DataLatchReadWOZ() for N bit-cells (which uses the nibble-at-a-time DataLatchReadBitCellsWOZ() where it can)
+// must be identical to N calls of DataLatchReadWOZ() for 1 bit-cell (which always uses the per bit-cell loop)
+// . random tracks with weak bit (zero) runs, track wraps, m_revs bumps & track seam jitter
+// . all latch delays, including ones not produced by DataLatchReadWOZ() (eg. from an old save-state)
+// . the same nibbles must be passed to FormatTrack::DecodeLatchNibbleRead()
+
+int DataLatchReadWOZ_test(void)
+{
+	const UINT kNumTracks = 100;
+	const UINT kNumReadsPerTrack = 200;
+
+	srand(1);
+
+	for (UINT t = 0; t < kNumTracks; t++)
+	{
+		WOZReadState state;
+		state.bitCount = 8 + Rand32() % (8 * NIBBLES_PER_TRACK);
+		state.bitOffset = Rand32() % state.bitCount;
+		state.initialBitOffset = Rand32() % state.bitCount;
+		state.longestSyncFFRunLength = (t & 1) ? 111 + Rand32() % 200 : Rand32() % 111;
+		state.longestSyncFFBitOffsetStart = (int)(Rand32() % state.bitCount);
+		state.phasePrecise = (float)(Rand32() % (40 * 4)) / 2;	// half phases, either side of track 33.0
+		state.headWindow = (BYTE)Rand32();
+		state.weakBitRand = Rand32() | 1;
+		state.shiftReg = (BYTE)Rand32();
+		state.latchDelay = Rand32() % 8;
+		state.floppyLatch = (BYTE)Rand32();
+
+		std::vector<BYTE> track((state.bitCount + 7) / 8);
+		for (UINT i = 0; i < track.size(); i++)
+			track[i] = (BYTE)Rand32();
+
+		// Weak bit runs: at least 4 consecutive zero bit-cells
+		const UINT numWeakRuns = Rand32() % 8;
+		for (UINT i = 0; i < numWeakRuns; i++)
+		{
+			const UINT start = Rand32() % track.size();
+			const UINT length = 1 + Rand32() % 32;
+			memset(&track[start], 0, MIN(length, track.size() - start));
+		}
+
+		std::vector<UINT> bitCellReads(kNumReadsPerTrack);
+		for (UINT i = 0; i < kNumReadsPerTrack; i++)
+			bitCellReads[i] = (Rand32() & 15) ? Rand32() % 64 : Rand32() % (2 * state.bitCount);
+
+		const unsigned int jitterSeed = Rand32();
+
+		Disk2InterfaceCard card1(SLOT6);	// reference: per bit-cell
+		Disk2InterfaceCard card2(SLOT6);	// nibble-at-a-time
+		SetupCardWOZ(card1, track, state);
+		SetupCardWOZ(card2, track, state);
+
+		// NB. AddTrackSeamJitter() uses rand(), so give each card the same sequence
+		for (UINT i = 0; i < kNumReadsPerTrack; i++)
+		{
+			g_nibblesRead.clear();
+			srand(jitterSeed + i);
+			for (UINT n = 0; n < bitCellReads[i]; n++)
+				card1.DataLatchReadWOZ(0, 0, 1);
+			const std::vector<BYTE> nibblesRead1 = g_nibblesRead;
+
+			g_nibblesRead.clear();
+			srand(jitterSeed + i);
+			card2.DataLatchReadWOZ(0, 0, bitCellReads[i]);
+
+			if (!IsSameStateWOZ(card1, card2) || g_nibblesRead != nibblesRead1)
+				return 1;
+		}
+	}
+
+	return 0;
+}
+
+//-------------------------------------
+
+// GetBitCellDelta()'s integer 1/8 cycle arithmetic must match the original double arithmetic (for every optimalBitTiming):
+// . the bit-cell count for each call
+// . the carried remainder, ie. m_extraCycles8/8 == the original m_extraCycles (in cycles)
+
+int GetBitCellDelta_test(void)
+{
+	const UINT kNumDeltas = 2000;
+
+	srand(1);
+
+	for (UINT optimalBitTiming = 1; optimalBitTiming < 256; optimalBitTiming++)
+	{
+		g_optimalBitTiming = (BYTE)optimalBitTiming;
+		g_nCumulativeCycles = 0;
+
+		Disk2InterfaceCard card(SLOT6);
+		const FloppyDisk& floppy = card.m_floppyDrive[card.m_currDrive].m_disk;
+
+		double extraCycles = 0.0;	// the original FloppyDisk::m_extraCycles
+		UINT64 lastCycle = 0;
+
+		for (UINT i = 0; i < kNumDeltas; i++)
+		{
+			// Mostly short deltas (eg. consecutive disk I/O accesses), with some long ones (up to ~10s worth of cycles)
+			const UINT delta = (Rand32() & 7) ? Rand32() % 64 : Rand32() % 10000000;
+			g_nCumulativeCycles += delta;
+
+			// Original double arithmetic
+			const double cycleDelta = (double)(g_nCumulativeCycles - lastCycle) + extraCycles;
+			const double bitTime = 0.125 * (double)optimalBitTiming;	// 125ns units
+			const UINT bitCellDelta = (UINT) floor( cycleDelta / bitTime );
+			extraCycles = (double)cycleDelta - ((double)bitCellDelta * bitTime);
+			lastCycle = g_nCumulativeCycles;
+
+			if (card.GetBitCellDelta(0) != bitCellDelta)
+				return 1;
+
+			if (floppy.m_extraCycles8 / 8.0 != extraCycles)
+				return 1;
+		}
+	}
+
+	g_optimalBitTiming = 32;
+
+	return 0;
+}
+
+//-------------------------------------
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	int res = 1;
+
+	res = DataLatchReadWOZ_test();
+	if (res) return res;
+
+	res = GetBitCellDelta_test();
+	if (res) return res;
+
+	return 0;
+}
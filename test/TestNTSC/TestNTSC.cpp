@@ -0,0 +1,363 @@
+#include "stdafx.h"
+
+// NTSC.cpp is included (rather than linked) so that its static renderer functions & state can be tested directly
+#include "../../source/NTSC.cpp"
+
+// From Core.cpp
+bool g_bFullSpeed = false;
+eApple2Type g_Apple2Type = A2TYPE_APPLE2EENHANCED;
+
+eApple2Type GetApple2Type(void)
+{
+	return g_Apple2Type;
+}
+
+void SetApple2Type(eApple2Type type)
+{
+	g_Apple2Type = type;
+}
+
+// From CPU.cpp
+UINT CpuGetCyclesThisVideoFrame(const UINT nExecutedCycles)
+{
+	return nExecutedCycles;
+}
+
+// From Debugger
+void ResetCyclesExecutedForDebugger(void)
+{
+}
+
+// From Log.cpp
+void LogOutput(const char* format, ...)
+{
+}
+
+// From Memory.cpp
+static BYTE g_memMain[0x10000];
+static BYTE g_memAux[0x10000];
+
+LPBYTE MemGetMainPtr(const WORD offset)
+{
+	return &g_memMain[offset];
+}
+
+LPBYTE MemGetAuxPtr(const WORD offset)
+{
+	return &g_memAux[offset];
+}
+
+bool MemGetAnnunciator(UINT annunciator)
+{
+	return false;
+}
+
+// From NTSC_CharSet.cpp
+unsigned char csbits_enhanced2e[2][256][8];
+unsigned char csbits_a2[1][256][8];
+unsigned char csbits_a2j[2][256][8];
+unsigned char csbits_pravets82[1][256][8];
+unsigned char csbits_pravets8M[1][256][8];
+unsigned char csbits_pravets8C[2][256][8];
+unsigned char csbits_base64a[2][256][8];
+
+void make_csbits(void)
+{
+}
+
+csbits_t Get2e_csbits(void)
+{
+	return csbits_enhanced2e;
+}
+
+// From RGBMonitor.cpp (the RGB video types aren't tested)
+void UpdateHiResCell(int x, int y, uint16_t addr, bgra_t* pVideoAddress) {}
+void UpdateDHiResCell(int x, int y, uint16_t addr, bgra_t* pVideoAddress, bool updateAux, bool updateMain) {}
+void UpdateDHiResCellRGB(int x, int y, uint16_t addr, bgra_t* pVideoAddress, bool isMixMode, bool isBit7Inversed) {}
+int UpdateDHiRes160Cell(int x, int y, uint16_t addr, bgra_t* pVideoAddress) { return 0; }
+void UpdateLoResCell(int x, int y, uint16_t addr, bgra_t* pVideoAddress) {}
+void UpdateDLoResCell(int x, int y, uint16_t addr, bgra_t* pVideoAddress) {}
+void UpdateText40ColorCell(int x, int y, uint16_t addr, bgra_t* pVideoAddress, uint8_t bits, uint8_t character) {}
+void UpdateText80ColorCell(int x, int y, uint16_t addr, bgra_t* pVideoAddress, uint8_t bits, uint8_t character) {}
+void UpdateHiResRGBCell(int x, int y, uint16_t addr, bgra_t* pVideoAddress) {}
+void UpdateHiResDuochromeCell(int x, int y, uint16_t addr, bgra_t* pVideoAddress) {}
+void VideoInitializeOriginal(baseColors_t pBaseNtscColors) {}
+bool RGB_Is160Mode(void) { return false; }
+bool RGB_Is560Mode(void) { return false; }
+bool RGB_IsMixMode(void) { return false; }
+bool RGB_IsMixModeInvertBit7(void) { return false; }
+void RGB_EnableTextFB(void) {}
+void RGB_DisableTextFB(void) {}
+RGB_Videocard_e RGB_GetVideocard(void) { return RGB_Videocard_e::Apple; }
+
+// From VidHD.cpp
+void VidHDCard::UpdateSHRCell(bool is640Mode, bool isColorFillMode, uint16_t addrPalette, bgra_t* pVideoAddress, uint32_t a) {}
+
+// From Video.cpp
+static const UINT kFrameBufferWidth = 600;
+static const UINT kFrameBufferHeight = 420;
+static uint32_t g_frameBuffer[kFrameBufferWidth * kFrameBufferHeight];
+
+static uint32_t g_videoMode = VF_TEXT;
+static VideoType_e g_videoType = VT_COLOR_TV;
+static VideoStyle_e g_videoStyle = VS_HALF_SCANLINES;
+
+static Video g_video;
+
+Video& GetVideo(void)
+{
+	return g_video;
+}
+
+void Video::Initialize(uint8_t* frameBuffer, bool resetState) { SetFrameBuffer(frameBuffer); }
+UINT Video::GetFrameBufferBorderWidth(void) { return (kFrameBufferWidth - 560) / 2; }
+UINT Video::GetFrameBufferBorderHeight(void) { return (kFrameBufferHeight - 384) / 2; }
+UINT Video::GetFrameBufferWidth(void) { return kFrameBufferWidth; }
+UINT Video::GetFrameBufferHeight(void) { return kFrameBufferHeight; }
+int Video::GetFrameBufferCentringValue(void) { return 0; }
+void Video::ClearFrameBuffer(void) { memset(g_frameBuffer, 0, sizeof(g_frameBuffer)); NTSC_InvalidateScanlineCache(); }
+WORD Video::VideoGetScannerAddress(DWORD nCycles, VideoScanner_e videoScannerAddr) { return 0; }
+bool Video::VideoGetSWAltCharSet(void) { return false; }
+bool Video::GetVideoRomRockerSwitch(void) { return false; }
+uint32_t Video::GetVideoMode(void) { return g_videoMode; }
+void Video::SetVideoMode(uint32_t videoMode) { g_videoMode = videoMode; }
+VideoType_e Video::GetVideoType(void) { return g_videoType; }
+bool Video::IsVideoStyle(VideoStyle_e mask) { return (g_videoStyle & mask) != 0; }
+VideoRefreshRate_e Video::GetVideoRefreshRate(void) { return VR_60HZ; }
+
+void Video::VideoReinitialize(bool bInitVideoScannerAddress)
+{
+	NTSC_VideoReinitialize(0, bInitVideoScannerAddress);
+	NTSC_VideoInitAppleType();
+	NTSC_SetVideoStyle();
+	NTSC_SetVideoTextMode(g_videoMode & VF_80COL ? 80 : 40);
+	NTSC_SetVideoMode(g_videoMode);
+}
+
+//-------------------------------------
+
+static uint32_t Rand32(void)
+{
+	return ((uint32_t)rand() << 16) ^ ((uint32_t)rand() << 8) ^ (uint32_t)rand();
+}
+
+static void FillRandom(bgra_t* pTable, const UINT size)
+{
+	for (UINT i = 0; i < size; i++)
+		*(uint32_t*)&pTable[i] = Rand32();
+}
+
+//-------------------------------------
+
+// The batched update14Pixels*() functions must be bit-identical to 14 calls of the per-pixel updatePixel*() functions
+// . framebuffer: the current line, the inbetween lines above & below and the previous line
+// . renderer state: g_nSignalBitsNTSC, g_nColorPhaseNTSC & g_pVideoAddress
+
+int Update14Pixels_test(void)
+{
+	const UpdatePixelFunc_t updatePixel[] =
+	{
+		updatePixelBnWColorTVSingleScanline, updatePixelBnWColorTVDoubleScanline,
+		updatePixelBnWMonitorSingleScanline, updatePixelBnWMonitorDoubleScanline,
+		updatePixelHueColorTVSingleScanline, updatePixelHueColorTVDoubleScanline,
+		updatePixelHueMonitorSingleScanline, updatePixelHueMonitorDoubleScanline,
+	};
+
+	const Update14PixelsFunc_t update14Pixels[] =
+	{
+		update14PixelsBnWColorTVSingleScanline, update14PixelsBnWColorTVDoubleScanline,
+		update14PixelsBnWMonitorSingleScanline, update14PixelsBnWMonitorDoubleScanline,
+		update14PixelsHueColorTVSingleScanline, update14PixelsHueColorTVDoubleScanline,
+		update14PixelsHueMonitorSingleScanline, update14PixelsHueMonitorDoubleScanline,
+	};
+
+	srand(1);
+	FillRandom(&g_aHueMonitor[0][0], NTSC_NUM_PHASES * NTSC_NUM_SEQUENCES);
+	FillRandom(&g_aHueColorTV[0][0], NTSC_NUM_PHASES * NTSC_NUM_SEQUENCES);
+	FillRandom(g_aBnWMonitorCustom, NTSC_NUM_SEQUENCES);
+	FillRandom(g_aBnWColorTVCustom, NTSC_NUM_SEQUENCES);
+
+	// 5 lines: the current line is line 2, and it's updated along with lines 1, 3 & 4 (see getScanline*())
+	const UINT kWidth = 600;
+	const UINT kLines = 5;
+	g_kFrameBufferWidth = kWidth;
+	static uint32_t fb0[kWidth * kLines];
+	static uint32_t fb1[kWidth * kLines];
+
+	for (UINT j = 0; j < kWidth * kLines; j++)
+		fb0[j] = fb1[j] = Rand32();
+
+	for (UINT func = 0; func < sizeof(updatePixel) / sizeof(updatePixel[0]); func++)
+	{
+		for (UINT i = 0; i < 10000; i++)
+		{
+			const UINT x = rand() % (kWidth - 14);
+			for (UINT line = 0; line < kLines; line++)
+			{
+				for (UINT j = line * kWidth + x; j < line * kWidth + x + 14; j++)
+					fb0[j] = fb1[j] = Rand32();
+			}
+
+			const int signalBits = rand() & 0xFFF;
+			const int colorPhase = rand() & 3;
+			const uint16_t bits = (uint16_t)rand();
+			g_nVideoClockVert = (i & 1) ? (VIDEO_SCANNER_Y_DISPLAY - 1) : rand() % (VIDEO_SCANNER_Y_DISPLAY - 1);	// GH#650: last line also draws the final inbetween line
+
+			g_pVideoAddress = (bgra_t*) &fb0[2 * kWidth + x];
+			g_nSignalBitsNTSC = signalBits;
+			g_nColorPhaseNTSC = colorPhase;
+			uint16_t b = bits;
+			for (UINT p = 0; p < 14; p++)
+			{
+				updatePixel[func](b & 1);
+				b >>= 1;
+			}
+			const bgra_t* pVideoAddress0 = g_pVideoAddress;
+			const int signalBits0 = g_nSignalBitsNTSC;
+			const int colorPhase0 = g_nColorPhaseNTSC;
+
+			g_pVideoAddress = (bgra_t*) &fb1[2 * kWidth + x];
+			g_nSignalBitsNTSC = signalBits;
+			g_nColorPhaseNTSC = colorPhase;
+			update14Pixels[func](bits);
+
+			if (memcmp(fb0, fb1, sizeof(fb0)) != 0) return 1;
+			if (signalBits0 != g_nSignalBitsNTSC) return 1;
+			if (colorPhase0 != g_nColorPhaseNTSC) return 1;
+			if ((const uint32_t*)pVideoAddress0 - fb0 != (const uint32_t*)g_pVideoAddress - fb1) return 1;
+		}
+	}
+
+	return 0;
+}
+
+//-------------------------------------
+
+// Render frames of random video memory writes, mid-frame video mode switches, video style changes & whole-screen redraws
+// . returns a hash of the framebuffer for each frame
+
+static void ScanlineCache_RunFrames(const bool scanlineCache, const UINT numFrames, uint64_t* pFrameHashes)
+{
+	const uint32_t videoModes[] =
+	{
+		VF_TEXT, VF_TEXT | VF_80COL, 0, VF_MIXED, VF_DHIRES | VF_80COL, VF_DHIRES, VF_DHIRES | VF_80COL | VF_MIXED,
+		VF_HIRES, VF_HIRES | VF_MIXED, VF_HIRES | VF_PAGE2, VF_HIRES | VF_DHIRES, VF_HIRES | VF_DHIRES | VF_80COL,
+		VF_HIRES | VF_DHIRES | VF_80COL | VF_MIXED,
+	};
+	const UINT numVideoModes = sizeof(videoModes) / sizeof(videoModes[0]);
+
+	// Only the composite video types use the scanline cache, but include an RGB type too
+	const VideoType_e videoTypes[] = { VT_COLOR_TV, VT_MONO_TV, VT_COLOR_MONITOR_NTSC, VT_MONO_WHITE, VT_COLOR_IDEALIZED };
+	const UINT numVideoTypes = sizeof(videoTypes) / sizeof(videoTypes[0]);
+
+	srand(1);
+	for (UINT i = 0; i < 0x10000; i++)
+	{
+		g_memMain[i] = (BYTE)rand();
+		g_memAux[i] = (BYTE)rand();
+	}
+	for (UINT i = 0; i < sizeof(csbits_enhanced2e); i++)
+		((BYTE*)csbits_enhanced2e)[i] = (BYTE)rand();
+
+	// Both runs must start from the same renderer state
+	g_nTextFlashCounter = 0;
+	g_nTextFlashMask = 0;
+	g_nLastColumnPixelNTSC = 0;
+	g_nColorBurstPixels = 0;
+	g_nColorPhaseNTSC = INITIAL_COLOR_PHASE;
+	g_nSignalBitsNTSC = 0;
+
+	g_videoMode = VF_TEXT;
+	g_videoType = VT_COLOR_TV;
+	g_videoStyle = VS_HALF_SCANLINES;
+	NTSC_SetVideoMode(g_videoMode);	// set up the TEXT screen funcs first, as they determine g_pVideoAddress
+	GetVideo().VideoReinitialize(true);
+	GetVideo().ClearFrameBuffer();
+	NTSC_SetScanlineCache(scanlineCache);
+
+	const UINT cyclesPerFrame = NTSC_GetCyclesPerFrame();
+
+	for (UINT frame = 0; frame < numFrames; frame++)
+	{
+		if ((frame % 20) == 0)
+		{
+			g_videoType = videoTypes[(frame / 20) % numVideoTypes];
+			g_videoStyle = ((frame / 40) & 1) ? VS_NONE : VS_HALF_SCANLINES;
+			g_videoMode = videoModes[rand() % numVideoModes];
+			NTSC_SetVideoStyle();
+			NTSC_SetVideoTextMode(g_videoMode & VF_80COL ? 80 : 40);
+			NTSC_SetVideoMode(g_videoMode);
+		}
+
+		UINT cycles = 0;
+		while (cycles < cyclesPerFrame)
+		{
+			const UINT n = std::min<UINT>(1 + rand() % 14, cyclesPerFrame - cycles);
+			NTSC_VideoUpdateCycles(n);
+			cycles += n;
+
+			const UINT r = rand() % 1000;
+			if (r < 20)	// sparse writes to video memory, which may race the beam
+			{
+				const WORD addr = (rand() & 1) ? 0x400 + rand() % 0x400 : 0x2000 + rand() % 0x4000;
+				((rand() & 1) ? g_memMain : g_memAux)[addr] = (BYTE)rand();
+			}
+			else if (r == 20 && (frame % 20) >= 10 && (rand() % 8) == 0)	// occasional mid-frame video mode switch
+			{
+				g_videoMode = videoModes[rand() % numVideoModes];
+				NTSC_SetVideoTextMode(g_videoMode & VF_80COL ? 80 : 40);
+				NTSC_SetVideoMode(g_videoMode);
+			}
+			else if (r == 21 && (frame % 7) == 0 && (rand() % 8) == 0)
+			{
+				NTSC_VideoRedrawWholeScreen();
+			}
+		}
+
+		uint64_t hash = 14695981039346656037ULL;	// FNV-1a
+		for (UINT i = 0; i < kFrameBufferWidth * kFrameBufferHeight; i++)
+			hash = (hash ^ g_frameBuffer[i]) * 1099511628211ULL;
+		pFrameHashes[frame] = hash;
+	}
+
+	NTSC_SetScanlineCache(false);
+}
+
+// With the scanline cache enabled, every frame must be identical to the frame rendered without it
+
+int ScanlineCache_test(void)
+{
+	const UINT kNumFrames = 200;
+	static uint64_t frameHashes[kNumFrames];
+	static uint64_t frameHashesCached[kNumFrames];
+
+	// NB. Only init once, as the chroma tables depend on the state of the (static) NTSC filters
+	GetVideo().Initialize((uint8_t*)g_frameBuffer, true);
+	NTSC_VideoInit((uint8_t*)g_frameBuffer);
+
+	ScanlineCache_RunFrames(false, kNumFrames, frameHashes);
+	ScanlineCache_RunFrames(true, kNumFrames, frameHashesCached);
+
+	for (UINT frame = 0; frame < kNumFrames; frame++)
+	{
+		if (frameHashes[frame] != frameHashesCached[frame])
+			return 1;
+	}
+
+	return 0;
+}
+
+//-------------------------------------
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	int res = 1;
+
+	res = Update14Pixels_test();
+	if (res) return res;
+
+	res = ScanlineCache_test();
+	if (res) return res;
+
+	return 0;
+}
@@ -9,6 +9,18 @@
 .\%1\TestDebugger.exe
 @if errorlevel 1 GOTO failed
 
+@ECHO Performing unit-test: TestNTSC
+.\%1\TestNTSC.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestDisk2
+.\%1\TestDisk2.exe
+@IF errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestAY8913
+.\%1\TestAY8913.exe
+@IF errorlevel 1 GOTO failed
+
 @GOTO end
 
 :failed